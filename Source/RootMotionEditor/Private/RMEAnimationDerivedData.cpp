@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEAnimationDerivedData.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/IAnimationDataModel.h"
+#include "Engine/SkeletalMesh.h"
+
+
+TMap<TObjectKey<UAnimSequence>, TWeakPtr<FRMEAnimationDerivedData>> FRMEAnimationDerivedData::Registry;
+
+FRMEAnimationDerivedData::FRMEAnimationDerivedData(const UAnimSequence* InAnimation)
+	: AnimationPtr(InAnimation)
+	, Sampler(FRMEFrameSampler::ForAnimation(InAnimation))
+{
+	BindDataModel();
+}
+
+FRMEAnimationDerivedData::~FRMEAnimationDerivedData()
+{
+	UnbindDataModel();
+}
+
+TSharedRef<FRMEAnimationDerivedData> FRMEAnimationDerivedData::FindOrCreate(const UAnimSequence* InAnimation)
+{
+	check(IsInGameThread());
+
+	TWeakPtr<FRMEAnimationDerivedData>& Entry = Registry.FindOrAdd(InAnimation);
+	if (TSharedPtr<FRMEAnimationDerivedData> Existing = Entry.Pin())
+	{
+		// A new data model doesn't send the events of the old one.
+		if (!Existing->IsBoundTo(InAnimation))
+		{
+			Existing->BindDataModel();
+			Existing->Reset();
+		}
+		// Resampled or trimmed without going through Invalidate, the cached frames are someone else's.
+		else if (Existing->Sampler != FRMEFrameSampler::ForAnimation(InAnimation))
+		{
+			Existing->Reset();
+		}
+		return Existing.ToSharedRef();
+	}
+
+	// Forget the entries of the animations no session uses anymore.
+	for (auto It = Registry.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.IsValid() && It->Key != TObjectKey<UAnimSequence>(InAnimation))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TSharedRef<FRMEAnimationDerivedData> NewData = MakeShared<FRMEAnimationDerivedData>(InAnimation);
+	Registry.FindChecked(InAnimation) = NewData;
+	return NewData;
+}
+
+void FRMEAnimationDerivedData::Invalidate(const UAnimSequence* InAnimation)
+{
+	check(IsInGameThread());
+
+	if (const TWeakPtr<FRMEAnimationDerivedData>* Entry = Registry.Find(InAnimation))
+	{
+		if (TSharedPtr<FRMEAnimationDerivedData> Data = Entry->Pin())
+		{
+			Data->Reset();
+		}
+	}
+}
+
+const FRMETrajectorySamples& FRMEAnimationDerivedData::GetAssetSamples()
+{
+	if (!bHasAssetSamples)
+	{
+		FRMETrajectoryCache::BuildAssetSamples(AnimationPtr.Get(), AssetSamples);
+		bHasAssetSamples = true;
+	}
+	return AssetSamples;
+}
+
+FRMEScrubPoseCache& FRMEAnimationDerivedData::GetScrubPoseCache(const USkeletalMesh* InMesh)
+{
+	check(IsInGameThread());
+
+	// Forget the poses of the meshes that were deleted.
+	for (auto It = ScrubPoseCaches.CreateIterator(); It; ++It)
+	{
+		if (It->Key.ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TUniquePtr<FRMEScrubPoseCache>& Cache = ScrubPoseCaches.FindOrAdd(InMesh);
+	if (!Cache.IsValid())
+	{
+		Cache = MakeUnique<FRMEScrubPoseCache>();
+	}
+	return *Cache;
+}
+
+SIZE_T FRMEAnimationDerivedData::GetAllocatedSize() const
+{
+	SIZE_T Size = AssetSamples.GetAllocatedSize() + ScrubPoseCaches.GetAllocatedSize();
+	for (const TPair<TObjectKey<USkeletalMesh>, TUniquePtr<FRMEScrubPoseCache>>& Entry : ScrubPoseCaches)
+	{
+		Size += sizeof(FRMEScrubPoseCache) + Entry.Value->GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FRMEAnimationDerivedData::GetAll(TArray<TSharedRef<FRMEAnimationDerivedData>>& OutEntries)
+{
+	check(IsInGameThread());
+
+	OutEntries.Reset();
+	for (const TPair<TObjectKey<UAnimSequence>, TWeakPtr<FRMEAnimationDerivedData>>& Entry : Registry)
+	{
+		if (TSharedPtr<FRMEAnimationDerivedData> Data = Entry.Value.Pin())
+		{
+			OutEntries.Add(Data.ToSharedRef());
+		}
+	}
+}
+
+void FRMEAnimationDerivedData::BindDataModel()
+{
+	UnbindDataModel();
+
+	const UAnimSequence* Animation = AnimationPtr.Get();
+	if (IAnimationDataModel* Model = Animation != nullptr ? Animation->GetDataModel() : nullptr)
+	{
+		DataModelPtr = Model->_getUObject();
+		DataModelModifiedHandle = Model->GetModifiedEvent().AddRaw(this, &FRMEAnimationDerivedData::OnDataModelModified);
+	}
+}
+
+void FRMEAnimationDerivedData::UnbindDataModel()
+{
+	if (IAnimationDataModel* Model = Cast<IAnimationDataModel>(DataModelPtr.Get()))
+	{
+		Model->GetModifiedEvent().Remove(DataModelModifiedHandle);
+	}
+	DataModelPtr.Reset();
+	DataModelModifiedHandle.Reset();
+	BracketDepth = 0;
+}
+
+bool FRMEAnimationDerivedData::IsBoundTo(const UAnimSequence* InAnimation) const
+{
+	const IAnimationDataModel* Model = InAnimation != nullptr ? InAnimation->GetDataModel() : nullptr;
+	return Model != nullptr && DataModelPtr.Get() == Model->_getUObject();
+}
+
+void FRMEAnimationDerivedData::OnDataModelModified(const EAnimDataModelNotifyType& NotifyType, IAnimationDataModel* Model, const FAnimDataModelNotifPayload& Payload)
+{
+	// The other notifies come once the model has changed, too late to stop the background evaluations reading it.
+	// They're all sent inside a bracket: the workers are stopped when the outermost one opens, before the first
+	// change, and the entry is rebuilt when it closes.
+	if (NotifyType == EAnimDataModelNotifyType::BracketOpened)
+	{
+		if (BracketDepth++ == 0)
+		{
+			CancelBackgroundWork();
+		}
+	}
+	else if (NotifyType == EAnimDataModelNotifyType::BracketClosed)
+	{
+		if (BracketDepth > 0 && --BracketDepth == 0)
+		{
+			Reset();
+		}
+	}
+}
+
+void FRMEAnimationDerivedData::CancelBackgroundWork()
+{
+	// Waits for the background pose evaluations.
+	ScrubPoseCaches.Reset();
+}
+
+void FRMEAnimationDerivedData::Reset()
+{
+	CancelBackgroundWork();
+
+	bHasAssetSamples = false;
+	AssetSamples.Reset();
+	Sampler = FRMEFrameSampler::ForAnimation(AnimationPtr.Get());
+	++Generation;
+}
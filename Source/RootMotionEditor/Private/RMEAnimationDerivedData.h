@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMEPoseCache.h"
+#include "RMETrajectoryCache.h"
+#include "UObject/ObjectKey.h"
+
+class UAnimSequence;
+class USkeletalMesh;
+class IAnimationDataModel;
+struct FAnimDataModelNotifPayload;
+enum class EAnimDataModelNotifyType : uint8;
+
+/**
+ * Read only data derived from one animation asset, shared by every editor session that opens it.
+ * Entries live as long as a session holds them, and are looked up by animation on the game thread. Any change of the
+ * animation data model resets the entry, so edits made outside of the editor and reimports are seen too: the
+ * background work stops when the change bracket opens and the entry is rebuilt when it closes.
+ */
+class FRMEAnimationDerivedData
+{
+public:
+	explicit FRMEAnimationDerivedData(const UAnimSequence* InAnimation);
+	~FRMEAnimationDerivedData();
+
+	static TSharedRef<FRMEAnimationDerivedData> FindOrCreate(const UAnimSequence* InAnimation);
+
+	/** Drop what was derived from the animation, for every session. Must be called before the animation data is modified. */
+	static void Invalidate(const UAnimSequence* InAnimation);
+
+	const UAnimSequence* GetAnimation() const { return AnimationPtr.Get(); }
+
+	/** Bumped by Invalidate, so the sessions know their own derived data is stale too. */
+	uint32 GetGeneration() const { return Generation; }
+
+	/** Frames the derived data is sampled on, the entry is rebuilt if the animation no longer has these frames. */
+	const FRMEFrameSampler& GetSampler() const { return Sampler; }
+
+	/** Root motion of the asset accumulated over its frames, built on first use. */
+	const FRMETrajectorySamples& GetAssetSamples();
+	bool HasAssetSamples() const { return bHasAssetSamples; }
+
+	/**
+	 * Poses of every frame, built in the background by the first session that scrubs the animation on the mesh.
+	 * The poses follow the bones of the mesh, so sessions previewing other meshes get their own cache.
+	 */
+	FRMEScrubPoseCache& GetScrubPoseCache(const USkeletalMesh* InMesh);
+
+	/** True between the data model opening a change bracket and closing it, nothing should read the animation then. */
+	bool IsModelChanging() const { return BracketDepth > 0; }
+
+	/** Asset samples and scrub poses. */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Every entry a session still holds, for the memory report. */
+	static void GetAll(TArray<TSharedRef<FRMEAnimationDerivedData>>& OutEntries);
+
+private:
+	void Reset();
+	/** Cancel the background pose evaluations and wait for them. */
+	void CancelBackgroundWork();
+
+	/** Listen to the data model of the animation, it can be swapped for another one. */
+	void BindDataModel();
+	void UnbindDataModel();
+	bool IsBoundTo(const UAnimSequence* InAnimation) const;
+	void OnDataModelModified(const EAnimDataModelNotifyType& NotifyType, IAnimationDataModel* Model, const FAnimDataModelNotifPayload& Payload);
+
+private:
+	TWeakObjectPtr<const UAnimSequence> AnimationPtr;
+	uint32 Generation = 0;
+	FRMEFrameSampler Sampler;
+
+	TWeakObjectPtr<UObject> DataModelPtr;
+	FDelegateHandle DataModelModifiedHandle;
+	/** Brackets of the data model opened and not closed yet. */
+	int32 BracketDepth = 0;
+
+	bool bHasAssetSamples = false;
+	FRMETrajectorySamples AssetSamples;
+
+	TMap<TObjectKey<USkeletalMesh>, TUniquePtr<FRMEScrubPoseCache>> ScrubPoseCaches;
+
+	static TMap<TObjectKey<UAnimSequence>, TWeakPtr<FRMEAnimationDerivedData>> Registry;
+};
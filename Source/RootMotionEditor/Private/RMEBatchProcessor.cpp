@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEBatchProcessor.h"
+#include "RMEContext.h"
+#include "RMECurveOperations.h"
+#include "RMEStatics.h"
+#include "RMETypes.h"
+#include "Animation/AnimSequence.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopedSlowTask.h"
+
+#define LOCTEXT_NAMESPACE "RMEBatchProcessor"
+
+
+TArray<FRMEBatchAssetReport> FRMEBatchProcessor::Run(const URMEBatchSettings& Settings)
+{
+	check(IsInGameThread());
+
+	// Resolved once for the bake and the write back passes.
+	TArray<UAnimSequence*> Animations;
+	for (UAnimSequence* Animation : Settings.Animations)
+	{
+		Animations.Add(Animation);
+	}
+
+	const int32 NumAssets = Animations.Num();
+	TArray<FRMEBatchAssetReport> Reports;
+	Reports.SetNum(NumAssets);
+	TArray<FTransformCurve> Curves;
+	Curves.SetNum(NumAssets);
+
+	TSet<const UAnimSequence*> Visited;
+	for (int32 Index = 0; Index < NumAssets; ++Index)
+	{
+		UAnimSequence* Animation = Animations[Index];
+		FRMEBatchAssetReport& Report = Reports[Index];
+		Report.Animation = Animation;
+		Report.AssetName = GetNameSafe(Animation);
+
+		bool bIsVisited = false;
+		Visited.Add(Animation, &bIsVisited);
+		Report.Message = bIsVisited && Animation != nullptr ? LOCTEXT("DuplicatedAsset", "Listed more than once, only the first entry is processed.") : Validate(Animation, Settings);
+		Report.Result = Report.Message.IsEmpty() ? ERMEBatchResult::Succeeded : ERMEBatchResult::Skipped;
+	}
+
+	FScopedSlowTask SlowTask(static_cast<float>(NumAssets * 2), LOCTEXT("BatchProgress", "Applying root motion batch..."));
+	SlowTask.MakeDialog();
+
+	// The bakes read the animation data models, which are only safe to read on the game thread.
+	for (int32 Index = 0; Index < NumAssets; ++Index)
+	{
+		FRMEBatchAssetReport& Report = Reports[Index];
+		SlowTask.EnterProgressFrame(1.f, FText::Format(LOCTEXT("BatchBakeProgress", "Baking {0}"), FText::FromString(Report.AssetName)));
+		if (Report.Result != ERMEBatchResult::Succeeded)
+		{
+			continue;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		UAnimSequence* Animation = Animations[Index];
+		FTransformCurve& Curve = Curves[Index];
+		Curve = Settings.AdaptiveSampling.bEnabled
+			? RootMotionEditorStatics::BakeRootBoneToCurveAdaptive(Animation, Settings.AdaptiveSampling, Settings.ExtractChannels, false)
+			: RootMotionEditorStatics::BakeRootBoneToCurve(Animation, Settings.SampleRate, Settings.ExtractChannels, false);
+		Report.NumKeys = Curve.TranslationCurve.FloatCurves[0].GetNumKeys();
+		Report.DistanceBefore = GetHorizontalDistance(Curve);
+		Report.ProcessSeconds = FPlatformTime::Seconds() - StartTime;
+	}
+
+	// The operations only touch the baked curves, they run in parallel.
+	ParallelFor(NumAssets, [&Settings, &Reports, &Curves](int32 Index)
+	{
+		FRMEBatchAssetReport& Report = Reports[Index];
+		if (Report.Result != ERMEBatchResult::Succeeded)
+		{
+			return;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		FTransformCurve& Curve = Curves[Index];
+		ApplyOperations(Curve, Settings.Operations);
+		Report.DistanceAfter = GetHorizontalDistance(Curve);
+		Report.ProcessSeconds += FPlatformTime::Seconds() - StartTime;
+	});
+
+	int32 NumSucceeded = 0;
+	for (int32 Index = 0; Index < NumAssets; ++Index)
+	{
+		FRMEBatchAssetReport& Report = Reports[Index];
+		SlowTask.EnterProgressFrame(1.f, FText::Format(LOCTEXT("BatchWriteProgress", "Writing {0}"), FText::FromString(Report.AssetName)));
+		if (Report.Result != ERMEBatchResult::Succeeded)
+		{
+			continue;
+		}
+
+		if (Report.NumKeys == 0)
+		{
+			Report.Result = ERMEBatchResult::Failed;
+			Report.Message = LOCTEXT("NothingBaked", "Nothing was baked from the root motion.");
+			continue;
+		}
+
+		if (!Settings.bWriteBack)
+		{
+			Report.Message = LOCTEXT("DryRun", "Not written, write back is disabled.");
+			++NumSucceeded;
+			continue;
+		}
+
+		UAnimSequence* Animation = Animations[Index];
+		FRMEContext::NotifyAnimationModified(Animation);
+		if (RootMotionEditorStatics::OverrideAnimBoneMotion(Animation, Curves[Index], Settings.CustomSaveBoneName))
+		{
+			Animation->MarkPackageDirty();
+			++NumSucceeded;
+		}
+		else
+		{
+			Report.Result = ERMEBatchResult::Failed;
+			Report.Message = LOCTEXT("WriteFailed", "Writing the bone track failed, see the output log.");
+		}
+	}
+
+	UE_LOG(LogRootMotionEditor, Log, TEXT("Root motion batch: %d of %d animations processed."), NumSucceeded, NumAssets);
+	return Reports;
+}
+
+void FRMEBatchProcessor::ApplyOperations(FTransformCurve& InOutCurve, TConstArrayView<FRMEBatchOperation> Operations)
+{
+	const FRMECurveOperationRange Range;
+	for (const FRMEBatchOperation& Operation : Operations)
+	{
+		switch (Operation.Type)
+		{
+		case ERMEBatchOperationType::ScaleDistance:
+			RMECurveOperations::ScaleDistance(InOutCurve, Range, Operation.Scale);
+			break;
+
+		case ERMEBatchOperationType::TimeStretch:
+			RMECurveOperations::TimeStretch(InOutCurve, RMECurveOperations::GetKeyRange(InOutCurve), Operation.Scale);
+			break;
+
+		case ERMEBatchOperationType::Offset:
+			RMECurveOperations::Offset(InOutCurve, Range, Operation.Offset);
+			break;
+
+		case ERMEBatchOperationType::Mirror:
+			RMECurveOperations::Mirror(InOutCurve, Range, Operation.Axis);
+			break;
+
+		case ERMEBatchOperationType::RotateYaw:
+			RMECurveOperations::RotateAboutZ(InOutCurve, Range, Operation.Yaw);
+			break;
+
+		case ERMEBatchOperationType::RemoveDrift:
+			RMECurveOperations::RemoveDrift(InOutCurve, Range, Operation.Axis);
+			break;
+
+		case ERMEBatchOperationType::ZeroStartYaw:
+			RMECurveOperations::ZeroStartYaw(InOutCurve, Range);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+FText FRMEBatchProcessor::Validate(const UAnimSequence* InAnimation, const URMEBatchSettings& Settings)
+{
+	if (InAnimation == nullptr)
+	{
+		return LOCTEXT("MissingAsset", "No animation.");
+	}
+
+	if (!InAnimation->HasRootMotion())
+	{
+		return LOCTEXT("NoRootMotion", "Root motion isn't enabled on the animation.");
+	}
+
+	if (!Settings.CustomSaveBoneName.IsNone() && !RootMotionEditorStatics::IsValidBoneName(InAnimation, Settings.CustomSaveBoneName))
+	{
+		return FText::Format(LOCTEXT("InvalidSaveBone", "Save bone ({0}) isn't in the skeleton."), FText::FromName(Settings.CustomSaveBoneName));
+	}
+
+	return FText::GetEmpty();
+}
+
+float FRMEBatchProcessor::GetHorizontalDistance(const FTransformCurve& InCurve)
+{
+	const FRMECurveOperationRange KeyRange = RMECurveOperations::GetKeyRange(InCurve);
+	if (KeyRange.StartTime > KeyRange.EndTime)
+	{
+		return 0.f;
+	}
+
+	const FVector Start = InCurve.Evaluate(KeyRange.StartTime, 1.f).GetTranslation();
+	const FVector End = InCurve.Evaluate(KeyRange.EndTime, 1.f).GetTranslation();
+	return FVector::Dist2D(Start, End);
+}
+
+#undef LOCTEXT_NAMESPACE
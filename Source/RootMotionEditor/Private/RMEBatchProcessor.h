@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimCurveTypes.h"
+
+class UAnimSequence;
+class URMEBatchSettings;
+struct FRMEBatchOperation;
+
+enum class ERMEBatchResult : uint8
+{
+	Succeeded,
+	Skipped,
+	Failed,
+};
+
+/** What the batch did to one animation. */
+struct FRMEBatchAssetReport
+{
+	TWeakObjectPtr<UAnimSequence> Animation;
+	FString AssetName;
+	ERMEBatchResult Result = ERMEBatchResult::Skipped;
+	FText Message;
+
+	int32 NumKeys = 0;
+	/** Horizontal distance covered by the root motion, before and after the operations. */
+	float DistanceBefore = 0.f;
+	float DistanceAfter = 0.f;
+	double ProcessSeconds = 0.0;
+};
+
+/**
+ * Applies the same bake, operation list and write back to many animations.
+ * The bakes read the animation data models on the game thread, then the operations on the baked curves run in
+ * parallel. Writing back changes the data models, it's done one asset at a time on the game thread once every curve
+ * is ready. With no operation, the write back leaves the root tracks as they were.
+ */
+class FRMEBatchProcessor
+{
+public:
+	static TArray<FRMEBatchAssetReport> Run(const URMEBatchSettings& Settings);
+
+	/** Apply the operations in order, on the whole curve. */
+	static void ApplyOperations(FTransformCurve& InOutCurve, TConstArrayView<FRMEBatchOperation> Operations);
+
+private:
+	/** Why the animation can't be processed, empty if it can. Game thread. */
+	static FText Validate(const UAnimSequence* InAnimation, const URMEBatchSettings& Settings);
+
+	static float GetHorizontalDistance(const FTransformCurve& InCurve);
+};
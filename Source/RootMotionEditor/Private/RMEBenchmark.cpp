@@ -0,0 +1,343 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEBenchmark.h"
+#include "RMEStatics.h"
+#include "RMETrajectoryCache.h"
+#include "RMETypes.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ReferenceSkeleton.h"
+
+#define LOCTEXT_NAMESPACE "RMEBenchmark"
+
+
+namespace RMEBenchmark
+{
+	static void ParseIntList(const TCHAR* InParams, const TCHAR* InKey, TArray<int32>& OutValues)
+	{
+		FString List;
+		if (!FParse::Value(InParams, InKey, List, false))
+		{
+			return;
+		}
+
+		TArray<FString> Items;
+		List.ParseIntoArray(Items, TEXT(","));
+
+		TArray<int32> Values;
+		for (const FString& Item : Items)
+		{
+			const int32 Value = FCString::Atoi(*Item);
+			if (Value > 0)
+			{
+				Values.Add(Value);
+			}
+		}
+
+		if (Values.Num() > 0)
+		{
+			OutValues = MoveTemp(Values);
+		}
+	}
+
+	static FName GetBoneName(int32 BoneIndex)
+	{
+		return BoneIndex == 0 ? FName(TEXT("root")) : FName(TEXT("bone"), BoneIndex);
+	}
+
+	/** Run the stage the requested number of times, the stage returns a value so the work isn't optimized out. */
+	static TArray<double> TimeStage(int32 Iterations, TFunctionRef<float()> Stage)
+	{
+		static volatile float Sink = 0.f;
+
+		TArray<double> Milliseconds;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Sink = Sink + Stage();
+			Milliseconds.Add((FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		return Milliseconds;
+	}
+
+	static FAutoConsoleCommand BenchmarkCommand(
+		TEXT("RootMotionEditor.Benchmark"),
+		TEXT("Time bake, evaluation, write back and trajectory sampling on synthetic animations and append the results to a CSV file.\n")
+		TEXT("Frames=300,1200 Bones=64 FrameRate=30,60 Iterations=5 Stages=BakeRootBoneToCurve,EvaluateTransformCurve Out=Path.csv"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			FRMEBenchmark::Run(FRMEBenchmarkSettings::Parse(*FString::Join(Args, TEXT(" "))));
+		})
+	);
+}
+
+FRMEBenchmarkSettings FRMEBenchmarkSettings::Parse(const TCHAR* InParams)
+{
+	FRMEBenchmarkSettings Settings;
+	RMEBenchmark::ParseIntList(InParams, TEXT("Frames="), Settings.NumFrames);
+	RMEBenchmark::ParseIntList(InParams, TEXT("Bones="), Settings.NumBones);
+	RMEBenchmark::ParseIntList(InParams, TEXT("FrameRate="), Settings.FrameRates);
+	FParse::Value(InParams, TEXT("Iterations="), Settings.Iterations);
+	Settings.Iterations = FMath::Max(Settings.Iterations, 1);
+
+	FString StageList;
+	if (FParse::Value(InParams, TEXT("Stages="), StageList, false))
+	{
+		StageList.ParseIntoArray(Settings.Stages, TEXT(","));
+	}
+
+	if (!FParse::Value(InParams, TEXT("Out="), Settings.OutputFile))
+	{
+		Settings.OutputFile = FPaths::Combine(FPaths::ProfilingDir(), TEXT("RootMotionEditor"), TEXT("Benchmark.csv"));
+	}
+	return Settings;
+}
+
+bool FRMEBenchmarkSettings::ShouldTime(const TCHAR* InStage) const
+{
+	return Stages.Num() == 0 || Stages.Contains(FString(InStage));
+}
+
+const TArray<FString>& FRMEBenchmark::GetStageNames()
+{
+	static const TArray<FString> StageNames =
+	{
+		TEXT("BakeRootBoneToCurve"),
+		TEXT("BakeRootBoneToCurveEvaluated"),
+		TEXT("BakeAnimPoseBoneToCurve"),
+		TEXT("BakeAnimPoseBoneToCurveEvaluated"),
+		TEXT("BakeRootBoneToCurveAdaptive"),
+		TEXT("BakeAnimPoseBoneToCurveAdaptive"),
+		TEXT("EvaluateTransformCurve"),
+		TEXT("SampleAssetTrajectory"),
+		TEXT("SampleEditorTrajectory"),
+		TEXT("OverrideAnimBoneMotion"),
+	};
+	return StageNames;
+}
+
+bool FRMEBenchmark::Run(const FRMEBenchmarkSettings& Settings)
+{
+	FString Csv;
+	if (!FPaths::FileExists(Settings.OutputFile))
+	{
+		Csv = TEXT("Date,Stage,Frames,Bones,FrameRate,Iterations,MinMs,MedianMs,MeanMs,MaxMs\n");
+	}
+
+	for (const int32 NumFrames : Settings.NumFrames)
+	{
+		for (const int32 NumBones : Settings.NumBones)
+		{
+			for (const int32 FrameRate : Settings.FrameRates)
+			{
+				UAnimSequence* Sequence = CreateSyntheticSequence(NumFrames, NumBones, FrameRate);
+				Sequence->AddToRoot();
+
+				const FName LastBoneName = RMEBenchmark::GetBoneName(NumBones - 1);
+				const FTransformCurve Curve = RootMotionEditorStatics::BakeRootBoneToCurve(Sequence, FrameRate, int32(ERMEBoneExtractChannelType::All));
+				const float PlayLength = Sequence->GetPlayLength();
+
+				// At the rate of the animation the bakes read the raw bone tracks, at twice the rate they extract the root
+				// motion and evaluate the poses.
+				const int32 EvaluatedSampleRate = FrameRate * 2;
+
+				TArray<FStageTiming> Timings;
+				auto AddStage = [&Settings, &Timings](const TCHAR* Stage, TFunctionRef<float()> Work)
+				{
+					check(GetStageNames().Contains(FString(Stage)));
+					if (Settings.ShouldTime(Stage))
+					{
+						Timings.Add({ Stage, RMEBenchmark::TimeStage(Settings.Iterations, Work) });
+					}
+				};
+
+				AddStage(TEXT("BakeRootBoneToCurve"), [Sequence, FrameRate]()
+				{
+					return RootMotionEditorStatics::BakeRootBoneToCurve(Sequence, FrameRate, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				AddStage(TEXT("BakeRootBoneToCurveEvaluated"), [Sequence, EvaluatedSampleRate]()
+				{
+					return RootMotionEditorStatics::BakeRootBoneToCurve(Sequence, EvaluatedSampleRate, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				AddStage(TEXT("BakeAnimPoseBoneToCurve"), [Sequence, FrameRate, LastBoneName]()
+				{
+					return RootMotionEditorStatics::BakeAnimPoseBoneToCurve(Sequence, LastBoneName, FrameRate, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				AddStage(TEXT("BakeAnimPoseBoneToCurveEvaluated"), [Sequence, EvaluatedSampleRate, LastBoneName]()
+				{
+					return RootMotionEditorStatics::BakeAnimPoseBoneToCurve(Sequence, LastBoneName, EvaluatedSampleRate, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				// Adaptive bakes refine up to the frame rate of the animation.
+				FRMEAdaptiveSampling AdaptiveSampling;
+				AdaptiveSampling.bEnabled = true;
+				AdaptiveSampling.MaxSampleRate = FrameRate;
+				AddStage(TEXT("BakeRootBoneToCurveAdaptive"), [Sequence, &AdaptiveSampling]()
+				{
+					return RootMotionEditorStatics::BakeRootBoneToCurveAdaptive(Sequence, AdaptiveSampling, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				AddStage(TEXT("BakeAnimPoseBoneToCurveAdaptive"), [Sequence, &AdaptiveSampling, LastBoneName]()
+				{
+					return RootMotionEditorStatics::BakeAnimPoseBoneToCurveAdaptive(Sequence, LastBoneName, AdaptiveSampling, int32(ERMEBoneExtractChannelType::All)).TranslationCurve.FloatCurves[0].GetNumKeys() * 1.f;
+				});
+
+				// Ten evaluations per frame, the preview and the ghost poses evaluate between frames.
+				AddStage(TEXT("EvaluateTransformCurve"), [&Curve, NumFrames, PlayLength]()
+				{
+					const int32 NumEvaluations = NumFrames * 10;
+					float Sum = 0.f;
+					for (int32 Index = 0; Index <= NumEvaluations; ++Index)
+					{
+						Sum += Curve.Evaluate(PlayLength * Index / NumEvaluations, 1.f).GetTranslation().X;
+					}
+					return Sum;
+				});
+
+				AddStage(TEXT("SampleAssetTrajectory"), [Sequence]()
+				{
+					FRMETrajectorySamples Samples;
+					FRMETrajectoryCache::BuildAssetSamples(Sequence, Samples);
+					return Samples.MaxSpeed;
+				});
+
+				uint32 CurveRevision = 0;
+				FRMETrajectoryCache TrajectoryCache;
+				AddStage(TEXT("SampleEditorTrajectory"), [Sequence, &Curve, &CurveRevision, &TrajectoryCache]()
+				{
+					// A new revision every time, or the cache would return the samples of the first iteration.
+					return TrajectoryCache.GetEditorSamples(Sequence, &Curve, ++CurveRevision).MaxSpeed;
+				});
+
+				// Last, it changes the animation.
+				AddStage(TEXT("OverrideAnimBoneMotion"), [Sequence, &Curve]()
+				{
+					return RootMotionEditorStatics::OverrideAnimBoneMotion(Sequence, Curve) ? 1.f : 0.f;
+				});
+
+				AppendRows(Csv, Timings, NumFrames, NumBones, FrameRate);
+
+				Sequence->RemoveFromRoot();
+				Sequence->MarkAsGarbage();
+			}
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Settings.OutputFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Failed to write the benchmark results to %s."), *Settings.OutputFile);
+		return false;
+	}
+
+	UE_LOG(LogRootMotionEditor, Display, TEXT("Benchmark results appended to %s."), *FPaths::ConvertRelativePathToFull(Settings.OutputFile));
+	return true;
+}
+
+UAnimSequence* FRMEBenchmark::CreateSyntheticSequence(int32 NumFrames, int32 NumBones, int32 FrameRate)
+{
+	NumFrames = FMath::Max(NumFrames, 1);
+	NumBones = FMath::Max(NumBones, 1);
+
+	USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage(), NAME_None, RF_Transient);
+	{
+		// Four children per bone, so the hierarchy has the depth of a real skeleton rather than a long chain.
+		FReferenceSkeletonModifier Modifier(Skeleton);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+		{
+			const FName BoneName = RMEBenchmark::GetBoneName(BoneIndex);
+			const int32 ParentIndex = BoneIndex == 0 ? INDEX_NONE : (BoneIndex - 1) / 4;
+			Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), ParentIndex), FTransform(FVector(0.f, 0.f, BoneIndex == 0 ? 0.f : 10.f)));
+		}
+	}
+
+	UAnimSequence* Sequence = NewObject<UAnimSequence>(GetTransientPackage(), NAME_None, RF_Transient);
+	Sequence->SetSkeleton(Skeleton);
+	Sequence->bEnableRootMotion = true;
+
+	const int32 NumKeys = NumFrames + 1;
+	const double FrameInterval = 1.0 / FrameRate;
+
+	IAnimationDataController& Controller = Sequence->GetController();
+	const bool bShouldTransact = false;
+	Controller.OpenBracket(LOCTEXT("SyntheticSequenceBracket", "Create Synthetic Sequence"), bShouldTransact);
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 2
+	Controller.InitializeModel();
+#endif
+	Controller.SetFrameRate(FFrameRate(FrameRate, 1), bShouldTransact);
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 1
+	Controller.SetNumberOfFrames(FFrameNumber(NumFrames), bShouldTransact);
+#else
+	Controller.SetPlayLength(static_cast<float>(NumFrames * FrameInterval), bShouldTransact);
+#endif
+
+	TArray<FVector> Positions;
+	TArray<FQuat> Rotations;
+	TArray<FVector> Scales;
+	Positions.SetNum(NumKeys);
+	Rotations.SetNum(NumKeys);
+	Scales.Init(FVector::OneVector, NumKeys);
+
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; ++BoneIndex)
+	{
+		const FName BoneName = RMEBenchmark::GetBoneName(BoneIndex);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const double Time = Key * FrameInterval;
+			if (BoneIndex == 0)
+			{
+				// Walk forward at 150 cm/s with a lateral sway, turning 20 degrees per second.
+				Positions[Key] = FVector(150.0 * Time, 10.0 * FMath::Sin(Time * UE_TWO_PI), 0.0);
+				Rotations[Key] = FQuat(FVector::UpVector, FMath::DegreesToRadians(20.0 * Time));
+			}
+			else
+			{
+				Positions[Key] = FVector(0.0, 0.0, 10.0);
+				Rotations[Key] = FQuat(FVector::ForwardVector, 0.2 * FMath::Sin(Time * UE_TWO_PI + BoneIndex));
+			}
+		}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 2
+		Controller.AddBoneCurve(BoneName, bShouldTransact);
+#else
+		Controller.AddBoneTrack(BoneName, bShouldTransact);
+#endif
+		Controller.SetBoneTrackKeys(BoneName, Positions, Rotations, Scales, bShouldTransact);
+	}
+
+	Controller.NotifyPopulated();
+	Controller.CloseBracket(bShouldTransact);
+	return Sequence;
+}
+
+void FRMEBenchmark::AppendRows(FString& OutCsv, TConstArrayView<FStageTiming> Timings, int32 NumFrames, int32 NumBones, int32 FrameRate)
+{
+	const FString Date = FDateTime::UtcNow().ToIso8601();
+	for (const FStageTiming& Timing : Timings)
+	{
+		TArray<double> Sorted = Timing.Milliseconds;
+		Sorted.Sort();
+
+		double Sum = 0.0;
+		for (const double Value : Sorted)
+		{
+			Sum += Value;
+		}
+
+		const double Min = Sorted[0];
+		const double Median = Sorted[Sorted.Num() / 2];
+		const double Mean = Sum / Sorted.Num();
+		const double Max = Sorted.Last();
+
+		OutCsv += FString::Printf(TEXT("%s,%s,%d,%d,%d,%d,%.4f,%.4f,%.4f,%.4f\n"), *Date, *Timing.Stage, NumFrames, NumBones, FrameRate, Sorted.Num(), Min, Median, Mean, Max);
+		UE_LOG(LogRootMotionEditor, Display, TEXT("%-32s Frames=%d Bones=%d FrameRate=%d: median %.3f ms, min %.3f ms"), *Timing.Stage, NumFrames, NumBones, FrameRate, Median, Min);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
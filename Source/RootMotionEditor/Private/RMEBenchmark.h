@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+
+/** Shape of the synthetic animations the benchmark runs on, every combination of the lists is measured. */
+struct FRMEBenchmarkSettings
+{
+	TArray<int32> NumFrames = { 300 };
+	TArray<int32> NumBones = { 64 };
+	TArray<int32> FrameRates = { 30 };
+	/** Each stage is timed this many times, the report keeps min, median, mean and max. */
+	int32 Iterations = 5;
+	/** Names of the stages to time, all of them if empty. */
+	TArray<FString> Stages;
+	/** CSV file the rows are appended to. */
+	FString OutputFile;
+
+	/** Frames=300,1200 Bones=64 FrameRate=30,60 Iterations=5 Stages=A,B Out=Path.csv, missing values keep their default. */
+	static FRMEBenchmarkSettings Parse(const TCHAR* InParams);
+
+	bool ShouldTime(const TCHAR* InStage) const;
+};
+
+/**
+ * Times the bake, evaluation, write back and trajectory sampling stages on generated animations and appends the results
+ * to a CSV file, so a regression shows up as a jump in a column.
+ * Each stage is an automation test under RootMotionEditor.Benchmark. It can also be run with the
+ * RootMotionEditor.Benchmark console command, or headless with -run=RMEBenchmark -nullrhi.
+ */
+class FRMEBenchmark
+{
+public:
+	/** False if the output file can't be written. */
+	static bool Run(const FRMEBenchmarkSettings& Settings);
+
+	/** Every stage Run can time, in the order it times them. */
+	static const TArray<FString>& GetStageNames();
+
+	/** Transient animation with a root bone that walks and turns, and NumBones - 1 swaying child bones. */
+	static UAnimSequence* CreateSyntheticSequence(int32 NumFrames, int32 NumBones, int32 FrameRate);
+
+private:
+	struct FStageTiming
+	{
+		FString Stage;
+		TArray<double> Milliseconds;
+	};
+
+	static void AppendRows(FString& OutCsv, TConstArrayView<FStageTiming> Timings, int32 NumFrames, int32 NumBones, int32 FrameRate);
+};
@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEBenchmarkCommandlet.h"
+#include "RMEBenchmark.h"
+
+
+URMEBenchmarkCommandlet::URMEBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 URMEBenchmarkCommandlet::Main(const FString& Params)
+{
+	return FRMEBenchmark::Run(FRMEBenchmarkSettings::Parse(*Params)) ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RMEBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless entry point of the root motion benchmark, for CI:
+ * UnrealEditor-Cmd Project.uproject -run=RMEBenchmark -nullrhi Frames=300,1200 Bones=64 Out=Benchmark.csv
+ */
+UCLASS()
+class URMEBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	URMEBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
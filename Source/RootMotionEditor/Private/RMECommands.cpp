@@ -11,6 +11,15 @@ void FRMECommands::RegisterCommands()
 	UI_COMMAND(DoNotVisualizeRootMotion, "None", "Do not show root motion", EUserInterfaceActionType::RadioButton, FInputChord());
 	UI_COMMAND(VisualizeRootMotionTrajectory, "Visualize Trajectory", "Show root motion trajectory", EUserInterfaceActionType::RadioButton, FInputChord());
 	UI_COMMAND(VisualizeRootMotionTrajectoryAndOrientation, "Visualize Trajectory and Orientation", "Show root motion trajectory and orientation", EUserInterfaceActionType::RadioButton, FInputChord());
+	UI_COMMAND(CompareTrajectories, "Compare Asset and Editor", "Draw the asset and the edited root motion trajectories at once, with their deviation", EUserInterfaceActionType::ToggleButton, FInputChord());
+
+	UI_COMMAND(ColorTrajectoryNone, "Plain", "Draw the trajectory in a single color", EUserInterfaceActionType::RadioButton, FInputChord());
+	UI_COMMAND(ColorTrajectoryBySpeed, "Speed", "Color the trajectory by the root motion speed", EUserInterfaceActionType::RadioButton, FInputChord());
+	UI_COMMAND(ColorTrajectoryByAcceleration, "Acceleration", "Color the trajectory by the root motion acceleration", EUserInterfaceActionType::RadioButton, FInputChord());
+
+	UI_COMMAND(ShowGhostPoses, "Ghost Poses", "Show onion skin poses at evenly spaced times along the root motion trajectory", EUserInterfaceActionType::ToggleButton, FInputChord());
+
+	UI_COMMAND(ShowPerformanceHUD, "Performance HUD", "Overlay the root motion evaluations, draw and preview tick times, primitives and cache hit rates of the viewport", EUserInterfaceActionType::ToggleButton, FInputChord());
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -1,20 +1,70 @@
 #include "RMEContext.h"
+#include "RMEAnimationDerivedData.h"
 #include "RMECurveEditor.h"
 #include "RMEPreviewScene.h"
+#include "RMERootMotionLibrary.h"
 #include "RMEViewModel.h"
 #include "SRMEViewport.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
 
 
-FRMEContext* FRMEContext::Instance;
+namespace RMEContext
+{
+	static FString AsMemory(SIZE_T Bytes)
+	{
+		return FText::AsMemory(Bytes).ToString();
+	}
+
+	static FAutoConsoleCommand DumpMemoryCommand(
+		TEXT("RootMotionEditor.DumpMemory"),
+		TEXT("Log the curve keys and bytes of every Root Motion Editor session, and the memory of the shared caches and libraries."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FRMEContext::DumpMemory)
+	);
+}
+
+
+TArray<TSharedRef<FRMEContext>> FRMEContext::Sessions;
+int32 FRMEContext::NextSessionIndex = 0;
+
 void FRMEContext::Initialize()
 {
-	Instance = new FRMEContext;
-	Instance->Setup();
+	NextSessionIndex = 0;
 }
 
 void FRMEContext::Shutdown()
 {
-	delete Instance;
+	while (Sessions.Num() > 0)
+	{
+		DestroySession(&Sessions.Last().Get());
+	}
+}
+
+TSharedRef<FRMEContext> FRMEContext::CreateSession()
+{
+	TSharedRef<FRMEContext> Session = MakeShared<FRMEContext>();
+	Session->SessionIndex = NextSessionIndex++;
+	Session->Setup();
+
+	Sessions.Add(Session);
+	return Session;
+}
+
+void FRMEContext::DestroySession(FRMEContext* Session)
+{
+	const int32 Index = Sessions.IndexOfByPredicate([Session](const TSharedRef<FRMEContext>& Other) { return &Other.Get() == Session; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Session->ViewModel.IsValid())
+	{
+		Session->ViewModel->Shutdown();
+	}
+	Session->CurveEditorPtr.Reset();
+
+	Sessions.RemoveAt(Index);
 }
 
 void FRMEContext::Setup()
@@ -33,7 +83,7 @@ void FRMEContext::Setup()
 	}
 
 	ViewModel = MakeShared<FRMEViewModel>();
-	ViewModel->Initialize(PreviewScene.ToSharedRef());
+	ViewModel->Initialize(PreviewScene.ToSharedRef(), this);
 	CurveEditorPtr.Reset();
 
 	CurveDataPtr = URMECurveContainer::Create();
@@ -72,7 +122,7 @@ bool FRMEContext::IsEditorSelection() const
 
 float FRMEContext::GetViewModelPlayTime() const
 {
-	return ViewModel->GetPlayTime();
+	return ViewModel->GetRequestedPlayTime();
 }
 
 TRange<double> FRMEContext::GetViewModelPlayTimeRange() const
@@ -86,6 +136,11 @@ void FRMEContext::SetViewModelPlayTime(float InPlayTime, bool bInTickPlayTime)
 	ViewModel->SetPlayTime(InPlayTime, bInTickPlayTime);
 }
 
+void FRMEContext::RequestViewModelPlayTime(float InPlayTime)
+{
+	ViewModel->RequestPlayTime(InPlayTime);
+}
+
 void FRMEContext::SetAnimationAsset(UAnimSequence* InAnimationSequence)
 {
 	CurrentAnimation = InAnimationSequence;
@@ -97,6 +152,23 @@ UAnimSequence* FRMEContext::GetAnimationAsset() const
 	return CurrentAnimation;
 }
 
+void FRMEContext::NotifyAnimationModified(UAnimSequence* InAnimationSequence)
+{
+	if (InAnimationSequence == nullptr)
+	{
+		return;
+	}
+
+	FRMEAnimationDerivedData::Invalidate(InAnimationSequence);
+	for (const TSharedRef<FRMEContext>& Session : Sessions)
+	{
+		if (Session->ViewModel.IsValid() && Session->ViewModel->GetAnimation() == InAnimationSequence)
+		{
+			Session->ViewModel->OnAnimationModified();
+		}
+	}
+}
+
 void FRMEContext::SetRootMotionViewMode(ERMERootMotionViewMode InViewMode)
 {
 	ViewModel->SetRootMotionViewMode(InViewMode);
@@ -206,12 +278,12 @@ void FRMEContext::PreviewForwardEnd()
 
 FTransform FRMEContext::GetCurveTransform(float Time, float Weight) const
 {
-	if (CurveDataPtr == nullptr || CurveDataPtr->CurveData == nullptr)
+	if (CurveDataPtr == nullptr || CurveDataPtr->GetCurveData() == nullptr)
 	{
 		return FTransform::Identity;
 	}
 
-	return CurveDataPtr->CurveData->Evaluate(Time, Weight);
+	return CurveDataPtr->GetCurveData()->Evaluate(Time, Weight);
 }
 
 const FTransformCurve* FRMEContext::GetRootMotionTransformCurve() const
@@ -220,5 +292,66 @@ const FTransformCurve* FRMEContext::GetRootMotionTransformCurve() const
 	{
 		return nullptr;
 	}
-	return CurveDataPtr->CurveData;
+	return CurveDataPtr->GetCurveData();
+}
+
+FRMESessionMemory FRMEContext::GetMemoryUsage() const
+{
+	FRMESessionMemory Memory;
+	if (const FTransformCurve* CurveData = CurveDataPtr ? CurveDataPtr->GetCurveData() : nullptr)
+	{
+		Memory.NumCurveKeys = FRMECurvePool::GetNumKeys(*CurveData);
+		Memory.CurveBytes = FRMECurvePool::GetAllocatedSize(*CurveData);
+	}
+	if (const TSharedPtr<FRMECurveEditor> CurveEditor = CurveEditorPtr.Pin())
+	{
+		Memory.HistoryBytes = CurveEditor->GetHistoryAllocatedSize();
+	}
+	if (ViewModel.IsValid())
+	{
+		Memory.ViewModelBytes = ViewModel->GetAllocatedSize();
+	}
+	return Memory;
+}
+
+void FRMEContext::DumpMemory(FOutputDevice& Ar)
+{
+	SIZE_T TotalBytes = 0;
+
+	Ar.Logf(TEXT("Root Motion Editor memory, %d session(s):"), Sessions.Num());
+	for (const TSharedRef<FRMEContext>& Session : Sessions)
+	{
+		const FRMESessionMemory Memory = Session->GetMemoryUsage();
+		Ar.Logf(TEXT("  Session %d (%s): %d curve keys, curve %s, undo history %s, view model %s, total %s"),
+			Session->SessionIndex,
+			*GetNameSafe(Session->CurrentAnimation),
+			Memory.NumCurveKeys,
+			*RMEContext::AsMemory(Memory.CurveBytes),
+			*RMEContext::AsMemory(Memory.HistoryBytes),
+			*RMEContext::AsMemory(Memory.ViewModelBytes),
+			*RMEContext::AsMemory(Memory.GetTotal()));
+		TotalBytes += Memory.HistoryBytes + Memory.ViewModelBytes;
+	}
+
+	// The session curves live in the pool, they're counted once here.
+	const FRMECurvePool& Pool = FRMECurvePool::Get();
+	Ar.Logf(TEXT("  Curve pool: %d curve(s) in use, %d free, %s"), Pool.GetNumAllocated(), Pool.GetNumFree(), *RMEContext::AsMemory(Pool.GetAllocatedSize()));
+	TotalBytes += Pool.GetAllocatedSize();
+
+	TArray<TSharedRef<FRMEAnimationDerivedData>> DerivedData;
+	FRMEAnimationDerivedData::GetAll(DerivedData);
+	for (const TSharedRef<FRMEAnimationDerivedData>& Data : DerivedData)
+	{
+		Ar.Logf(TEXT("  Derived data (%s): %s"), *GetNameSafe(Data->GetAnimation()), *RMEContext::AsMemory(Data->GetAllocatedSize()));
+		TotalBytes += Data->GetAllocatedSize();
+	}
+
+	for (TObjectIterator<URMERootMotionLibrary> It; It; ++It)
+	{
+		const SIZE_T LibraryBytes = It->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		Ar.Logf(TEXT("  Library (%s): %d entries, %s"), *It->GetName(), It->Num(), *RMEContext::AsMemory(LibraryBytes));
+		TotalBytes += LibraryBytes;
+	}
+
+	Ar.Logf(TEXT("  Total: %s"), *RMEContext::AsMemory(TotalBytes));
 }
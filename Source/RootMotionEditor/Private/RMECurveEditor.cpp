@@ -1,11 +1,16 @@
 #include "RMECurveEditor.h"
 #include "CurveEditor.h"
-#include "RichCurveEditorModel.h"
+#include "RMECurveEditorModel.h"
 #include "RMEStatics.h"
 #include "SCurveEditorPanel.h"
 #include "SRMEAssetsSelector.h"
 #include "Curves/CurveVector.h"
 #include "RMEContext.h"
+#include "RMECurveFile.h"
+#include "RMECurveFilters.h"
+#include "RMEGroundProjection.h"
+#include "RMELoopSeam.h"
+#include "RMERootMotionLibrary.h"
 #include "RMETypes.h"
 #include "RMEViewModel.h"
 #include "Tree/CurveEditorTreeFilter.h"
@@ -17,15 +22,30 @@
 #include "Widgets/SWidget.h"
 #include "Widgets/Layout/SScrollBorder.h"
 #include "Widgets/Input/SSegmentedControl.h"
+#include "DesktopPlatformModule.h"
+#include "EditorDirectories.h"
+#include "IDesktopPlatform.h"
 
 #define LOCTEXT_NAMESPACE "RMECurveEditor"
 
-FRMECurveEditorTreeItem::FRMECurveEditorTreeItem(TWeakObjectPtr<UObject> InCurveOwner, FRichCurve* InCurveToEdit, FText InCurveName, FLinearColor InCurveColor)
+FRMECurveEditorTreeItem::FRMECurveEditorTreeItem(TWeakObjectPtr<UObject> InCurveOwner, FRichCurve* InCurveToEdit, FText InCurveName, FLinearColor InCurveColor,
+	FSimpleDelegate InOnCurveModified)
 	: CurveOwner(InCurveOwner)
 	, CurveToEdit(InCurveToEdit)
 	, CurveName(InCurveName)
 	, CurveColor(InCurveColor)
+	, OnCurveModified(InOnCurveModified)
+	, DisplayString(InCurveName.ToString())
 {
+	// Names look like "Translation.X", the tokens are stored child first like the filter terms.
+	FStringView Remaining = DisplayString;
+	int32 SeparatorIndex = INDEX_NONE;
+	while (Remaining.FindLastChar(TEXT('.'), SeparatorIndex))
+	{
+		DisplayTokens.Emplace(Remaining.RightChop(SeparatorIndex + 1));
+		Remaining = Remaining.Left(SeparatorIndex);
+	}
+	DisplayTokens.Emplace(Remaining);
 }
 
 TSharedPtr<SWidget> FRMECurveEditorTreeItem::GenerateCurveEditorTreeWidget(const FName& InColumnName, TWeakPtr<FCurveEditor> InCurveEditor,
@@ -65,9 +85,17 @@ void FRMECurveEditorTreeItem::CreateCurveModels(TArray<TUniquePtr<FCurveModel>>&
 		return;
 	}
 
-	TUniquePtr<FRichCurveEditorModelRaw> NewCurve = MakeUnique<FRichCurveEditorModelRaw>(CurveToEdit, CurveOwner.Get());
+	TUniquePtr<FRMERichCurveEditorModel> NewCurve = MakeUnique<FRMERichCurveEditorModel>(CurveToEdit, CurveOwner.Get());
 	NewCurve->SetShortDisplayName(CurveName);
 	NewCurve->SetColor(CurveColor);
+	NewCurve->OnCurveModified().AddLambda([WeakOwner = CurveOwner, OnModified = OnCurveModified]()
+	{
+		if (URMECurveContainer* Container = Cast<URMECurveContainer>(WeakOwner.Get()))
+		{
+			Container->MarkCurveModified();
+		}
+		OnModified.ExecuteIfBound();
+	});
 	OutCurveModels.Add(MoveTemp(NewCurve));
 }
 
@@ -75,12 +103,10 @@ bool FRMECurveEditorTreeItem::PassesFilter(const FCurveEditorTreeFilter* InFilte
 {
 	if (InFilter->GetType() == ECurveEditorTreeFilterType::Text)
 	{
-		FString DisplayNameAsString = CurveName.ToString();
-
 		const FCurveEditorTreeTextFilter* Filter = static_cast<const FCurveEditorTreeTextFilter*>(InFilter);
 		for (const FCurveEditorTreeTextFilterTerm& Term : Filter->GetTerms())
 		{
-			if (!Term.Match(DisplayNameAsString).IsTotalMatch())
+			if (!MatchesTerm(Term))
 			{
 				return false;
 			}
@@ -93,6 +119,22 @@ bool FRMECurveEditorTreeItem::PassesFilter(const FCurveEditorTreeFilter* InFilte
 	
 }
 
+bool FRMECurveEditorTreeItem::MatchesTerm(const FCurveEditorTreeTextFilterTerm& Term) const
+{
+	if (Term.Match(DisplayString).IsTotalMatch())
+	{
+		return true;
+	}
+
+	// A dotted term such as "Translation.X" matches the tokens one by one, from the axis up to the channel.
+	FCurveEditorTreeTextFilterTerm::FMatchResult Result = Term.Match(DisplayTokens[0]);
+	for (int32 Index = 1; Index < DisplayTokens.Num() && Result.IsPartialMatch(); ++Index)
+	{
+		Result = Result.Match(DisplayTokens[Index]);
+	}
+	return Result.IsTotalMatch();
+}
+
 
 /**
  *	FRMECurveEditor
@@ -109,6 +151,7 @@ void FRMECurveEditor::Initialize()
 
 void FRMECurveEditor::OnDestroy()
 {
+	CancelFilterPreview();
 	Config->RemoveFromRoot();
 	Config = nullptr;
 }
@@ -142,9 +185,19 @@ void FRMECurveEditor::SetupCurveEditor()
 	}
 }
 
+void FRMECurveEditor::SetContext(const TSharedPtr<FRMEContext>& InContext)
+{
+	ContextPtr = InContext;
+}
+
+FRMEContext* FRMECurveEditor::GetContext() const
+{
+	return ContextPtr.Pin().Get();
+}
+
 URMECurveContainer* FRMECurveEditor::GetCurveContainer() const
 {
-	FRMEContext* Context = FRMEContext::Get();
+	FRMEContext* Context = GetContext();
 	if (Context != nullptr)
 	{
 		return Context->GetCurveContainer();
@@ -187,9 +240,9 @@ void FRMECurveEditor::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManag
 			]
 		];
 	
-	OnLoadCurveDataCompleted.AddLambda([]()
+	OnLoadCurveDataCompleted.AddLambda([WeakContext = ContextPtr]()
 	{
-		if (FRMEContext* Context = FRMEContext::Get())
+		if (TSharedPtr<FRMEContext> Context = WeakContext.Pin())
 		{
 			if (FRMEViewModel* ViewModel = Context->GetViewModel())
 			{
@@ -258,6 +311,7 @@ void FRMECurveEditor::RegisterConfigTabSpawner(const TSharedPtr<class FTabManage
 								})
 								+SSegmentedControl<ERMEBoneExtractMode>::Slot(ERMEBoneExtractMode::RootMotion).Text(LOCTEXT("RootMotionExtractMode", "Root Motion"))
 								+SSegmentedControl<ERMEBoneExtractMode>::Slot(ERMEBoneExtractMode::AnimPose).Text(LOCTEXT("AnimPoseExtractMode", "Anim Pose"))
+								+SSegmentedControl<ERMEBoneExtractMode>::Slot(ERMEBoneExtractMode::GroundProjectedPelvis).Text(LOCTEXT("GroundProjectedPelvisExtractMode", "Pelvis"))
 							]
 							+SScrollBox::Slot()
 							[
@@ -289,6 +343,11 @@ void FRMECurveEditor::OnFinishedChangingProperties(const FPropertyChangedEvent&
 	{
 		bIsSetCustomBone = !Config->CustomLoadBoneName.IsNone() || !Config->CustomSaveBoneName.IsNone();
 	}
+
+	if (IsFilterPreviewActive() && ChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(URMECurveEditorConfig, Smoothing))
+	{
+		UpdateFilterPreview();
+	}
 }
 
 TSharedRef<SWidget> FRMECurveEditor::CreateToolbar()
@@ -315,15 +374,68 @@ TSharedRef<SWidget> FRMECurveEditor::CreateToolbar()
 			LOCTEXT("ClearCurvesTooltip", "Remove all curves"),
 			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.X")
 		);
+
+		ToolbarBuilder.AddSeparator();
+
+		ToolbarBuilder.AddComboButton(
+			FUIAction(FExecuteAction(), FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanApplyCurveOperation)),
+			FOnGetContent::CreateSP(this, &FRMECurveEditor::MakeCurveOperationsMenu),
+			LOCTEXT("CurveOperations", "Reshape"),
+			LOCTEXT("CurveOperationsTooltip", "Reshape the selected keys, or the whole curve when no key is selected. The parameters are in the Curve Editor Settings tab."),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Transform")
+		);
+
+		ToolbarBuilder.AddComboButton(
+			FUIAction(FExecuteAction(), FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanApplyCurveOperation)),
+			FOnGetContent::CreateSP(this, &FRMECurveEditor::MakeCurveFiltersMenu),
+			LOCTEXT("CurveFilters", "Smooth"),
+			LOCTEXT("CurveFiltersTooltip", "Smooth the selected keys, or the whole curve when no key is selected. The filter and its parameters are in the Curve Editor Settings tab."),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Filter")
+		);
+
+		ToolbarBuilder.AddSeparator();
+
+		ToolbarBuilder.AddToolBarButton(
+		FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::UndoCurveChange),
+			FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanUndoCurveChange)),
+			NAME_None,
+			LOCTEXT("UndoCurveChange", "Undo"),
+			TAttribute<FText>::CreateLambda([this]()
+			{
+				return FText::Format(LOCTEXT("UndoCurveChangeTooltip", "Undo the last curve edit: {0}"), History.GetUndoDescription());
+			}),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "GenericCommands.Undo")
+		);
+
+		ToolbarBuilder.AddToolBarButton(
+		FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::RedoCurveChange),
+			FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanRedoCurveChange)),
+			NAME_None,
+			LOCTEXT("RedoCurveChange", "Redo"),
+			TAttribute<FText>::CreateLambda([this]()
+			{
+				return FText::Format(LOCTEXT("RedoCurveChangeTooltip", "Redo the last undone curve edit: {0}"), History.GetRedoDescription());
+			}),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "GenericCommands.Redo")
+		);
         
-		// ToolbarBuilder.AddToolBarButton(
-		// FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::SaveCurveData),
-		// 	FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanEditCurve)),
-		// 	NAME_None,
-		// 	LOCTEXT("SaveCurves", "Save"),
-		// 	LOCTEXT("SaveCurvesTooltip", "Save curve data to file"),
-		// 	FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Save")
-		// );
+		ToolbarBuilder.AddToolBarButton(
+		FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::SaveCurveData),
+			FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanEditCurve)),
+			NAME_None,
+			LOCTEXT("SaveCurves", "Export"),
+			LOCTEXT("SaveCurvesTooltip", "Export curve data to a binary (.rmecurve) or CSV (.csv) file"),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Save")
+		);
+
+		ToolbarBuilder.AddToolBarButton(
+		FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::LoadCurveData),
+			FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanEditCurve)),
+			NAME_None,
+			LOCTEXT("LoadCurves", "Import"),
+			LOCTEXT("LoadCurvesTooltip", "Import curve data from a binary (.rmecurve) or CSV (.csv) file"),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Import")
+		);
 
 		ToolbarBuilder.AddSeparator();
 
@@ -370,12 +482,370 @@ TSharedRef<SWidget> FRMECurveEditor::CreateToolbar()
 			LOCTEXT("SaveToAnimTooltip", "Save curve data to anim asset file"),
 			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Save")
 		);
+
+		ToolbarBuilder.AddSeparator();
+
+		ToolbarBuilder.AddToolBarButton(
+			FUIAction(
+				FExecuteAction::CreateSP(this, &FRMECurveEditor::LoadFromLibrary),
+				FCanExecuteAction::CreateSP(this, &FRMECurveEditor::HasLibraryEntry)
+				),
+			NAME_None,
+			LOCTEXT("LoadFromLibrary", "Load From Library"),
+			LOCTEXT("LoadFromLibraryTooltip", "Load curve data from the entry of the root motion library"),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Blueprints")
+		);
+
+		ToolbarBuilder.AddToolBarButton(
+			FUIAction(
+				FExecuteAction::CreateSP(this, &FRMECurveEditor::SaveToLibrary),
+				FCanExecuteAction::CreateSP(this, &FRMECurveEditor::HasLibraryEntry)
+				),
+			NAME_None,
+			LOCTEXT("SaveToLibrary", "Save To Library"),
+			LOCTEXT("SaveToLibraryTooltip", "Save curve data to the entry of the root motion library, the entry is added if it doesn't exist"),
+			FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Save")
+		);
 	}
 	ToolbarBuilder.EndSection();
     
 	return ToolbarBuilder.MakeWidget();
 }
 
+TSharedRef<SWidget> FRMECurveEditor::MakeCurveOperationsMenu()
+{
+	checkf(Config, TEXT("Not fount root motion editor config, please check it."));
+
+	FMenuBuilder MenuBuilder(true, nullptr);
+	MenuBuilder.BeginSection("CurveOperations", LOCTEXT("CurveOperationsSection", "Reshape"));
+	{
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("ScaleDistance", "Scale Distance x{0}"), FText::AsNumber(Config->DistanceScale)),
+			LOCTEXT("ScaleDistanceTooltip", "Scale the translation around the position at the start of the range."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				const float Scale = Config->DistanceScale;
+				ApplyCurveOperation(LOCTEXT("ScaleDistanceChange", "Scale Distance"), [Scale](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::ScaleDistance(Curve, Range, Scale);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("TimeStretch", "Time Stretch x{0}"), FText::AsNumber(Config->TimeScale)),
+			LOCTEXT("TimeStretchTooltip", "Stretch the key times of the range, the following keys are shifted by the change of length."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				const float Scale = Config->TimeScale;
+				ApplyCurveOperation(LOCTEXT("TimeStretchChange", "Time Stretch"), [Scale](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::TimeStretch(Curve, Range, Scale);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("OffsetTranslation", "Offset {0}"), FText::FromString(Config->TranslationOffset.ToCompactString())),
+			LOCTEXT("OffsetTranslationTooltip", "Move the translation of the range."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				const FVector Offset = Config->TranslationOffset;
+				ApplyCurveOperation(LOCTEXT("OffsetTranslationChange", "Offset"), [Offset](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::Offset(Curve, Range, Offset);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("MirrorAxis", "Mirror {0}"), UEnum::GetDisplayValueAsText(Config->MirrorAxis.GetValue())),
+			LOCTEXT("MirrorAxisTooltip", "Mirror the translation across the plane through the start position, the rotations are mirrored to match."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				const EAxis::Type Axis = Config->MirrorAxis;
+				ApplyCurveOperation(LOCTEXT("MirrorAxisChange", "Mirror"), [Axis](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::Mirror(Curve, Range, Axis);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("RotateAboutZ", "Rotate About Z {0} deg"), FText::AsNumber(Config->RotationYaw)),
+			LOCTEXT("RotateAboutZTooltip", "Rotate the trajectory about the vertical axis through the start position, and add the yaw to the rotation."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				const float Degrees = Config->RotationYaw;
+				ApplyCurveOperation(LOCTEXT("RotateAboutZChange", "Rotate About Z"), [Degrees](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::RotateAboutZ(Curve, Range, Degrees);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			LOCTEXT("RemoveZDrift", "Remove Z Drift"),
+			LOCTEXT("RemoveZDriftTooltip", "Remove the linear drift of the height over the range, so it ends at the height it starts."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				ApplyCurveOperation(LOCTEXT("RemoveZDriftChange", "Remove Z Drift"), [](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::RemoveDrift(Curve, Range, EAxis::Z);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			LOCTEXT("ZeroStartYaw", "Zero Start Yaw"),
+			LOCTEXT("ZeroStartYawTooltip", "Rotate about the vertical axis so the yaw at the start of the range is zero."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				ApplyCurveOperation(LOCTEXT("ZeroStartYawChange", "Zero Start Yaw"), [](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMECurveOperations::ZeroStartYaw(Curve, Range);
+				});
+			}))
+		);
+
+		MenuBuilder.AddMenuEntry(
+			LOCTEXT("SolveLoopSeam", "Solve Loop Seam"),
+			LOCTEXT("SolveLoopSeamTooltip", "For looping clips: spread the mismatch between the end and the start of the range over the range, so the velocity carries over the loop without a hitch. Only for a previewed animation set to loop."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateLambda([this]()
+			{
+				ApplyCurveOperation(LOCTEXT("SolveLoopSeamChange", "Solve Loop Seam"), [](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+				{
+					RMELoopSeam::Solve(Curve, Range);
+				});
+			}),
+			FCanExecuteAction::CreateSP(this, &FRMECurveEditor::CanSolveLoopSeam))
+		);
+	}
+	MenuBuilder.EndSection();
+
+	return MenuBuilder.MakeWidget();
+}
+
+TSharedRef<SWidget> FRMECurveEditor::MakeCurveFiltersMenu()
+{
+	checkf(Config, TEXT("Not fount root motion editor config, please check it."));
+
+	FMenuBuilder MenuBuilder(true, nullptr);
+	MenuBuilder.BeginSection("CurveFilters", LOCTEXT("CurveFiltersSection", "Smooth"));
+	{
+		MenuBuilder.AddMenuEntry(
+			LOCTEXT("PreviewFilter", "Preview"),
+			LOCTEXT("PreviewFilterTooltip", "Show the filtered keys while the smoothing settings are adjusted, nothing is kept until it's applied."),
+			FSlateIcon(),
+			FUIAction(
+				FExecuteAction::CreateSP(this, &FRMECurveEditor::ToggleFilterPreview),
+				FCanExecuteAction(),
+				FIsActionChecked::CreateSP(this, &FRMECurveEditor::IsFilterPreviewActive)),
+			NAME_None,
+			EUserInterfaceActionType::ToggleButton
+		);
+
+		MenuBuilder.AddMenuEntry(
+			FText::Format(LOCTEXT("ApplyFilter", "Apply {0}"), UEnum::GetDisplayValueAsText(Config->Smoothing.Type)),
+			LOCTEXT("ApplyFilterTooltip", "Smooth the channels picked in the settings."),
+			FSlateIcon(),
+			FUIAction(FExecuteAction::CreateSP(this, &FRMECurveEditor::ApplyCurveFilter))
+		);
+	}
+	MenuBuilder.EndSection();
+
+	return MenuBuilder.MakeWidget();
+}
+
+FRMECurveOperationRange FRMECurveEditor::GetCurveOperationRange() const
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr == nullptr || CurveDataPtr->GetCurveData() == nullptr)
+	{
+		return FRMECurveOperationRange();
+	}
+
+	FRMECurveOperationRange Range = RMECurveOperations::GetKeyRange(*CurveDataPtr->GetCurveData());
+	if (CurveEditor.IsValid() && CurveEditor->GetSelection().Count() > 0)
+	{
+		Range.StartTime = MAX_flt;
+		Range.EndTime = -MAX_flt;
+
+		TArray<FKeyPosition> KeyPositions;
+		for (const TTuple<FCurveModelID, FKeyHandleSet>& Pair : CurveEditor->GetSelection().GetAll())
+		{
+			if (const FCurveModel* CurveModel = CurveEditor->FindCurve(Pair.Key))
+			{
+				TArrayView<const FKeyHandle> KeyHandles = Pair.Value.AsArray();
+				KeyPositions.SetNum(KeyHandles.Num());
+				CurveModel->GetKeyPositions(KeyHandles, KeyPositions);
+				for (const FKeyPosition& KeyPosition : KeyPositions)
+				{
+					Range.StartTime = FMath::Min(Range.StartTime, static_cast<float>(KeyPosition.InputValue));
+					Range.EndTime = FMath::Max(Range.EndTime, static_cast<float>(KeyPosition.InputValue));
+				}
+			}
+		}
+	}
+
+	if (Config)
+	{
+		Range.bCarryFollowingKeys = Config->bCarryFollowingKeys;
+		Range.bIsAdditiveCurve = Config->bIsAdditiveCurve;
+	}
+	return Range;
+}
+
+bool FRMECurveEditor::CanApplyCurveOperation() const
+{
+	const FRMECurveOperationRange Range = GetCurveOperationRange();
+	return Range.StartTime <= Range.EndTime;
+}
+
+bool FRMECurveEditor::CanSolveLoopSeam() const
+{
+	const FRMEContext* Context = GetContext();
+	const UAnimSequence* Animation = Context ? Context->GetAnimationAsset() : nullptr;
+	return Animation && Animation->bLoop && CanApplyCurveOperation();
+}
+
+void FRMECurveEditor::ApplyCurveOperation(const FText& Description, TFunctionRef<void(FTransformCurve&, const FRMECurveOperationRange&)> Operation)
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	const FRMECurveOperationRange Range = GetCurveOperationRange();
+	if (CurveDataPtr == nullptr || CurveDataPtr->GetCurveData() == nullptr || Range.StartTime > Range.EndTime)
+	{
+		return;
+	}
+
+	BeginCurveChange();
+	Operation(*CurveDataPtr->GetCurveData(), Range);
+	EndCurveChange(Description);
+
+	CurveDataPtr->MarkCurveModified();
+	RefreshEditorCurves(CurveDataPtr);
+}
+
+void FRMECurveEditor::ApplyCurveFilter()
+{
+	const FText Description = FText::Format(LOCTEXT("SmoothChange", "Smooth ({0})"), UEnum::GetDisplayValueAsText(Config->Smoothing.Type));
+	if (!IsFilterPreviewActive())
+	{
+		const FRMECurveFilterSettings Settings = Config->Smoothing;
+		ApplyCurveOperation(Description, [&Settings](FTransformCurve& Curve, const FRMECurveOperationRange& Range)
+		{
+			RMECurveFilters::Apply(Curve, Range, Settings);
+		});
+		return;
+	}
+
+	// The change was begun when the preview started, the previewed keys are what it recorded.
+	UpdateFilterPreview();
+	if (IsFilterPreviewActive())
+	{
+		FilterPreviewSource.Reset();
+		EndCurveChange(Description);
+	}
+}
+
+void FRMECurveEditor::ToggleFilterPreview()
+{
+	if (IsFilterPreviewActive())
+	{
+		CancelFilterPreview();
+		return;
+	}
+
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	const FRMECurveOperationRange Range = GetCurveOperationRange();
+	if (CurveDataPtr == nullptr || CurveDataPtr->GetCurveData() == nullptr || Range.StartTime > Range.EndTime)
+	{
+		return;
+	}
+
+	BeginCurveChange();
+	FilterPreviewSource = *CurveDataPtr->GetCurveData();
+	FilterPreviewRange = Range;
+	UpdateFilterPreview();
+}
+
+void FRMECurveEditor::UpdateFilterPreview()
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	FTransformCurve* Curve = CurveDataPtr != nullptr ? CurveDataPtr->GetCurveData() : nullptr;
+	if (!IsFilterPreviewActive() || Curve == nullptr)
+	{
+		StopFilterPreview();
+		return;
+	}
+
+	// Only the values and tangents change, the keys keep their handles in the curve editor.
+	for (int32 Channel = 0; Channel < FRMECurveHistory::NumChannels; ++Channel)
+	{
+		const TArray<FRichCurveKey>& SourceKeys = FRMECurveHistory::GetChannel(*FilterPreviewSource, Channel).Keys;
+		TArray<FRichCurveKey>& Keys = FRMECurveHistory::GetChannel(*Curve, Channel).Keys;
+		if (Keys.Num() != SourceKeys.Num())
+		{
+			// Something else replaced the keys, there is nothing left to preview on.
+			StopFilterPreview();
+			return;
+		}
+		FMemory::Memcpy(Keys.GetData(), SourceKeys.GetData(), Keys.Num() * sizeof(FRichCurveKey));
+	}
+
+	RMECurveFilters::Apply(*Curve, FilterPreviewRange, Config->Smoothing);
+	CurveDataPtr->MarkCurveModified();
+	RefreshEditorCurves(CurveDataPtr);
+}
+
+void FRMECurveEditor::StopFilterPreview()
+{
+	if (IsFilterPreviewActive())
+	{
+		FilterPreviewSource.Reset();
+		History.AbortChange();
+	}
+}
+
+void FRMECurveEditor::CancelFilterPreview()
+{
+	if (!IsFilterPreviewActive())
+	{
+		return;
+	}
+
+	const TOptional<FTransformCurve> Source = MoveTemp(FilterPreviewSource);
+	FilterPreviewSource.Reset();
+	History.AbortChange();
+
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	FTransformCurve* Curve = CurveDataPtr != nullptr ? CurveDataPtr->GetCurveData() : nullptr;
+	if (Curve == nullptr)
+	{
+		return;
+	}
+
+	for (int32 Channel = 0; Channel < FRMECurveHistory::NumChannels; ++Channel)
+	{
+		const TArray<FRichCurveKey>& SourceKeys = FRMECurveHistory::GetChannel(*Source, Channel).Keys;
+		TArray<FRichCurveKey>& Keys = FRMECurveHistory::GetChannel(*Curve, Channel).Keys;
+		if (Keys.Num() == SourceKeys.Num())
+		{
+			FMemory::Memcpy(Keys.GetData(), SourceKeys.GetData(), Keys.Num() * sizeof(FRichCurveKey));
+		}
+	}
+	CurveDataPtr->MarkCurveModified();
+	RefreshEditorCurves(CurveDataPtr);
+}
+
 TSharedRef<SWidget> FRMECurveEditor::CreateCurveEditorToolbar()
 {
 	FSlimHorizontalToolBarBuilder ToolBarBuilder(CurveEditorPanel->GetCommands(), FMultiBoxCustomization::None, CurveEditorPanel->GetToolbarExtender(), true);
@@ -400,12 +870,16 @@ bool FRMECurveEditor::AddPreviewKey(ERMEPreviewEditMode EditMode, float Time, co
 		return false;
 	}
 
+	CancelFilterPreview();
+
 	FTransformCurve* CurveData = CurveContainer->GetOrCreateCurveData();
 	if (CurveData == nullptr)
 	{
 		return false;
 	}
 
+	History.BeginChange(*CurveData);
+
 	bool bHasAddedKey = false;
 	switch (EditMode)
 	{
@@ -423,9 +897,13 @@ bool FRMECurveEditor::AddPreviewKey(ERMEPreviewEditMode EditMode, float Time, co
 
 	if (!bHasAddedKey)
 	{
+		History.EndChange(*CurveData, FText::GetEmpty());
 		return false;
 	}
 
+	History.EndChange(*CurveData, LOCTEXT("AddPreviewKeyChange", "Add Key"));
+	CurveContainer->MarkCurveModified();
+
 	if (!bHasEditorCurves)
 	{
 		AddNewCurve(CurveContainer);
@@ -450,7 +928,8 @@ void FRMECurveEditor::AddNewCurveInternal(FVectorCurve& CurveData, UObject* Curv
 		const FText CurveNameText = FText::FromName(URMECurveContainer::GetFullCurveName(ChannelName, Index));
 		const FLinearColor Color = URMECurveContainer::GetCurveAxisColor(Index);
 			
-		TSharedPtr<FRMECurveEditorTreeItem> TreeItem = MakeShared<FRMECurveEditorTreeItem>(CurveOwner, Curve, CurveNameText, Color);
+		TSharedPtr<FRMECurveEditorTreeItem> TreeItem = MakeShared<FRMECurveEditorTreeItem>(CurveOwner, Curve, CurveNameText, Color,
+			FSimpleDelegate::CreateSP(this, &FRMECurveEditor::OnCurveModelModified));
 		FCurveEditorTreeItem* NewItem = CurveEditor->AddTreeItem(FCurveEditorTreeItemID::Invalid());
 		NewItem->SetStrongItem(TreeItem);
 
@@ -465,7 +944,7 @@ void FRMECurveEditor::AddNewCurveInternal(FVectorCurve& CurveData, UObject* Curv
 
 void FRMECurveEditor::CreateDefaultCurves()
 {
-	FRMEContext* Context = FRMEContext::Get();
+	FRMEContext* Context = GetContext();
 	ensureMsgf(Context, TEXT("The Context of root motion editor is null !!"));
 	AddNewCurve(Context->GetCurveContainer());
 }
@@ -479,9 +958,10 @@ void FRMECurveEditor::AddNewCurve(URMECurveContainer* Container)
 	
 	check(CurveEditor.IsValid());
 	
-	AddNewCurveInternal(Container->CurveData->TranslationCurve, Container, "Translation");
-	AddNewCurveInternal(Container->CurveData->RotationCurve, Container, "Rotation");
-	AddNewCurveInternal(Container->CurveData->ScaleCurve, Container, "Scale");
+	FTransformCurve* CurveData = Container->GetOrCreateCurveData();
+	AddNewCurveInternal(CurveData->TranslationCurve, Container, "Translation");
+	AddNewCurveInternal(CurveData->RotationCurve, Container, "Rotation");
+	AddNewCurveInternal(CurveData->ScaleCurve, Container, "Scale");
 	
 	CurveEditor->ZoomToFit();
 
@@ -490,9 +970,106 @@ void FRMECurveEditor::AddNewCurve(URMECurveContainer* Container)
 }
 
 
+void FRMECurveEditor::RefreshEditorCurves(URMECurveContainer* Container, bool bZoomToFit)
+{
+	if (Container == nullptr)
+	{
+		return;
+	}
+
+	if (!bHasEditorCurves)
+	{
+		AddNewCurve(Container);
+		return;
+	}
+
+	check(CurveEditor.IsValid());
+
+	// The tree items and the curve models point into the container's curves, which are updated in place,
+	// so only the key handles of the selection are stale.
+	CurveEditor->GetSelection().Clear();
+	if (bZoomToFit)
+	{
+		CurveEditor->ZoomToFit();
+	}
+	if (CurveEditorPanel.IsValid())
+	{
+		CurveEditorPanel->Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	bHasCurveEdited = true;
+}
+
 void FRMECurveEditor::ClearAllCurves()
 {
+	BeginCurveChange();
 	ClearEditorAllCurves();
+	EndCurveChange(LOCTEXT("ClearCurvesChange", "Clear Curves"));
+	LoadedPelvisBoneName = NAME_None;
+}
+
+void FRMECurveEditor::BeginCurveChange()
+{
+	CancelFilterPreview();
+
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr != nullptr)
+	{
+		History.BeginChange(*CurveDataPtr->GetOrCreateCurveData());
+	}
+}
+
+void FRMECurveEditor::EndCurveChange(const FText& Description)
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr != nullptr)
+	{
+		History.EndChange(*CurveDataPtr->GetOrCreateCurveData(), Description);
+	}
+}
+
+void FRMECurveEditor::OnCurveModelModified()
+{
+	// The keys were edited on top of the previewed ones, they are kept as they are now instead of being filtered again.
+	StopFilterPreview();
+
+	// Changes bracketed by BeginCurveChange/EndCurveChange are recorded, the others are made by the curve editor.
+	if (!History.IsChangeOpen())
+	{
+		History.Reset();
+	}
+}
+
+bool FRMECurveEditor::CanUndoCurveChange() const
+{
+	return History.CanUndo();
+}
+
+bool FRMECurveEditor::CanRedoCurveChange() const
+{
+	return History.CanRedo();
+}
+
+void FRMECurveEditor::UndoCurveChange()
+{
+	CancelFilterPreview();
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr != nullptr && History.Undo(*CurveDataPtr->GetOrCreateCurveData()))
+	{
+		CurveDataPtr->MarkCurveModified();
+		RefreshEditorCurves(CurveDataPtr);
+	}
+}
+
+void FRMECurveEditor::RedoCurveChange()
+{
+	CancelFilterPreview();
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr != nullptr && History.Redo(*CurveDataPtr->GetOrCreateCurveData()))
+	{
+		CurveDataPtr->MarkCurveModified();
+		RefreshEditorCurves(CurveDataPtr);
+	}
 }
 
 void FRMECurveEditor::ClearEditorAllCurves()
@@ -512,7 +1089,76 @@ void FRMECurveEditor::ClearEditorAllCurves()
 
 void FRMECurveEditor::SaveCurveData()
 {
-	// todo: save to local file.
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	const FTransformCurve* CurveData = CurveDataPtr ? CurveDataPtr->GetCurveData() : nullptr;
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (CurveData == nullptr || DesktopPlatform == nullptr)
+	{
+		return;
+	}
+
+	const FRMEContext* Context = GetContext();
+	const UAnimSequence* Animation = Context ? Context->GetAnimationAsset() : nullptr;
+
+	TArray<FString> Filenames;
+	const bool bHasFile = DesktopPlatform->SaveFileDialog(
+		FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr),
+		LOCTEXT("ExportCurveTitle", "Export Root Motion Curve").ToString(),
+		FEditorDirectories::Get().GetLastDirectory(ELastDirectory::GENERIC_EXPORT),
+		Animation ? Animation->GetName() : FString(),
+		FRMECurveFile::FileTypes,
+		EFileDialogFlags::None,
+		Filenames);
+	if (!bHasFile || Filenames.Num() == 0)
+	{
+		return;
+	}
+
+	FEditorDirectories::Get().SetLastDirectory(ELastDirectory::GENERIC_EXPORT, FPaths::GetPath(Filenames[0]));
+	if (!FRMECurveFile::Save(Filenames[0], *CurveData))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("ExportCurveFailed", "Failed to export the curve to {0}, see the output log."), FText::FromString(Filenames[0])));
+	}
+}
+
+void FRMECurveEditor::LoadCurveData()
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	if (CurveDataPtr == nullptr || DesktopPlatform == nullptr)
+	{
+		return;
+	}
+
+	if (!ConfirmDiscardEditedCurve(LOCTEXT("HasEditedCurveFile", "You have already edited the curve. Are you sure you want to discard it and import the file ?")))
+	{
+		return;
+	}
+
+	TArray<FString> Filenames;
+	const bool bHasFile = DesktopPlatform->OpenFileDialog(
+		FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr),
+		LOCTEXT("ImportCurveTitle", "Import Root Motion Curve").ToString(),
+		FEditorDirectories::Get().GetLastDirectory(ELastDirectory::GENERIC_IMPORT),
+		FString(),
+		FRMECurveFile::FileTypes,
+		EFileDialogFlags::None,
+		Filenames);
+	if (!bHasFile || Filenames.Num() == 0)
+	{
+		return;
+	}
+
+	FEditorDirectories::Get().SetLastDirectory(ELastDirectory::GENERIC_IMPORT, FPaths::GetPath(Filenames[0]));
+
+	FTransformCurve Curve;
+	if (!FRMECurveFile::Load(Filenames[0], Curve))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("ImportCurveFailed", "Failed to import the curve from {0}, see the output log."), FText::FromString(Filenames[0])));
+		return;
+	}
+
+	ReplaceCurveData(Curve, LOCTEXT("ImportCurveChange", "Import Curve"));
 }
 
 bool FRMECurveEditor::CanEditCurve() const
@@ -534,10 +1180,13 @@ void FRMECurveEditor::LoadExternalCurveData()
 	URMEAssetCollection* AssetCollection = Selector ? Selector->GetAssetCollection() : nullptr;
 	if (AssetCollection && AssetCollection->HasAnyCurveAsset())
 	{
-		ClearEditorAllCurves();
 		URMECurveContainer* CurveDataPtr = GetCurveContainer();
+		BeginCurveChange();
 		CurveDataPtr->PushCurveData(AssetCollection->MotionCurve, AssetCollection->RotationCurve, AssetCollection->ScaleCurve);
-		AddNewCurve(CurveDataPtr);
+		EndCurveChange(LOCTEXT("LoadCurveChange", "Load From Curve"));
+		const bool bZoomToFit = true;
+		RefreshEditorCurves(CurveDataPtr, bZoomToFit);
+		LoadedPelvisBoneName = NAME_None;
 
 		OnLoadCurveDataCompleted.Broadcast();
 	}
@@ -570,7 +1219,7 @@ void FRMECurveEditor::SaveToExternalCurveData()
 		}
 	};
 
-	if (FTransformCurve* CurveData = CurveDataPtr->CurveData)
+	if (FTransformCurve* CurveData = CurveDataPtr->GetCurveData())
 	{
 		SaveCurve(AssetCollection->MotionCurve, CurveData->TranslationCurve);
 		SaveCurve(AssetCollection->RotationCurve, CurveData->RotationCurve);
@@ -591,6 +1240,37 @@ bool FRMECurveEditor::HasExternalAnim() const
 	return Selector.IsValid() ? Selector->GetSequence() != nullptr : false;
 }
 
+bool FRMECurveEditor::ConfirmDiscardEditedCurve(const FText& Question) const
+{
+	if (!bHasCurveEdited)
+	{
+		return true;
+	}
+
+	const EAppReturnType::Type Choice = FMessageDialog::Open(EAppMsgType::YesNo, Question);
+	return Choice != EAppReturnType::No;
+}
+
+void FRMECurveEditor::ReplaceCurveData(const FTransformCurve& InCurve, const FText& Description)
+{
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	if (CurveDataPtr == nullptr)
+	{
+		return;
+	}
+
+	BeginCurveChange();
+	CurveDataPtr->CopyCurveData(InCurve);
+	EndCurveChange(Description);
+	const bool bZoomToFit = true;
+	RefreshEditorCurves(CurveDataPtr, bZoomToFit);
+
+	// Whatever the new keys are, they don't come from the pelvis until the caller says so.
+	LoadedPelvisBoneName = NAME_None;
+
+	OnLoadCurveDataCompleted.Broadcast();
+}
+
 void FRMECurveEditor::LoadExternalAnimData()
 {
 	TSharedPtr<SRMEAssetsSelector> Selector = RootMotionEditorStatics::GetTabWidget<SRMEAssetsSelector>(WeakTabManager.Pin().Get(), SRMEAssetsSelector::TabName);
@@ -598,6 +1278,7 @@ void FRMECurveEditor::LoadExternalAnimData()
 	if (AnimSequence != nullptr)
 	{
 		checkf(Config, TEXT("Not fount root motion editor config, please check it."));
+		const FText DiscardQuestion = LOCTEXT("HasEditedCurve", "You have already edited the curve. Are you sure you want to discard it and write it into the animation data ?");
 		
 		if (Config->ExtractMode == ERMEBoneExtractMode::AnimPose)
 		{
@@ -608,25 +1289,17 @@ void FRMECurveEditor::LoadExternalAnimData()
 				return;
 			}
 
-			// Prompts user.
-			if (bHasCurveEdited)
+			if (!ConfirmDiscardEditedCurve(DiscardQuestion))
 			{
-				const EAppReturnType::Type Choice = FMessageDialog::Open(EAppMsgType::YesNo, LOCTEXT("HasEditedCurve", "You have already edited the curve. Are you sure you want to discard it and write it into the animation data ?"));
-				if (Choice == EAppReturnType::No)
-				{
-					return;
-				}
+				return;
 			}
 
-			ClearEditorAllCurves();
-
-			URMECurveContainer* CurveDataPtr = GetCurveContainer();
-			const FTransformCurve& Curve = RootMotionEditorStatics::BakeAnimPoseBoneToCurve(AnimSequence, TargetBoneName, Config->SampleRate,
+			const FTransformCurve& Curve = Config->AdaptiveSampling.bEnabled
+				? RootMotionEditorStatics::BakeAnimPoseBoneToCurveAdaptive(AnimSequence, TargetBoneName, Config->AdaptiveSampling,
+					Config->ExtractChannels, Config->bIsAdditiveCurve, Config->EvaluationOptions, Config->Space)
+				: RootMotionEditorStatics::BakeAnimPoseBoneToCurve(AnimSequence, TargetBoneName, Config->SampleRate,
 					Config->ExtractChannels, Config->bIsAdditiveCurve, Config->EvaluationOptions, Config->Space);
-			CurveDataPtr->CopyCurveData(Curve);
-			AddNewCurve(CurveDataPtr);
-
-			OnLoadCurveDataCompleted.Broadcast();
+			ReplaceCurveData(Curve, LOCTEXT("LoadAnimChange", "Load From Anim"));
 		}
 		else if (Config->ExtractMode == ERMEBoneExtractMode::RootMotion)
 		{
@@ -636,31 +1309,46 @@ void FRMECurveEditor::LoadExternalAnimData()
 				return;
 			}
 
-			// Prompts user.
-			if (bHasCurveEdited)
+			if (!ConfirmDiscardEditedCurve(DiscardQuestion))
 			{
-				const EAppReturnType::Type Choice = FMessageDialog::Open(EAppMsgType::YesNo, LOCTEXT("HasEditedCurve", "You have already edited the curve. Are you sure you want to discard it and write it into the animation data ?"));
-				if (Choice == EAppReturnType::No)
-				{
-					return;
-				}
+				return;
+			}
+
+			const FTransformCurve& Curve = Config->AdaptiveSampling.bEnabled
+				? RootMotionEditorStatics::BakeRootBoneToCurveAdaptive(AnimSequence, Config->AdaptiveSampling, Config->ExtractChannels, Config->bIsAdditiveCurve)
+				: RootMotionEditorStatics::BakeRootBoneToCurve(AnimSequence, Config->SampleRate, Config->ExtractChannels, Config->bIsAdditiveCurve);
+			ReplaceCurveData(Curve, LOCTEXT("LoadAnimChange", "Load From Anim"));
+		}
+		else if (Config->ExtractMode == ERMEBoneExtractMode::GroundProjectedPelvis)
+		{
+			const FName PelvisBoneName = Config->GroundProjection.PelvisBoneName;
+			if (PelvisBoneName.IsNone() || !RootMotionEditorStatics::IsValidBoneName(AnimSequence, PelvisBoneName))
+			{
+				FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("InvalidAnimData", "Load bone name ({0}) is invalid from the anim({1})."), FText::FromString(PelvisBoneName.ToString()), FText::FromString(GetNameSafe(AnimSequence))));
+				return;
 			}
 
-			ClearEditorAllCurves();
+			if (!ConfirmDiscardEditedCurve(DiscardQuestion))
+			{
+				return;
+			}
 
-			URMECurveContainer* CurveDataPtr = GetCurveContainer();
-			const FTransformCurve& Curve = RootMotionEditorStatics::BakeRootBoneToCurve(AnimSequence, Config->SampleRate, Config->ExtractChannels, Config->bIsAdditiveCurve);
-			CurveDataPtr->CopyCurveData(Curve);
-			AddNewCurve(CurveDataPtr);
+			FTransformCurve Curve;
+			if (!RMEGroundProjection::BakePelvisToCurve(AnimSequence, Config->GroundProjection, Config->ExtractChannels, Config->bIsAdditiveCurve, Curve))
+			{
+				FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GroundProjectionFailed", "Failed to project the pelvis on the ground, see the output log."));
+				return;
+			}
 
-			OnLoadCurveDataCompleted.Broadcast();
+			ReplaceCurveData(Curve, LOCTEXT("LoadAnimChange", "Load From Anim"));
+			LoadedPelvisBoneName = PelvisBoneName;
 		}
 	}
 }
 
 void FRMECurveEditor::SaveToExternalAnimData()
 {
-	FRMEContext* Context = FRMEContext::Get();
+	FRMEContext* Context = GetContext();
 	const FTransformCurve* CurveData = Context ? Context->GetRootMotionTransformCurve() : nullptr;
 	if (!bHasCurveEdited || !CurveData)
 	{
@@ -698,11 +1386,90 @@ void FRMECurveEditor::SaveToExternalAnimData()
 		}
 	}
 
-	RootMotionEditorStatics::OverrideAnimBoneMotion(AnimSequence, *CurveData, CustomBoneToSave);
+	Context->NotifyAnimationModified(AnimSequence);
+	if (!bIsCustomSave && !LoadedPelvisBoneName.IsNone())
+	{
+		// The motion was loaded from the pelvis, it's moved to the root instead of added to it, whatever the settings are now.
+		if (!RMEGroundProjection::OverrideRootMotion(AnimSequence, *CurveData, LoadedPelvisBoneName))
+		{
+			FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GroundProjectionSaveFailed", "Failed to move the motion of the pelvis to the root, see the output log."));
+			return;
+		}
+	}
+	else
+	{
+		RootMotionEditorStatics::OverrideAnimBoneMotion(AnimSequence, *CurveData, CustomBoneToSave);
+	}
 
 	AnimSequence->MarkPackageDirty();
 }
 
 #pragma endregion Anim Asset
 
+#pragma region Library
+
+bool FRMECurveEditor::HasLibraryEntry() const
+{
+	TSharedPtr<SRMEAssetsSelector> Selector = RootMotionEditorStatics::GetTabWidget<SRMEAssetsSelector>(WeakTabManager.Pin().Get(), SRMEAssetsSelector::TabName);
+	URMEAssetCollection* AssetCollection = Selector ? Selector->GetAssetCollection() : nullptr;
+	return AssetCollection ? !AssetCollection->GetLibraryEntryName().IsNone() : false;
+}
+
+void FRMECurveEditor::LoadFromLibrary()
+{
+	TSharedPtr<SRMEAssetsSelector> Selector = RootMotionEditorStatics::GetTabWidget<SRMEAssetsSelector>(WeakTabManager.Pin().Get(), SRMEAssetsSelector::TabName);
+	URMEAssetCollection* AssetCollection = Selector ? Selector->GetAssetCollection() : nullptr;
+	const FName EntryName = AssetCollection ? AssetCollection->GetLibraryEntryName() : NAME_None;
+	if (EntryName.IsNone())
+	{
+		return;
+	}
+
+	if (!AssetCollection->Library->Contains(EntryName))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("MissingLibraryEntry", "Not found the entry ({0}) in the library ({1})."), FText::FromName(EntryName), FText::FromString(GetNameSafe(AssetCollection->Library))));
+		return;
+	}
+
+	if (!ConfirmDiscardEditedCurve(LOCTEXT("HasEditedCurveLibrary", "You have already edited the curve. Are you sure you want to discard it and load the library entry ?")))
+	{
+		return;
+	}
+
+	FTransformCurve Curve;
+	if (!AssetCollection->Library->ReadEntry(EntryName, Curve))
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, FText::Format(LOCTEXT("InvalidLibraryEntry", "The entry ({0}) of the library can't be read, see the output log."), FText::FromName(EntryName)));
+		return;
+	}
+
+	ReplaceCurveData(Curve, LOCTEXT("LoadLibraryChange", "Load From Library"));
+}
+
+void FRMECurveEditor::SaveToLibrary()
+{
+	TSharedPtr<SRMEAssetsSelector> Selector = RootMotionEditorStatics::GetTabWidget<SRMEAssetsSelector>(WeakTabManager.Pin().Get(), SRMEAssetsSelector::TabName);
+	URMEAssetCollection* AssetCollection = Selector ? Selector->GetAssetCollection() : nullptr;
+	const FName EntryName = AssetCollection ? AssetCollection->GetLibraryEntryName() : NAME_None;
+	URMECurveContainer* CurveDataPtr = GetCurveContainer();
+	const FTransformCurve* CurveData = CurveDataPtr ? CurveDataPtr->GetCurveData() : nullptr;
+	if (EntryName.IsNone() || CurveData == nullptr)
+	{
+		return;
+	}
+
+	if (AssetCollection->Library->Contains(EntryName))
+	{
+		const EAppReturnType::Type Choice = FMessageDialog::Open(EAppMsgType::YesNo, FText::Format(LOCTEXT("OverrideLibraryEntry", "It will override the entry ({0}) of the library. Are you sure ?"), FText::FromName(EntryName)));
+		if (Choice == EAppReturnType::No)
+		{
+			return;
+		}
+	}
+
+	AssetCollection->Library->WriteEntry(EntryName, *CurveData);
+}
+
+#pragma endregion Library
+
 #undef LOCTEXT_NAMESPACE
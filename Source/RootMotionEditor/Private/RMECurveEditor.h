@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "CurveEditorTypes.h"
+#include "RMECurveHistory.h"
+#include "RMECurveOperations.h"
 #include "RMETypes.h"
 #include "Tree/ICurveEditorTreeItem.h"
 #include "UObject/Object.h"
@@ -9,7 +11,8 @@
 struct FRMECurveEditorTreeItem : public ICurveEditorTreeItem, TSharedFromThis<FRMECurveEditorTreeItem>
 {
 public:
-	FRMECurveEditorTreeItem(TWeakObjectPtr<UObject> InCurveOwner, FRichCurve* InCurveToEdit, FText InCurveName, FLinearColor InCurveColor);
+	FRMECurveEditorTreeItem(TWeakObjectPtr<UObject> InCurveOwner, FRichCurve* InCurveToEdit, FText InCurveName, FLinearColor InCurveColor,
+		FSimpleDelegate InOnCurveModified = FSimpleDelegate());
 
 	
 	virtual TSharedPtr<SWidget> GenerateCurveEditorTreeWidget(const FName& InColumnName, TWeakPtr<FCurveEditor> InCurveEditor,
@@ -19,11 +22,21 @@ public:
 
 	virtual bool PassesFilter(const FCurveEditorTreeFilter* InFilter) const override;
 
+private:
+	bool MatchesTerm(const struct FCurveEditorTreeTextFilterTerm& Term) const;
+
 private:
 	TWeakObjectPtr<UObject> CurveOwner;
 	FRichCurve* CurveToEdit;
 	FText CurveName;
 	FLinearColor CurveColor;
+	/** Called after the curve editor changed the keys. */
+	FSimpleDelegate OnCurveModified;
+
+	/** Built once, so filtering doesn't convert the name on every keystroke. */
+	FString DisplayString;
+	/** DisplayString split on '.', child first. Copies, so they stay valid whatever happens to DisplayString. */
+	TArray<FString, TInlineAllocator<2>> DisplayTokens;
 };
 
 
@@ -37,6 +50,10 @@ public:
 	void Initialize();
 	void OnDestroy();
 
+	/** The session whose curve container is edited. */
+	void SetContext(const TSharedPtr<class FRMEContext>& InContext);
+	class FRMEContext* GetContext() const;
+
 	void RegisterTabSpawner(const TSharedPtr<class FTabManager>& TabManager);
 	void RegisterConfigTabSpawner(const TSharedPtr<class FTabManager>& TabManager);
 
@@ -45,12 +62,48 @@ public:
 	static FText GetBoneMessage(bool bIsCustomBone);
 	void OnFinishedChangingProperties(const FPropertyChangedEvent& ChangedEvent);
 	bool AddPreviewKey(ERMEPreviewEditMode EditMode, float Time, const FTransform& Transform);
+
+	SIZE_T GetHistoryAllocatedSize() const { return History.GetAllocatedSize(); }
 	
 protected:
 	void AddNewCurve(class URMECurveContainer* Container);
+	/**
+	 * Keep the existing tree items and curve models, only tell the curve editor the keys have changed.
+	 * Zoom to fit only for a loaded curve, edits and previews keep the view the user set.
+	 */
+	void RefreshEditorCurves(class URMECurveContainer* Container, bool bZoomToFit = false);
 	void ClearAllCurves();
 	void ClearEditorAllCurves();
+
+	bool CanUndoCurveChange() const;
+	bool CanRedoCurveChange() const;
+	void UndoCurveChange();
+	void RedoCurveChange();
+
+	/** Keys between the first and last selected key, or all the keys when nothing is selected. */
+	FRMECurveOperationRange GetCurveOperationRange() const;
+	bool CanApplyCurveOperation() const;
+	/** The seam only makes sense when the previewed animation loops. */
+	bool CanSolveLoopSeam() const;
+	void ApplyCurveOperation(const FText& Description, TFunctionRef<void(FTransformCurve&, const FRMECurveOperationRange&)> Operation);
+
+	/** Smooth the channels picked in the settings over the reshape range, or keep the previewed keys. */
+	void ApplyCurveFilter();
+	/**
+	 * While previewing, the curve shows the filtered keys and follows every change of the smoothing settings.
+	 * Applying keeps them as one undoable change, stopping the preview or another operation puts the keys back. Keys
+	 * moved in the curve editor during the preview end it and keep the filtered keys with the edit.
+	 */
+	bool IsFilterPreviewActive() const { return FilterPreviewSource.IsSet(); }
+	void ToggleFilterPreview();
+	void UpdateFilterPreview();
+	/** Put the keys back as they were before the preview. */
+	void CancelFilterPreview();
+	/** Leave the keys as they are and drop the change the preview began. */
+	void StopFilterPreview();
+	/** Export or import the edited curve as a binary or CSV file, picked in a file dialog. */
 	void SaveCurveData();
+	void LoadCurveData();
 
 	bool CanEditCurve() const;
 	
@@ -61,22 +114,40 @@ protected:
 	bool HasExternalAnim() const;
 	void LoadExternalAnimData();
 	void SaveToExternalAnimData();
+
+	bool HasLibraryEntry() const;
+	void LoadFromLibrary();
+	void SaveToLibrary();
 	
 	
 private:
 	TSharedRef<SWidget> CreateToolbar();
 	TSharedRef<SWidget> CreateCurveEditorToolbar();
+	TSharedRef<SWidget> MakeCurveOperationsMenu();
+	TSharedRef<SWidget> MakeCurveFiltersMenu();
 	void CreateDefaultCurves();
 	void SetupCurveEditor();
 
 	URMECurveContainer* GetCurveContainer() const;
 	
+	/** Bracket an operation on the container keys so it can be undone. */
+	void BeginCurveChange();
+	void EndCurveChange(const FText& Description);
+	/** The keys were changed in the curve editor, the history can't undo past a change it didn't record. */
+	void OnCurveModelModified();
+
+	/** Ask before a load replaces a curve the user edited, true if it can be replaced. */
+	bool ConfirmDiscardEditedCurve(const FText& Question) const;
+	/** Replace the keys with the loaded ones as one undoable change and refresh the editor. */
+	void ReplaceCurveData(const FTransformCurve& InCurve, const FText& Description);
+
 	void AddNewCurveInternal(FVectorCurve& CurveData, UObject* CurveOwner, const FString& ChannelName);
 	static void UpdateOrAddVectorCurveKeys(FVectorCurve& CurveData, float Time, const FVector& Value);
 
 	
 private:
 	TWeakPtr<FTabManager> WeakTabManager;
+	TWeakPtr<class FRMEContext> ContextPtr;
 	
 	TSharedPtr<class FCurveEditor> CurveEditor;
 	TSharedPtr<class SCurveEditorPanel> CurveEditorPanel;
@@ -89,6 +160,15 @@ private:
 	TSharedPtr<IDetailsView> ConfigWidget;
 	TObjectPtr<class URMECurveEditorConfig> Config = nullptr;
 
+	FRMECurveHistory History;
+
+	/** Keys before the previewed filter, set while the preview is on. */
+	TOptional<FTransformCurve> FilterPreviewSource;
+	FRMECurveOperationRange FilterPreviewRange;
+
+	/** Set when the keys were projected from this pelvis, the write back then moves the motion out of it. */
+	FName LoadedPelvisBoneName;
+
 	bool bHasCurveEdited = false;
 	bool bIsSetCustomBone = false;
 	bool bHasEditorCurves = false;
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurveEditorModel.h"
+#include "CurveEditorScreenSpace.h"
+#include "Algo/BinarySearch.h"
+
+
+FRMERichCurveEditorModel::FRMERichCurveEditorModel(FRichCurve* InRichCurve, UObject* InOwner)
+	: FRichCurveEditorModelRaw(InRichCurve, InOwner)
+{
+}
+
+void FRMERichCurveEditorModel::DrawCurve(const FCurveEditor& CurveEditor, const FCurveEditorScreenSpace& ScreenSpace, TArray<TTuple<double, double>>& OutInterpolatingPoints) const
+{
+	// The base model only interpolates between the keys inside the view, but still outputs every one of them.
+	FRichCurveEditorModelRaw::DrawCurve(CurveEditor, ScreenSpace, OutInterpolatingPoints);
+	DecimateToPixels(ScreenSpace, OutInterpolatingPoints);
+}
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
+void FRMERichCurveEditorModel::GetKeys(double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const
+{
+	GetKeysInRange(MinTime, MaxTime, MinValue, MaxValue, OutKeyHandles);
+}
+#else
+void FRMERichCurveEditorModel::GetKeys(const SCurveEditorView& CurveEditor, double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const
+{
+	GetKeysInRange(MinTime, MaxTime, MinValue, MaxValue, OutKeyHandles);
+}
+#endif
+
+void FRMERichCurveEditorModel::GetKeysInRange(double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const
+{
+	if (!IsValid())
+	{
+		return;
+	}
+
+	const FRichCurve& Curve = GetReadOnlyRichCurve();
+	const TArray<FRichCurveKey>& Keys = Curve.GetConstRefOfKeys();
+
+	// Keys are sorted by time, skip straight to the first one in range instead of testing them all.
+	const int32 FirstIndex = Algo::LowerBoundBy(Keys, MinTime, [](const FRichCurveKey& Key) { return static_cast<double>(Key.Time); });
+	for (int32 Index = FirstIndex; Index < Keys.Num() && Keys[Index].Time <= MaxTime; ++Index)
+	{
+		const double Value = Keys[Index].Value;
+		if (Value >= MinValue && Value <= MaxValue)
+		{
+			OutKeyHandles.Add(Curve.GetKeyHandle(Index));
+		}
+	}
+}
+
+void FRMERichCurveEditorModel::DecimateToPixels(const FCurveEditorScreenSpace& ScreenSpace, TArray<TTuple<double, double>>& InOutPoints)
+{
+	// Four points per column draws the same envelope as the full polyline, nothing to gain below that.
+	const int32 NumColumns = FMath::Max(1, FMath::CeilToInt32(ScreenSpace.GetPhysicalWidth()));
+	if (InOutPoints.Num() <= NumColumns * 4)
+	{
+		return;
+	}
+
+	int32 NumOutPoints = 0;
+	int32 ColumnStart = 0;
+	while (ColumnStart < InOutPoints.Num())
+	{
+		const int32 Column = FMath::FloorToInt32(ScreenSpace.SecondsToScreen(InOutPoints[ColumnStart].Get<0>()));
+
+		int32 ColumnEnd = ColumnStart + 1;
+		int32 MinIndex = ColumnStart;
+		int32 MaxIndex = ColumnStart;
+		while (ColumnEnd < InOutPoints.Num() && FMath::FloorToInt32(ScreenSpace.SecondsToScreen(InOutPoints[ColumnEnd].Get<0>())) == Column)
+		{
+			if (InOutPoints[ColumnEnd].Get<1>() < InOutPoints[MinIndex].Get<1>())
+			{
+				MinIndex = ColumnEnd;
+			}
+			if (InOutPoints[ColumnEnd].Get<1>() > InOutPoints[MaxIndex].Get<1>())
+			{
+				MaxIndex = ColumnEnd;
+			}
+			++ColumnEnd;
+		}
+
+		// Points are compacted in place, the write cursor never passes the read cursor.
+		const int32 LastIndex = ColumnEnd - 1;
+		int32 Kept[4] = { ColumnStart, FMath::Min(MinIndex, MaxIndex), FMath::Max(MinIndex, MaxIndex), LastIndex };
+		int32 PreviousKept = INDEX_NONE;
+		for (const int32 Index : Kept)
+		{
+			if (Index != PreviousKept)
+			{
+				InOutPoints[NumOutPoints++] = InOutPoints[Index];
+				PreviousKept = Index;
+			}
+		}
+
+		ColumnStart = ColumnEnd;
+	}
+
+	InOutPoints.SetNum(NumOutPoints);
+}
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RichCurveEditorModel.h"
+
+/**
+ * Curve model for the dense curves baked from animations.
+ * Keys are looked up by binary search so only the visible ones are gathered, and the interpolated polyline is
+ * decimated to at most a few points per pixel column. Key handles, positions and edits go through the base model untouched.
+ */
+class FRMERichCurveEditorModel : public FRichCurveEditorModelRaw
+{
+public:
+	FRMERichCurveEditorModel(FRichCurve* InRichCurve, UObject* InOwner);
+
+	virtual void DrawCurve(const FCurveEditor& CurveEditor, const FCurveEditorScreenSpace& ScreenSpace, TArray<TTuple<double, double>>& OutInterpolatingPoints) const override;
+
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
+	virtual void GetKeys(double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const override;
+#else
+	virtual void GetKeys(const SCurveEditorView& CurveEditor, double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const override;
+#endif
+
+private:
+	void GetKeysInRange(double MinTime, double MaxTime, double MinValue, double MaxValue, TArray<FKeyHandle>& OutKeyHandles) const;
+
+	/** Keep the first, lowest, highest and last point of every pixel column, in time order. */
+	static void DecimateToPixels(const FCurveEditorScreenSpace& ScreenSpace, TArray<TTuple<double, double>>& InOutPoints);
+};
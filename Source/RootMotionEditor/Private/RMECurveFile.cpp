@@ -0,0 +1,544 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurveFile.h"
+#include "RMECurveHistory.h"
+#include "RMETypes.h"
+#include "Algo/IsSorted.h"
+#include "Algo/StableSort.h"
+#include "Animation/AnimCurveTypes.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace RMECurveFile
+{
+	static constexpr uint32 BinaryMagic = 0x43454D52; // "RMEC"
+	/** Bumped when the layout changes, files of another version don't load. */
+	static constexpr uint16 BinaryVersion = 1;
+	static constexpr int32 NumChannels = FRMECurveHistory::NumChannels;
+	/** Keys converted and written at once. */
+	static constexpr int32 ChunkSize = 1024;
+	/** The CSV buffer is flushed to the file once it's past this length. */
+	static constexpr int32 CsvFlushLength = 32 * 1024;
+	/** Bytes of CSV read from the file at once. */
+	static constexpr int32 CsvReadLength = 64 * 1024;
+
+	static const TCHAR* ChannelNames[NumChannels] =
+	{
+		TEXT("Translation.X"), TEXT("Translation.Y"), TEXT("Translation.Z"),
+		TEXT("Rotation.X"), TEXT("Rotation.Y"), TEXT("Rotation.Z"),
+		TEXT("Scale.X"), TEXT("Scale.Y"), TEXT("Scale.Z"),
+	};
+
+	struct FChannelHeader
+	{
+		uint64 KeyOffset;
+		uint32 NumKeys;
+		float DefaultValue;
+		uint8 PreInfinityExtrap;
+		uint8 PostInfinityExtrap;
+		uint8 Padding[6];
+	};
+
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint16 Version;
+		uint16 KeySize;
+		uint32 NumChannels;
+		uint32 Reserved;
+		FChannelHeader Channels[RMECurveFile::NumChannels];
+	};
+
+	struct FFileKey
+	{
+		float Time;
+		float Value;
+		float ArriveTangent;
+		float LeaveTangent;
+		float ArriveTangentWeight;
+		float LeaveTangentWeight;
+		uint8 InterpMode;
+		uint8 TangentMode;
+		uint8 TangentWeightMode;
+		uint8 Padding;
+	};
+
+	static_assert(sizeof(FChannelHeader) == 24, "The channel header is part of the file format.");
+	static_assert(sizeof(FFileKey) == 28, "The key record is part of the file format.");
+
+	static FFileKey ToFileKey(const FRichCurveKey& InKey)
+	{
+		FFileKey Key;
+		Key.Time = InKey.Time;
+		Key.Value = InKey.Value;
+		Key.ArriveTangent = InKey.ArriveTangent;
+		Key.LeaveTangent = InKey.LeaveTangent;
+		Key.ArriveTangentWeight = InKey.ArriveTangentWeight;
+		Key.LeaveTangentWeight = InKey.LeaveTangentWeight;
+		Key.InterpMode = static_cast<uint8>(InKey.InterpMode);
+		Key.TangentMode = static_cast<uint8>(InKey.TangentMode);
+		Key.TangentWeightMode = static_cast<uint8>(InKey.TangentWeightMode);
+		Key.Padding = 0;
+		return Key;
+	}
+
+	/** False for a byte that isn't a value of the enum, the curve evaluation switches on these. */
+	template<typename EnumType>
+	static bool IsValidEnumByte(uint8 InValue)
+	{
+		const UEnum* Enum = StaticEnum<EnumType>();
+		return InValue < Enum->GetMaxEnumValue() && Enum->IsValidEnumValue(InValue);
+	}
+
+	static bool IsValidKey(const FFileKey& InKey)
+	{
+		return IsValidEnumByte<ERichCurveInterpMode>(InKey.InterpMode) && IsValidEnumByte<ERichCurveTangentMode>(InKey.TangentMode)
+			&& IsValidEnumByte<ERichCurveTangentWeightMode>(InKey.TangentWeightMode);
+	}
+
+	static FRichCurveKey ToCurveKey(const FFileKey& InKey)
+	{
+		FRichCurveKey Key(InKey.Time, InKey.Value, InKey.ArriveTangent, InKey.LeaveTangent, static_cast<ERichCurveInterpMode>(InKey.InterpMode));
+		Key.TangentMode = static_cast<ERichCurveTangentMode>(InKey.TangentMode);
+		Key.TangentWeightMode = static_cast<ERichCurveTangentWeightMode>(InKey.TangentWeightMode);
+		Key.ArriveTangentWeight = InKey.ArriveTangentWeight;
+		Key.LeaveTangentWeight = InKey.LeaveTangentWeight;
+		return Key;
+	}
+
+	static int32 FindChannel(FStringView InName)
+	{
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			if (InName.Equals(ChannelNames[Channel], ESearchCase::IgnoreCase))
+			{
+				return Channel;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	static bool ParseFloat(FStringView InField, float& OutValue)
+	{
+		TStringBuilder<64> Field;
+		Field.Append(InField.TrimStartAndEnd());
+		if (Field.Len() == 0)
+		{
+			return false;
+		}
+
+		OutValue = FCString::Atof(*Field);
+		return FMath::IsFinite(OutValue);
+	}
+
+	static int32 ParseInt(FStringView InField)
+	{
+		TStringBuilder<64> Field;
+		Field.Append(InField.TrimStartAndEnd());
+		return FCString::Atoi(*Field);
+	}
+
+	/**
+	 * Call the visitor with every line of a UTF-8 file, the file is read a chunk at a time and only the line being
+	 * visited is converted. False if the file can't be read.
+	 */
+	static bool VisitLines(const FString& InFilename, TFunctionRef<void(FStringView)> Visitor)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFilename));
+		if (!Reader.IsValid())
+		{
+			return false;
+		}
+
+		auto VisitLine = [&Visitor](const uint8* Line, int32 Length)
+		{
+			const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Line), Length);
+			Visitor(FStringView(Converted.Get(), Converted.Length()));
+		};
+
+		// Holds the unfinished line and the chunk read after it, '\n' can't be part of a multibyte character.
+		TArray<uint8> Buffer;
+		int64 RemainingBytes = Reader->TotalSize();
+		bool bIsFirstChunk = true;
+		while (true)
+		{
+			const int32 ReadLength = static_cast<int32>(FMath::Min<int64>(RemainingBytes, CsvReadLength));
+			const int32 ReadOffset = Buffer.Num();
+			Buffer.AddUninitialized(ReadLength);
+			Reader->Serialize(Buffer.GetData() + ReadOffset, ReadLength);
+			if (Reader->IsError())
+			{
+				return false;
+			}
+			RemainingBytes -= ReadLength;
+
+			int32 LineStart = 0;
+			if (bIsFirstChunk && Buffer.Num() >= 3 && Buffer[0] == 0xEF && Buffer[1] == 0xBB && Buffer[2] == 0xBF)
+			{
+				LineStart = 3;
+			}
+			bIsFirstChunk = false;
+
+			for (int32 Index = FMath::Max(ReadOffset, LineStart); Index < Buffer.Num(); ++Index)
+			{
+				if (Buffer[Index] == '\n')
+				{
+					VisitLine(Buffer.GetData() + LineStart, Index - LineStart);
+					LineStart = Index + 1;
+				}
+			}
+
+			if (RemainingBytes <= 0)
+			{
+				if (LineStart < Buffer.Num())
+				{
+					VisitLine(Buffer.GetData() + LineStart, Buffer.Num() - LineStart);
+				}
+				return Reader->Close();
+			}
+			Buffer.RemoveAt(0, LineStart);
+		}
+	}
+
+	static void SortKeys(FRichCurve& InOutChannel)
+	{
+		TArray<FRichCurveKey>& Keys = InOutChannel.Keys;
+		const bool bIsSorted = Algo::IsSortedBy(Keys, &FRichCurveKey::Time);
+		if (!bIsSorted)
+		{
+			Algo::StableSortBy(Keys, &FRichCurveKey::Time);
+		}
+	}
+}
+
+const TCHAR* FRMECurveFile::FileTypes = TEXT("Root Motion Curve (*.rmecurve)|*.rmecurve|CSV (*.csv)|*.csv");
+
+bool FRMECurveFile::IsCsv(const FString& InFilename)
+{
+	return FPaths::GetExtension(InFilename).Equals(TEXT("csv"), ESearchCase::IgnoreCase);
+}
+
+bool FRMECurveFile::Save(const FString& InFilename, const FTransformCurve& InCurve)
+{
+	return IsCsv(InFilename) ? SaveCsv(InFilename, InCurve) : SaveBinary(InFilename, InCurve);
+}
+
+bool FRMECurveFile::Load(const FString& InFilename, FTransformCurve& OutCurve)
+{
+	return IsCsv(InFilename) ? LoadCsv(InFilename, OutCurve) : LoadBinary(InFilename, OutCurve);
+}
+
+bool FRMECurveFile::SaveBinary(const FString& InFilename, const FTransformCurve& InCurve)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMECurveFile::SaveBinary);
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InFilename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Can't open %s for writing."), *InFilename);
+		return false;
+	}
+
+	// The header holds the offset of every channel, so it's complete before the first key is written.
+	RMECurveFile::FFileHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = RMECurveFile::BinaryMagic;
+	Header.Version = RMECurveFile::BinaryVersion;
+	Header.KeySize = sizeof(RMECurveFile::FFileKey);
+	Header.NumChannels = RMECurveFile::NumChannels;
+
+	uint64 KeyOffset = sizeof(RMECurveFile::FFileHeader);
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		const FRichCurve& Curve = FRMECurveHistory::GetChannel(InCurve, Channel);
+		RMECurveFile::FChannelHeader& ChannelHeader = Header.Channels[Channel];
+		ChannelHeader.KeyOffset = KeyOffset;
+		ChannelHeader.NumKeys = Curve.Keys.Num();
+		ChannelHeader.DefaultValue = Curve.DefaultValue;
+		ChannelHeader.PreInfinityExtrap = static_cast<uint8>(Curve.PreInfinityExtrap);
+		ChannelHeader.PostInfinityExtrap = static_cast<uint8>(Curve.PostInfinityExtrap);
+		KeyOffset += static_cast<uint64>(Curve.Keys.Num()) * sizeof(RMECurveFile::FFileKey);
+	}
+	Writer->Serialize(&Header, sizeof(Header));
+
+	TArray<RMECurveFile::FFileKey> Chunk;
+	Chunk.Reserve(RMECurveFile::ChunkSize);
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		const TArray<FRichCurveKey>& Keys = FRMECurveHistory::GetChannel(InCurve, Channel).Keys;
+		for (int32 FirstKey = 0; FirstKey < Keys.Num(); FirstKey += RMECurveFile::ChunkSize)
+		{
+			Chunk.Reset();
+			const int32 LastKey = FMath::Min(FirstKey + RMECurveFile::ChunkSize, Keys.Num());
+			for (int32 Index = FirstKey; Index < LastKey; ++Index)
+			{
+				Chunk.Add(RMECurveFile::ToFileKey(Keys[Index]));
+			}
+			Writer->Serialize(Chunk.GetData(), Chunk.Num() * sizeof(RMECurveFile::FFileKey));
+		}
+	}
+
+	if (!Writer->Close())
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Failed to write %s."), *InFilename);
+		return false;
+	}
+	return true;
+}
+
+bool FRMECurveFile::LoadBinary(const FString& InFilename, FTransformCurve& OutCurve)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMECurveFile::LoadBinary);
+
+	// The keys are decoded straight from the mapped file, the file isn't copied into memory first.
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedFile;
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 3
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*InFilename);
+	if (OpenResult.HasValue())
+	{
+		MappedFile = OpenResult.StealValue();
+	}
+#else
+	MappedFile.Reset(PlatformFile.OpenMapped(*InFilename));
+#endif
+
+	// Declared after the handle, the region is unmapped first.
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+	if (MappedRegion.IsValid() && MappedRegion->GetMappedSize() <= MAX_int32)
+	{
+		return DecodeBinary(TConstArrayView<uint8>(MappedRegion->GetMappedPtr(), static_cast<int32>(MappedRegion->GetMappedSize())), InFilename, OutCurve);
+	}
+
+	// Not every platform file can map files.
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *InFilename))
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Can't read %s."), *InFilename);
+		return false;
+	}
+	return DecodeBinary(Bytes, InFilename, OutCurve);
+}
+
+bool FRMECurveFile::DecodeBinary(TConstArrayView<uint8> InBytes, const FString& InFilename, FTransformCurve& OutCurve)
+{
+	RMECurveFile::FFileHeader Header;
+	if (InBytes.Num() < static_cast<int32>(sizeof(Header)))
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("%s isn't a root motion curve file."), *InFilename);
+		return false;
+	}
+
+	// Copied out, the mapped bytes have no alignment guarantee.
+	FMemory::Memcpy(&Header, InBytes.GetData(), sizeof(Header));
+	if (Header.Magic != RMECurveFile::BinaryMagic)
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("%s isn't a root motion curve file."), *InFilename);
+		return false;
+	}
+	if (Header.Version != RMECurveFile::BinaryVersion || Header.KeySize != sizeof(RMECurveFile::FFileKey) || Header.NumChannels != RMECurveFile::NumChannels)
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("%s has version %d, only version %d can be read."), *InFilename, Header.Version, RMECurveFile::BinaryVersion);
+		return false;
+	}
+
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		const RMECurveFile::FChannelHeader& ChannelHeader = Header.Channels[Channel];
+		// Checked one after the other, the offset is read from the file and adding the key bytes to it could wrap.
+		const uint64 FileSize = static_cast<uint64>(InBytes.Num());
+		if (ChannelHeader.KeyOffset < sizeof(Header) || ChannelHeader.KeyOffset > FileSize
+			|| ChannelHeader.NumKeys > (FileSize - ChannelHeader.KeyOffset) / sizeof(RMECurveFile::FFileKey))
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("The keys of %s in %s are out of the file, it's truncated or corrupted."), RMECurveFile::ChannelNames[Channel], *InFilename);
+			return false;
+		}
+		if (!RMECurveFile::IsValidEnumByte<ERichCurveExtrapolation>(ChannelHeader.PreInfinityExtrap)
+			|| !RMECurveFile::IsValidEnumByte<ERichCurveExtrapolation>(ChannelHeader.PostInfinityExtrap))
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("The extrapolation of %s in %s is invalid, the file is corrupted."), RMECurveFile::ChannelNames[Channel], *InFilename);
+			return false;
+		}
+	}
+
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		const RMECurveFile::FChannelHeader& ChannelHeader = Header.Channels[Channel];
+		FRichCurve& Curve = FRMECurveHistory::GetChannel(OutCurve, Channel);
+		Curve.DefaultValue = ChannelHeader.DefaultValue;
+		Curve.PreInfinityExtrap = static_cast<ERichCurveExtrapolation>(ChannelHeader.PreInfinityExtrap);
+		Curve.PostInfinityExtrap = static_cast<ERichCurveExtrapolation>(ChannelHeader.PostInfinityExtrap);
+
+		const uint8* KeyData = InBytes.GetData() + ChannelHeader.KeyOffset;
+		Curve.Keys.Reset(ChannelHeader.NumKeys);
+		for (uint32 Index = 0; Index < ChannelHeader.NumKeys; ++Index)
+		{
+			RMECurveFile::FFileKey Key;
+			FMemory::Memcpy(&Key, KeyData + Index * sizeof(RMECurveFile::FFileKey), sizeof(Key));
+			if (!RMECurveFile::IsValidKey(Key))
+			{
+				UE_LOG(LogRootMotionEditor, Error, TEXT("Key %u of %s in %s has an invalid interpolation or tangent mode, the file is corrupted."), Index, RMECurveFile::ChannelNames[Channel], *InFilename);
+				return false;
+			}
+			Curve.Keys.Add(RMECurveFile::ToCurveKey(Key));
+		}
+		RMECurveFile::SortKeys(Curve);
+	}
+	return true;
+}
+
+bool FRMECurveFile::SaveCsv(const FString& InFilename, const FTransformCurve& InCurve)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMECurveFile::SaveCsv);
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*InFilename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Can't open %s for writing."), *InFilename);
+		return false;
+	}
+
+	// Grows once to the flush length, then its memory is reused.
+	TStringBuilder<1024> Buffer;
+	auto Flush = [&Buffer, &Writer]()
+	{
+		const FTCHARToUTF8 Utf8(Buffer.GetData(), Buffer.Len());
+		Writer->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+		Buffer.Reset();
+	};
+
+	Buffer << TEXT("Channel,Time,Value,ArriveTangent,LeaveTangent,ArriveTangentWeight,LeaveTangentWeight,InterpMode,TangentMode,TangentWeightMode\n");
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		for (const FRichCurveKey& Key : FRMECurveHistory::GetChannel(InCurve, Channel).Keys)
+		{
+			// 9 significant digits round trip a float.
+			Buffer.Appendf(TEXT("%s,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%d,%d,%d\n"), RMECurveFile::ChannelNames[Channel],
+				Key.Time, Key.Value, Key.ArriveTangent, Key.LeaveTangent, Key.ArriveTangentWeight, Key.LeaveTangentWeight,
+				static_cast<int32>(Key.InterpMode), static_cast<int32>(Key.TangentMode), static_cast<int32>(Key.TangentWeightMode));
+
+			if (Buffer.Len() >= RMECurveFile::CsvFlushLength)
+			{
+				Flush();
+			}
+		}
+	}
+	Flush();
+
+	if (!Writer->Close())
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Failed to write %s."), *InFilename);
+		return false;
+	}
+	return true;
+}
+
+bool FRMECurveFile::LoadCsv(const FString& InFilename, FTransformCurve& OutCurve)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMECurveFile::LoadCsv);
+
+	FTransformCurve Curve;
+	bool bNeedsTangents[RMECurveFile::NumChannels] = {};
+	int32 LineNumber = 0;
+	FString Error;
+
+	const bool bLoaded = RMECurveFile::VisitLines(InFilename, [&](FStringView Line)
+	{
+		++LineNumber;
+		Line = Line.TrimStartAndEnd();
+		if (!Error.IsEmpty() || Line.IsEmpty())
+		{
+			return;
+		}
+
+		TArray<FStringView, TInlineAllocator<10>> Fields;
+		int32 FieldStart = 0;
+		for (int32 Index = 0; Index <= Line.Len(); ++Index)
+		{
+			if (Index == Line.Len() || Line[Index] == TEXT(','))
+			{
+				Fields.Add(Line.Mid(FieldStart, Index - FieldStart));
+				FieldStart = Index + 1;
+			}
+		}
+
+		// Header row.
+		if (Fields[0].TrimStartAndEnd().Equals(TEXT("Channel"), ESearchCase::IgnoreCase))
+		{
+			return;
+		}
+
+		const int32 Channel = RMECurveFile::FindChannel(Fields[0].TrimStartAndEnd());
+		if (Channel == INDEX_NONE)
+		{
+			Error = FString::Printf(TEXT("line %d, unknown channel (%s)"), LineNumber, *FString(Fields[0]));
+			return;
+		}
+
+		float Time = 0.f;
+		float Value = 0.f;
+		if (Fields.Num() < 3 || !RMECurveFile::ParseFloat(Fields[1], Time) || !RMECurveFile::ParseFloat(Fields[2], Value))
+		{
+			Error = FString::Printf(TEXT("line %d, expected Channel,Time,Value"), LineNumber);
+			return;
+		}
+
+		FRichCurveKey Key(Time, Value);
+		if (Fields.Num() >= 10)
+		{
+			float Tangents[4];
+			for (int32 Index = 0; Index < 4; ++Index)
+			{
+				if (!RMECurveFile::ParseFloat(Fields[3 + Index], Tangents[Index]))
+				{
+					Error = FString::Printf(TEXT("line %d, invalid tangent"), LineNumber);
+					return;
+				}
+			}
+			Key.ArriveTangent = Tangents[0];
+			Key.LeaveTangent = Tangents[1];
+			Key.ArriveTangentWeight = Tangents[2];
+			Key.LeaveTangentWeight = Tangents[3];
+			Key.InterpMode = static_cast<ERichCurveInterpMode>(FMath::Clamp(RMECurveFile::ParseInt(Fields[7]), 0, static_cast<int32>(RCIM_None)));
+			Key.TangentMode = static_cast<ERichCurveTangentMode>(FMath::Clamp(RMECurveFile::ParseInt(Fields[8]), 0, static_cast<int32>(RCTM_None)));
+			Key.TangentWeightMode = static_cast<ERichCurveTangentWeightMode>(FMath::Clamp(RMECurveFile::ParseInt(Fields[9]), 0, static_cast<int32>(RCTWM_WeightedBoth)));
+		}
+		else
+		{
+			Key.InterpMode = RCIM_Cubic;
+			Key.TangentMode = RCTM_Auto;
+			bNeedsTangents[Channel] = true;
+		}
+
+		FRMECurveHistory::GetChannel(Curve, Channel).Keys.Add(Key);
+	});
+
+	if (!bLoaded)
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Can't read %s."), *InFilename);
+		return false;
+	}
+	if (!Error.IsEmpty())
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Failed to import %s: %s."), *InFilename, *Error);
+		return false;
+	}
+
+	for (int32 Channel = 0; Channel < RMECurveFile::NumChannels; ++Channel)
+	{
+		FRichCurve& ChannelCurve = FRMECurveHistory::GetChannel(Curve, Channel);
+		RMECurveFile::SortKeys(ChannelCurve);
+		if (bNeedsTangents[Channel])
+		{
+			ChannelCurve.AutoSetTangents();
+		}
+	}
+
+	OutCurve = MoveTemp(Curve);
+	return true;
+}
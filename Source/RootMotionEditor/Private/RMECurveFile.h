@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTransformCurve;
+
+/**
+ * Export and import of the edited transform curve, for backups and external tools.
+ * Keys are written channel after channel through a small reused buffer, and CSV files are read a chunk at a time,
+ * nothing holds the whole text in memory. Binary files are memory mapped instead.
+ *
+ * Binary (.rmecurve), little endian, laid out so it can be memory mapped and read in place:
+ *   header		Magic "RMEC", Version, KeySize, NumChannels, then per channel KeyOffset, NumKeys, DefaultValue and extrapolations
+ *   keys		per channel, NumKeys records of KeySize bytes at KeyOffset: Time, Value, ArriveTangent, LeaveTangent,
+ *				ArriveTangentWeight, LeaveTangentWeight (float), InterpMode, TangentMode, TangentWeightMode (uint8), padding
+ *
+ * CSV (.csv), one key per row, channels are named like the curve editor tree (Translation.X ... Scale.Z):
+ *   Channel,Time,Value,ArriveTangent,LeaveTangent,ArriveTangentWeight,LeaveTangentWeight,InterpMode,TangentMode,TangentWeightMode
+ *   Rows with only Channel,Time,Value are accepted, their tangents are computed. The default values and extrapolations
+ *   of the channels aren't part of the CSV.
+ */
+class FRMECurveFile
+{
+public:
+	/** Filter of the file dialogs. */
+	static const TCHAR* FileTypes;
+
+	static bool IsCsv(const FString& InFilename);
+
+	/** The format follows the extension, false if the file can't be written or read, the reason is logged. */
+	static bool Save(const FString& InFilename, const FTransformCurve& InCurve);
+	static bool Load(const FString& InFilename, FTransformCurve& OutCurve);
+
+	static bool SaveBinary(const FString& InFilename, const FTransformCurve& InCurve);
+	static bool LoadBinary(const FString& InFilename, FTransformCurve& OutCurve);
+
+	static bool SaveCsv(const FString& InFilename, const FTransformCurve& InCurve);
+	static bool LoadCsv(const FString& InFilename, FTransformCurve& OutCurve);
+
+private:
+	static bool DecodeBinary(TConstArrayView<uint8> InBytes, const FString& InFilename, FTransformCurve& OutCurve);
+};
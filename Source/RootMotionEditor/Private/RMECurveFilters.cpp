@@ -0,0 +1,341 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurveFilters.h"
+#include "RMECurveHistory.h"
+#include "RMETypes.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Reverse.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Async/ParallelFor.h"
+
+
+namespace RMECurveFilters
+{
+	/** Direct form II transposed, normalized so a0 is 1. */
+	struct FBiquad
+	{
+		double B0 = 1.0;
+		double B1 = 0.0;
+		double B2 = 0.0;
+		double A1 = 0.0;
+		double A2 = 0.0;
+
+		/** Bilinear transform of the analog Butterworth low pass, the cutoff is prewarped so it lands where it's asked. */
+		static FBiquad MakeLowPass(double SampleRate, double CutoffFrequency)
+		{
+			constexpr double Sqrt2 = 1.4142135623730951;
+			const double K = FMath::Tan(UE_DOUBLE_PI * CutoffFrequency / SampleRate);
+			const double Norm = 1.0 / (1.0 + Sqrt2 * K + K * K);
+
+			FBiquad Result;
+			Result.B0 = K * K * Norm;
+			Result.B1 = 2.0 * Result.B0;
+			Result.B2 = Result.B0;
+			Result.A1 = 2.0 * (K * K - 1.0) * Norm;
+			Result.A2 = (1.0 - Sqrt2 * K + K * K) * Norm;
+			return Result;
+		}
+
+		/** One pass in place, the state starts as if the first value had always been the input. */
+		void Run(TArrayView<float> InOutValues) const
+		{
+			const double First = InOutValues[0];
+			double Z1 = (B1 - A1 + B2 - A2) * First;
+			double Z2 = (B2 - A2) * First;
+			for (float& Value : InOutValues)
+			{
+				const double Input = Value;
+				const double Output = B0 * Input + Z1;
+				Z1 = B1 * Input - A1 * Output + Z2;
+				Z2 = B2 * Input - A2 * Output;
+				Value = static_cast<float>(Output);
+			}
+		}
+	};
+
+	/**
+	 * (A^T A)^-1 A^T of the polynomial fit over the window offsets -HalfWindow..HalfWindow, row major with one row per
+	 * power, so the fitted value at offset t is sum over k of t^k * (row k . window values).
+	 */
+	static bool MakeSavitzkyGolayFit(int32 HalfWindow, int32 Order, TArray<double>& OutFit)
+	{
+		const int32 WindowSize = 2 * HalfWindow + 1;
+		const int32 NumTerms = Order + 1;
+		const int32 Stride = NumTerms + WindowSize;
+
+		// The normal matrix with A^T on its right, reduced in place until the left block is the identity.
+		TArray<double, TInlineAllocator<6 * 57>> Matrix;
+		Matrix.SetNumZeroed(NumTerms * Stride);
+		for (int32 Row = 0; Row < NumTerms; ++Row)
+		{
+			for (int32 Offset = -HalfWindow; Offset <= HalfWindow; ++Offset)
+			{
+				const double RowPower = FMath::Pow(static_cast<double>(Offset), static_cast<double>(Row));
+				for (int32 Column = 0; Column < NumTerms; ++Column)
+				{
+					Matrix[Row * Stride + Column] += RowPower * FMath::Pow(static_cast<double>(Offset), static_cast<double>(Column));
+				}
+				Matrix[Row * Stride + NumTerms + Offset + HalfWindow] = RowPower;
+			}
+		}
+
+		for (int32 Pivot = 0; Pivot < NumTerms; ++Pivot)
+		{
+			int32 BestRow = Pivot;
+			for (int32 Row = Pivot + 1; Row < NumTerms; ++Row)
+			{
+				if (FMath::Abs(Matrix[Row * Stride + Pivot]) > FMath::Abs(Matrix[BestRow * Stride + Pivot]))
+				{
+					BestRow = Row;
+				}
+			}
+			if (FMath::Abs(Matrix[BestRow * Stride + Pivot]) < UE_DOUBLE_SMALL_NUMBER)
+			{
+				return false;
+			}
+			for (int32 Column = 0; Column < Stride; ++Column)
+			{
+				Swap(Matrix[Pivot * Stride + Column], Matrix[BestRow * Stride + Column]);
+			}
+
+			const double InvPivot = 1.0 / Matrix[Pivot * Stride + Pivot];
+			for (int32 Column = 0; Column < Stride; ++Column)
+			{
+				Matrix[Pivot * Stride + Column] *= InvPivot;
+			}
+			for (int32 Row = 0; Row < NumTerms; ++Row)
+			{
+				const double Factor = Matrix[Row * Stride + Pivot];
+				if (Row != Pivot && Factor != 0.0)
+				{
+					for (int32 Column = 0; Column < Stride; ++Column)
+					{
+						Matrix[Row * Stride + Column] -= Factor * Matrix[Pivot * Stride + Column];
+					}
+				}
+			}
+		}
+
+		OutFit.SetNumUninitialized(NumTerms * WindowSize);
+		for (int32 Row = 0; Row < NumTerms; ++Row)
+		{
+			FMemory::Memcpy(&OutFit[Row * WindowSize], &Matrix[Row * Stride + NumTerms], WindowSize * sizeof(double));
+		}
+		return true;
+	}
+
+	static void FilterChannel(FRichCurve& InOutChannel, const FRMECurveOperationRange& Range, const FRMECurveFilterSettings& Settings, bool bIsRotation)
+	{
+		TArray<FRichCurveKey>& Keys = InOutChannel.Keys;
+		const int32 FirstKey = Algo::LowerBoundBy(Keys, Range.StartTime, &FRichCurveKey::Time);
+		const int32 NumKeys = Algo::UpperBoundBy(Keys, Range.EndTime, &FRichCurveKey::Time) - FirstKey;
+		if (NumKeys < 3)
+		{
+			return;
+		}
+
+		TArray<float> Times;
+		TArray<float> Values;
+		TArray<float> Unwinds;
+		Times.SetNumUninitialized(NumKeys);
+		Values.SetNumUninitialized(NumKeys);
+		Unwinds.SetNumZeroed(NumKeys);
+		for (int32 Index = 0; Index < NumKeys; ++Index)
+		{
+			Times[Index] = Keys[FirstKey + Index].Time;
+			Values[Index] = Keys[FirstKey + Index].Value;
+		}
+
+		// Euler angles jump by 360 degrees where they wrap, the filters run on the continuous angle and the wraps are
+		// put back after, so the keys around the range still line up.
+		if (bIsRotation)
+		{
+			for (int32 Index = 1; Index < NumKeys; ++Index)
+			{
+				const float Continuous = Values[Index - 1] + FMath::UnwindDegrees(Values[Index] - Values[Index - 1]);
+				Unwinds[Index] = Continuous - Values[Index];
+				Values[Index] = Continuous;
+			}
+		}
+
+		ApplyToValues(Times, Values, Settings);
+
+		for (int32 Index = 0; Index < NumKeys; ++Index)
+		{
+			Keys[FirstKey + Index].Value = Values[Index] - Unwinds[Index];
+		}
+		InOutChannel.AutoSetTangents();
+	}
+
+	void Apply(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, const FRMECurveFilterSettings& Settings)
+	{
+		static constexpr ERMEBoneExtractChannelType ChannelTypes[] = { ERMEBoneExtractChannelType::Translation, ERMEBoneExtractChannelType::Rotation, ERMEBoneExtractChannelType::Scale };
+
+		TArray<int32, TInlineAllocator<FRMECurveHistory::NumChannels>> Channels;
+		for (int32 Channel = 0; Channel < FRMECurveHistory::NumChannels; ++Channel)
+		{
+			if (EnumHasAnyFlags(Settings.Channels, ChannelTypes[Channel / 3]))
+			{
+				Channels.Add(Channel);
+			}
+		}
+
+		// The channels don't share anything, each one is filtered by its own worker.
+		ParallelFor(Channels.Num(), [&InOutCurve, &Range, &Settings, &Channels](int32 Index)
+		{
+			LLM_SCOPE_BYTAG(RootMotionEditor);
+			FilterChannel(FRMECurveHistory::GetChannel(InOutCurve, Channels[Index]), Range, Settings, Channels[Index] / 3 == 1);
+		});
+	}
+
+	void ApplyToValues(TConstArrayView<float> Times, TArrayView<float> InOutValues, const FRMECurveFilterSettings& Settings)
+	{
+		const int32 Num = InOutValues.Num();
+		if (Num < 3)
+		{
+			return;
+		}
+
+		switch (Settings.Type)
+		{
+		case ERMECurveFilterType::Butterworth:
+			{
+				const float Duration = Times[Num - 1] - Times[0];
+				if (Duration > UE_KINDA_SMALL_NUMBER)
+				{
+					Butterworth(InOutValues, (Num - 1) / Duration, Settings.CutoffFrequency);
+				}
+			}
+			break;
+		case ERMECurveFilterType::SavitzkyGolay:
+			SavitzkyGolay(InOutValues, Settings.WindowSize, Settings.PolynomialOrder);
+			break;
+		case ERMECurveFilterType::OneEuro:
+			OneEuro(Times, InOutValues, Settings.MinCutoff, Settings.Beta, Settings.DerivativeCutoff);
+			break;
+		}
+	}
+
+	void Butterworth(TArrayView<float> InOutValues, float SampleRate, float CutoffFrequency)
+	{
+		const int32 Num = InOutValues.Num();
+		if (Num < 3 || SampleRate <= 0.f)
+		{
+			return;
+		}
+
+		// Past the Nyquist frequency the prewarp folds back, keep the cutoff under it.
+		const double Cutoff = FMath::Clamp(static_cast<double>(CutoffFrequency), 1.e-3 * SampleRate, 0.45 * SampleRate);
+		const FBiquad Filter = FBiquad::MakeLowPass(SampleRate, Cutoff);
+
+		// Odd reflection keeps the value and the slope at both ends, the passes don't ring on a step there.
+		const int32 NumPad = FMath::Min(Num - 1, FMath::Max(9, FMath::CeilToInt32(SampleRate / Cutoff)));
+		TArray<float> Padded;
+		Padded.SetNumUninitialized(Num + 2 * NumPad);
+		const float First = InOutValues[0];
+		const float Last = InOutValues[Num - 1];
+		for (int32 Index = 0; Index < NumPad; ++Index)
+		{
+			Padded[Index] = 2.f * First - InOutValues[NumPad - Index];
+			Padded[NumPad + Num + Index] = 2.f * Last - InOutValues[Num - 2 - Index];
+		}
+		FMemory::Memcpy(&Padded[NumPad], InOutValues.GetData(), Num * sizeof(float));
+
+		// Forward then backward, the phase shifts cancel out.
+		Filter.Run(Padded);
+		Algo::Reverse(Padded);
+		Filter.Run(Padded);
+		Algo::Reverse(Padded);
+
+		FMemory::Memcpy(InOutValues.GetData(), &Padded[NumPad], Num * sizeof(float));
+	}
+
+	void SavitzkyGolay(TArrayView<float> InOutValues, int32 WindowSize, int32 PolynomialOrder)
+	{
+		const int32 Num = InOutValues.Num();
+		const int32 HalfWindow = FMath::Min(WindowSize / 2, (Num - 1) / 2);
+		const int32 Order = FMath::Max(PolynomialOrder, 0);
+
+		// A polynomial through every value of the window gives them back unchanged.
+		TArray<double> Fit;
+		if (HalfWindow < 1 || Order >= 2 * HalfWindow || !MakeSavitzkyGolayFit(HalfWindow, Order, Fit))
+		{
+			return;
+		}
+
+		const int32 Window = 2 * HalfWindow + 1;
+		const int32 NumTerms = Order + 1;
+		const TArray<float> Source(InOutValues.GetData(), Num);
+
+		TArray<double, TInlineAllocator<51>> Coefficients;
+		Coefficients.SetNumUninitialized(Window);
+		auto SetCenterOffset = [&Coefficients, &Fit, Window, NumTerms](int32 Offset)
+		{
+			for (int32 Tap = 0; Tap < Window; ++Tap)
+			{
+				double Sum = 0.0;
+				double Power = 1.0;
+				for (int32 Term = 0; Term < NumTerms; ++Term)
+				{
+					Sum += Power * Fit[Term * Window + Tap];
+					Power *= Offset;
+				}
+				Coefficients[Tap] = Sum;
+			}
+		};
+		auto Convolve = [&Coefficients, &Source, Window](int32 WindowStart)
+		{
+			double Sum = 0.0;
+			for (int32 Tap = 0; Tap < Window; ++Tap)
+			{
+				Sum += Coefficients[Tap] * Source[WindowStart + Tap];
+			}
+			return static_cast<float>(Sum);
+		};
+
+		SetCenterOffset(0);
+		for (int32 Index = HalfWindow; Index < Num - HalfWindow; ++Index)
+		{
+			InOutValues[Index] = Convolve(Index - HalfWindow);
+		}
+
+		// The first and last values are read off the polynomial of the first and last full windows.
+		for (int32 Index = 0; Index < HalfWindow; ++Index)
+		{
+			SetCenterOffset(Index - HalfWindow);
+			InOutValues[Index] = Convolve(0);
+			SetCenterOffset(HalfWindow - Index);
+			InOutValues[Num - 1 - Index] = Convolve(Num - Window);
+		}
+	}
+
+	void OneEuro(TConstArrayView<float> Times, TArrayView<float> InOutValues, float MinCutoff, float Beta, float DerivativeCutoff)
+	{
+		if (InOutValues.Num() == 0)
+		{
+			return;
+		}
+
+		auto GetAlpha = [](double Cutoff, double DeltaTime)
+		{
+			const double Tau = 1.0 / (2.0 * UE_DOUBLE_PI * FMath::Max(Cutoff, 1.e-3));
+			return 1.0 / (1.0 + Tau / DeltaTime);
+		};
+
+		double Filtered = InOutValues[0];
+		double FilteredSpeed = 0.0;
+		for (int32 Index = 1; Index < InOutValues.Num(); ++Index)
+		{
+			const double DeltaTime = Times[Index] - Times[Index - 1];
+			if (DeltaTime > UE_DOUBLE_SMALL_NUMBER)
+			{
+				const double Speed = (InOutValues[Index] - Filtered) / DeltaTime;
+				FilteredSpeed += GetAlpha(DerivativeCutoff, DeltaTime) * (Speed - FilteredSpeed);
+				const double Cutoff = MinCutoff + Beta * FMath::Abs(FilteredSpeed);
+				Filtered += GetAlpha(Cutoff, DeltaTime) * (InOutValues[Index] - Filtered);
+			}
+			InOutValues[Index] = static_cast<float>(Filtered);
+		}
+	}
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMECurveOperations.h"
+
+struct FTransformCurve;
+struct FRMECurveFilterSettings;
+
+/**
+ * Smoothing of the edited root motion curve.
+ * The values of the keys in range are copied to one contiguous array per channel, the channels are filtered in
+ * parallel, and only the values and auto tangents are written back: key count and times don't change.
+ */
+namespace RMECurveFilters
+{
+	/** Filter the keys of the range of the channels picked by the settings. */
+	void Apply(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, const FRMECurveFilterSettings& Settings);
+
+	/** Filter one channel of samples with the filter of the settings, the channel mask isn't looked at. */
+	void ApplyToValues(TConstArrayView<float> Times, TArrayView<float> InOutValues, const FRMECurveFilterSettings& Settings);
+
+	/** Second order low pass forward then backward, the ends are padded by odd reflection. */
+	void Butterworth(TArrayView<float> InOutValues, float SampleRate, float CutoffFrequency);
+
+	/** Least squares polynomial of the window around every value, the first and last windows are evaluated off center. */
+	void SavitzkyGolay(TArrayView<float> InOutValues, int32 WindowSize, int32 PolynomialOrder);
+
+	/** One Euro filter, the cutoff goes up with the filtered speed of the values. */
+	void OneEuro(TConstArrayView<float> Times, TArrayView<float> InOutValues, float MinCutoff, float Beta, float DerivativeCutoff);
+}
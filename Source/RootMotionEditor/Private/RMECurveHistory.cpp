@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurveHistory.h"
+#include "RMETypes.h"
+#include "Animation/AnimCurveTypes.h"
+
+
+SIZE_T FRMECurveChange::GetAllocatedSize() const
+{
+	SIZE_T Size = Deltas.GetAllocatedSize();
+	for (const FRMECurveKeyDelta& Delta : Deltas)
+	{
+		Size += Delta.BeforeKeys.GetAllocatedSize() + Delta.AfterKeys.GetAllocatedSize();
+	}
+	return Size;
+}
+
+
+FRMECurveHistory::FRMECurveHistory(int32 InCapacity)
+{
+	Changes.SetNum(FMath::Max(1, InCapacity));
+}
+
+void FRMECurveHistory::Reset()
+{
+	for (FRMECurveChange& Change : Changes)
+	{
+		Change = FRMECurveChange();
+	}
+
+	Oldest = 0;
+	NumChanges = 0;
+	NumUndoable = 0;
+	bHasSnapshot = false;
+}
+
+FRichCurve& FRMECurveHistory::GetChannel(FTransformCurve& InCurve, int32 Channel)
+{
+	check(Channel >= 0 && Channel < NumChannels);
+	FVectorCurve* Curves[3] = { &InCurve.TranslationCurve, &InCurve.RotationCurve, &InCurve.ScaleCurve };
+	return Curves[Channel / 3]->FloatCurves[Channel % 3];
+}
+
+const FRichCurve& FRMECurveHistory::GetChannel(const FTransformCurve& InCurve, int32 Channel)
+{
+	return GetChannel(const_cast<FTransformCurve&>(InCurve), Channel);
+}
+
+void FRMECurveHistory::BeginChange(const FTransformCurve& InCurve)
+{
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		const TArray<FRichCurveKey>& Keys = GetChannel(InCurve, Channel).GetConstRefOfKeys();
+		Snapshot[Channel].Reset(Keys.Num());
+		Snapshot[Channel].Append(Keys);
+	}
+	bHasSnapshot = true;
+}
+
+bool FRMECurveHistory::EndChange(const FTransformCurve& InCurve, const FText& InDescription)
+{
+	if (!ensureMsgf(bHasSnapshot, TEXT("EndChange called without BeginChange.")))
+	{
+		return false;
+	}
+
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+	bHasSnapshot = false;
+
+	FRMECurveChange Change;
+	Change.Description = InDescription;
+
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		const TArray<FRichCurveKey>& Before = Snapshot[Channel];
+		const TArray<FRichCurveKey>& After = GetChannel(InCurve, Channel).GetConstRefOfKeys();
+
+		// Trim the keys both sides have in common, what's left in the middle is the edit.
+		const int32 MinNum = FMath::Min(Before.Num(), After.Num());
+		int32 Prefix = 0;
+		while (Prefix < MinNum && Before[Prefix] == After[Prefix])
+		{
+			++Prefix;
+		}
+
+		int32 Suffix = 0;
+		while (Suffix < MinNum - Prefix && Before[Before.Num() - 1 - Suffix] == After[After.Num() - 1 - Suffix])
+		{
+			++Suffix;
+		}
+
+		const int32 NumBefore = Before.Num() - Prefix - Suffix;
+		const int32 NumAfter = After.Num() - Prefix - Suffix;
+		if (NumBefore == 0 && NumAfter == 0)
+		{
+			continue;
+		}
+
+		FRMECurveKeyDelta& Delta = Change.Deltas.AddDefaulted_GetRef();
+		Delta.Channel = Channel;
+		Delta.FirstKey = Prefix;
+		Delta.BeforeKeys.Append(Before.GetData() + Prefix, NumBefore);
+		Delta.AfterKeys.Append(After.GetData() + Prefix, NumAfter);
+	}
+
+	// Don't keep the memory of a big curve in the snapshot buffers.
+	for (TArray<FRichCurveKey>& Keys : Snapshot)
+	{
+		if (Keys.Max() > MaxKeptSnapshotKeys)
+		{
+			Keys.Empty();
+		}
+		else
+		{
+			Keys.Reset();
+		}
+	}
+
+	if (Change.Deltas.Num() == 0)
+	{
+		return false;
+	}
+
+	// A new change discards whatever could be redone, and overwrites the oldest entry once the buffer is full.
+	NumChanges = NumUndoable;
+	if (NumChanges == Changes.Num())
+	{
+		Oldest = GetSlot(1);
+		--NumChanges;
+	}
+
+	Changes[GetSlot(NumChanges)] = MoveTemp(Change);
+	++NumChanges;
+	NumUndoable = NumChanges;
+	return true;
+}
+
+FText FRMECurveHistory::GetUndoDescription() const
+{
+	return CanUndo() ? Changes[GetSlot(NumUndoable - 1)].Description : FText::GetEmpty();
+}
+
+FText FRMECurveHistory::GetRedoDescription() const
+{
+	return CanRedo() ? Changes[GetSlot(NumUndoable)].Description : FText::GetEmpty();
+}
+
+bool FRMECurveHistory::Undo(FTransformCurve& InOutCurve)
+{
+	if (!CanUndo())
+	{
+		return false;
+	}
+
+	--NumUndoable;
+	const FRMECurveChange& Change = Changes[GetSlot(NumUndoable)];
+	for (const FRMECurveKeyDelta& Delta : Change.Deltas)
+	{
+		ReplaceKeys(GetChannel(InOutCurve, Delta.Channel), Delta.FirstKey, Delta.AfterKeys.Num(), Delta.BeforeKeys);
+	}
+	return true;
+}
+
+bool FRMECurveHistory::Redo(FTransformCurve& InOutCurve)
+{
+	if (!CanRedo())
+	{
+		return false;
+	}
+
+	const FRMECurveChange& Change = Changes[GetSlot(NumUndoable)];
+	for (const FRMECurveKeyDelta& Delta : Change.Deltas)
+	{
+		ReplaceKeys(GetChannel(InOutCurve, Delta.Channel), Delta.FirstKey, Delta.BeforeKeys.Num(), Delta.AfterKeys);
+	}
+	++NumUndoable;
+	return true;
+}
+
+SIZE_T FRMECurveHistory::GetAllocatedSize() const
+{
+	SIZE_T Size = Changes.GetAllocatedSize();
+	for (const FRMECurveChange& Change : Changes)
+	{
+		Size += Change.GetAllocatedSize();
+	}
+	for (const TArray<FRichCurveKey>& Keys : Snapshot)
+	{
+		Size += Keys.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FRMECurveHistory::ReplaceKeys(FRichCurve& InOutCurve, int32 FirstKey, int32 NumKeysToRemove, TConstArrayView<FRichCurveKey> NewKeys)
+{
+	TArray<FRichCurveKey>& Keys = InOutCurve.Keys;
+	if (!ensure(FirstKey >= 0 && FirstKey + NumKeysToRemove <= Keys.Num()))
+	{
+		return;
+	}
+
+	// Keys that only changed their value or tangents are overwritten in place and keep their handles.
+	const int32 NumOverwritten = FMath::Min(NumKeysToRemove, NewKeys.Num());
+	for (int32 Index = 0; Index < NumOverwritten; ++Index)
+	{
+		Keys[FirstKey + Index] = NewKeys[Index];
+	}
+
+	for (int32 Index = NumOverwritten; Index < NumKeysToRemove; ++Index)
+	{
+		InOutCurve.DeleteKey(InOutCurve.GetKeyHandle(FirstKey + NumOverwritten));
+	}
+
+	for (int32 Index = NumOverwritten; Index < NewKeys.Num(); ++Index)
+	{
+		const FKeyHandle Handle = InOutCurve.AddKey(NewKeys[Index].Time, NewKeys[Index].Value);
+		InOutCurve.GetKey(Handle) = NewKeys[Index];
+	}
+}
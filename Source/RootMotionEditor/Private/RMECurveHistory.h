@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+
+struct FTransformCurve;
+
+/** The keys of one channel that an operation replaced: [FirstKey, FirstKey + BeforeKeys.Num()) became AfterKeys. */
+struct FRMECurveKeyDelta
+{
+	/** Translation X, Y, Z, then rotation, then scale. */
+	int32 Channel = INDEX_NONE;
+	int32 FirstKey = 0;
+	TArray<FRichCurveKey> BeforeKeys;
+	TArray<FRichCurveKey> AfterKeys;
+};
+
+/** One undoable operation, only the channels it changed are stored. */
+struct FRMECurveChange
+{
+	FText Description;
+	TArray<FRMECurveKeyDelta> Deltas;
+
+	SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * Undo history of the edited transform curve.
+ * An operation is bracketed by BeginChange/EndChange, the keys before and after are diffed per channel and only the
+ * changed run of keys is kept, so the memory of an entry follows the size of the edit rather than the size of the curve.
+ * Entries live in a fixed size ring buffer, the oldest one is dropped when it's full.
+ */
+class FRMECurveHistory
+{
+public:
+	static constexpr int32 NumChannels = 9;
+
+	explicit FRMECurveHistory(int32 InCapacity = 128);
+
+	void Reset();
+
+	/** Snapshot the keys the next EndChange is diffed against, the snapshot buffers are reused between operations. */
+	void BeginChange(const FTransformCurve& InCurve);
+
+	/** Record what changed since BeginChange and drop the redo entries. False if nothing changed. */
+	bool EndChange(const FTransformCurve& InCurve, const FText& InDescription);
+
+	/** Forget the snapshot of BeginChange without recording anything, for an operation that was cancelled. */
+	void AbortChange() { bHasSnapshot = false; }
+
+	/** True between BeginChange and EndChange. */
+	bool IsChangeOpen() const { return bHasSnapshot; }
+
+	bool CanUndo() const { return NumUndoable > 0; }
+	bool CanRedo() const { return NumUndoable < NumChanges; }
+
+	/** Empty if there is nothing to undo or redo. */
+	FText GetUndoDescription() const;
+	FText GetRedoDescription() const;
+
+	bool Undo(FTransformCurve& InOutCurve);
+	bool Redo(FTransformCurve& InOutCurve);
+
+	SIZE_T GetAllocatedSize() const;
+
+	static FRichCurve& GetChannel(FTransformCurve& InCurve, int32 Channel);
+	static const FRichCurve& GetChannel(const FTransformCurve& InCurve, int32 Channel);
+
+private:
+	int32 GetSlot(int32 Index) const { return (Oldest + Index) % Changes.Num(); }
+
+	/** Replace a run of keys, through the curve API so the key handles stay valid. */
+	static void ReplaceKeys(FRichCurve& InOutCurve, int32 FirstKey, int32 NumKeysToRemove, TConstArrayView<FRichCurveKey> NewKeys);
+
+private:
+	TArray<FRMECurveChange> Changes;
+	/** Slot of the oldest entry. */
+	int32 Oldest = 0;
+	/** Entries in the buffer, undoable or redoable. */
+	int32 NumChanges = 0;
+	/** The first NumUndoable entries can be undone, the rest can be redone. */
+	int32 NumUndoable = 0;
+
+	/** Snapshot buffers of more keys are freed once the change ends, the smaller ones are kept for the next change. */
+	static constexpr int32 MaxKeptSnapshotKeys = 4096;
+	TArray<FRichCurveKey> Snapshot[NumChannels];
+	bool bHasSnapshot = false;
+};
@@ -0,0 +1,395 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurveOperations.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Algo/BinarySearch.h"
+
+
+namespace RMECurveOperations
+{
+	/**
+	 * Affine map of the translation about a pivot: P' = Pivot + Linear * (P - Pivot) + Offset.
+	 * Only X and Y are mixed, Z is scaled on its own.
+	 */
+	struct FTranslationMap
+	{
+		float XX = 1.f, XY = 0.f;
+		float YX = 0.f, YY = 1.f;
+		float ZZ = 1.f;
+		FVector Offset = FVector::ZeroVector;
+		/** Rigid maps are applied to the following keys as is, the others only move them by the displacement of the range end. */
+		bool bIsRigid = false;
+
+		FVector Apply(const FVector& Pivot, const FVector& Point) const
+		{
+			return Pivot + ApplyLinear(Point - Pivot) + Offset;
+		}
+
+		FVector ApplyLinear(const FVector& Vector) const
+		{
+			return FVector(XX * Vector.X + XY * Vector.Y, YX * Vector.X + YY * Vector.Y, ZZ * Vector.Z);
+		}
+	};
+
+	static FVector EvalVector(const FVectorCurve& Curve, float Time)
+	{
+		return FVector(Curve.FloatCurves[0].Eval(Time), Curve.FloatCurves[1].Eval(Time), Curve.FloatCurves[2].Eval(Time));
+	}
+
+	/** Arrive and leave slopes of a channel at the time, from the key there if any, else by finite difference. */
+	static void GetSlopes(const FRichCurve& Curve, float Time, float& OutArrive, float& OutLeave)
+	{
+		const TArray<FRichCurveKey>& Keys = Curve.GetConstRefOfKeys();
+		const int32 Index = Algo::LowerBoundBy(Keys, Time, &FRichCurveKey::Time);
+		if (Keys.IsValidIndex(Index) && FMath::IsNearlyEqual(Keys[Index].Time, Time))
+		{
+			OutArrive = Keys[Index].ArriveTangent;
+			OutLeave = Keys[Index].LeaveTangent;
+			return;
+		}
+
+		constexpr float Delta = 1.e-3f;
+		OutArrive = OutLeave = (Curve.Eval(Time + Delta) - Curve.Eval(Time - Delta)) / (2.f * Delta);
+	}
+
+	static void TransformTranslation(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, const FTranslationMap& Map)
+	{
+		FVectorCurve& Translation = InOutCurve.TranslationCurve;
+
+		// The channels are mixed, so every channel reads the others from the untouched copy.
+		const FVectorCurve Source = Translation;
+		const FVector Pivot = Range.bIsAdditiveCurve ? FVector::ZeroVector : EvalVector(Source, Range.StartTime);
+		const FVector EndPoint = EvalVector(Source, Range.EndTime);
+		const FVector EndDisplacement = Map.Apply(Pivot, EndPoint) - EndPoint;
+		const bool bCarry = Range.bCarryFollowingKeys && !Range.bIsAdditiveCurve;
+
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			TArray<FRichCurveKey>& Keys = Translation.FloatCurves[Axis].Keys;
+			const TArray<FRichCurveKey>& SourceKeys = Source.FloatCurves[Axis].Keys;
+
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				FRichCurveKey& Key = Keys[Index];
+				if (Key.Time < Range.StartTime || (Key.Time > Range.EndTime && !bCarry))
+				{
+					continue;
+				}
+
+				if (Key.Time > Range.EndTime && !Map.bIsRigid)
+				{
+					Key.Value = SourceKeys[Index].Value + EndDisplacement[Axis];
+					continue;
+				}
+
+				// Keys baked from an animation share their times, read the other channels straight from their keys.
+				FVector Point, ArriveSlope, LeaveSlope;
+				for (int32 Other = 0; Other < 3; ++Other)
+				{
+					const TArray<FRichCurveKey>& OtherKeys = Source.FloatCurves[Other].Keys;
+					if (OtherKeys.IsValidIndex(Index) && OtherKeys[Index].Time == Key.Time)
+					{
+						Point[Other] = OtherKeys[Index].Value;
+						ArriveSlope[Other] = OtherKeys[Index].ArriveTangent;
+						LeaveSlope[Other] = OtherKeys[Index].LeaveTangent;
+					}
+					else
+					{
+						Point[Other] = Source.FloatCurves[Other].Eval(Key.Time);
+						GetSlopes(Source.FloatCurves[Other], Key.Time, ArriveSlope[Other], LeaveSlope[Other]);
+					}
+				}
+
+				Key.Value = Map.Apply(Pivot, Point)[Axis];
+				Key.ArriveTangent = Map.ApplyLinear(ArriveSlope)[Axis];
+				Key.LeaveTangent = Map.ApplyLinear(LeaveSlope)[Axis];
+			}
+		}
+	}
+
+	/** Value * Scale + Offset on the keys of one rotation channel in range, and on the following ones if bCarry. */
+	static void TransformRotationChannel(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, int32 Axis, float Scale, float Offset, bool bCarry)
+	{
+		for (FRichCurveKey& Key : InOutCurve.RotationCurve.FloatCurves[Axis].Keys)
+		{
+			if (Key.Time < Range.StartTime || (Key.Time > Range.EndTime && !bCarry))
+			{
+				continue;
+			}
+
+			Key.Value = Key.Value * Scale + Offset;
+			Key.ArriveTangent *= Scale;
+			Key.LeaveTangent *= Scale;
+		}
+	}
+
+	/**
+	 * Negate one rotation channel around its value at the start of the range, so the range starts with the same
+	 * heading and turns the other way. The following keys are moved by the change at the range end if carried.
+	 */
+	static void MirrorRotationChannel(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, int32 Axis)
+	{
+		FRichCurve& Channel = InOutCurve.RotationCurve.FloatCurves[Axis];
+		if (Channel.GetNumKeys() == 0)
+		{
+			return;
+		}
+
+		// Additive keys are deltas, they are negated around zero.
+		const float Pivot = Range.bIsAdditiveCurve ? 0.f : Channel.Eval(FMath::Max(Range.StartTime, Channel.GetFirstKey().Time));
+		const float EndValue = Channel.Eval(FMath::Min(Range.EndTime, Channel.GetLastKey().Time));
+		const float EndDisplacement = 2.f * (Pivot - EndValue);
+		const bool bCarry = Range.bCarryFollowingKeys && !Range.bIsAdditiveCurve;
+
+		for (FRichCurveKey& Key : Channel.Keys)
+		{
+			if (Key.Time < Range.StartTime || (Key.Time > Range.EndTime && !bCarry))
+			{
+				continue;
+			}
+
+			if (Key.Time > Range.EndTime)
+			{
+				Key.Value += EndDisplacement;
+				continue;
+			}
+
+			Key.Value = 2.f * Pivot - Key.Value;
+			Key.ArriveTangent = -Key.ArriveTangent;
+			Key.LeaveTangent = -Key.LeaveTangent;
+		}
+	}
+
+	static void AutoSetAllTangents(FTransformCurve& InOutCurve)
+	{
+		for (FVectorCurve* Curve : { &InOutCurve.TranslationCurve, &InOutCurve.RotationCurve, &InOutCurve.ScaleCurve })
+		{
+			for (FRichCurve& Channel : Curve->FloatCurves)
+			{
+				Channel.AutoSetTangents();
+			}
+		}
+	}
+
+	void ScaleDistance(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Scale)
+	{
+		FTranslationMap Map;
+		Map.XX = Map.YY = Map.ZZ = Scale;
+		TransformTranslation(InOutCurve, Range, Map);
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void TimeStretch(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Scale)
+	{
+		if (Scale <= UE_KINDA_SMALL_NUMBER)
+		{
+			return;
+		}
+
+		// The stretch is monotonic, so the keys stay sorted and keep their handles.
+		const float RangeEnd = FMath::Min(Range.EndTime, GetKeyRange(InOutCurve).EndTime);
+		const float LengthChange = (RangeEnd - Range.StartTime) * (Scale - 1.f);
+		for (FVectorCurve* Curve : { &InOutCurve.TranslationCurve, &InOutCurve.RotationCurve, &InOutCurve.ScaleCurve })
+		{
+			for (FRichCurve& Channel : Curve->FloatCurves)
+			{
+				int32 FirstFollowingKey = Channel.Keys.Num();
+				for (int32 Index = 0; Index < Channel.Keys.Num(); ++Index)
+				{
+					FRichCurveKey& Key = Channel.Keys[Index];
+					if (Key.Time < Range.StartTime)
+					{
+						continue;
+					}
+
+					if (Key.Time <= RangeEnd)
+					{
+						Key.Time = Range.StartTime + (Key.Time - Range.StartTime) * Scale;
+						Key.ArriveTangent /= Scale;
+						Key.LeaveTangent /= Scale;
+					}
+					else
+					{
+						FirstFollowingKey = FMath::Min(FirstFollowingKey, Index);
+						if (Range.bCarryFollowingKeys)
+						{
+							Key.Time += LengthChange;
+						}
+					}
+				}
+
+				// The following keys stay where they are, the stretched keys that reach them are dropped to keep the order.
+				if (!Range.bCarryFollowingKeys && FirstFollowingKey < Channel.Keys.Num())
+				{
+					const float FollowingTime = Channel.Keys[FirstFollowingKey].Time;
+					for (int32 Index = FirstFollowingKey - 1; Index >= 0 && Channel.Keys[Index].Time >= FollowingTime; --Index)
+					{
+						Channel.DeleteKey(Channel.GetKeyHandle(Index));
+					}
+				}
+			}
+		}
+
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void Offset(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, const FVector& InOffset)
+	{
+		FTranslationMap Map;
+		Map.Offset = InOffset;
+		Map.bIsRigid = true;
+		TransformTranslation(InOutCurve, Range, Map);
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void Mirror(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, EAxis::Type Axis)
+	{
+		if (Axis == EAxis::None)
+		{
+			return;
+		}
+
+		FTranslationMap Map;
+		Map.XX = Axis == EAxis::X ? -1.f : 1.f;
+		Map.YY = Axis == EAxis::Y ? -1.f : 1.f;
+		Map.ZZ = Axis == EAxis::Z ? -1.f : 1.f;
+		TransformTranslation(InOutCurve, Range, Map);
+
+		// A reflection flips the rotations about the two axes lying in the mirror plane.
+		const int32 MirroredAxis = static_cast<int32>(Axis) - 1;
+		for (int32 RotationAxis = 0; RotationAxis < 3; ++RotationAxis)
+		{
+			if (RotationAxis != MirroredAxis)
+			{
+				MirrorRotationChannel(InOutCurve, Range, RotationAxis);
+			}
+		}
+
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void RotateAboutZ(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Degrees)
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, FMath::DegreesToRadians(Degrees));
+
+		FTranslationMap Map;
+		Map.XX = Cos;
+		Map.XY = -Sin;
+		Map.YX = Sin;
+		Map.YY = Cos;
+		Map.bIsRigid = true;
+		TransformTranslation(InOutCurve, Range, Map);
+
+		// Rotation curve channels are roll, pitch, yaw. Additive keys are deltas, their yaw doesn't change.
+		if (!Range.bIsAdditiveCurve)
+		{
+			TransformRotationChannel(InOutCurve, Range, 2, 1.f, Degrees, Range.bCarryFollowingKeys);
+		}
+
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void RemoveDrift(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, EAxis::Type Axis)
+	{
+		if (Axis == EAxis::None)
+		{
+			return;
+		}
+
+		FRichCurve& Channel = InOutCurve.TranslationCurve.FloatCurves[static_cast<int32>(Axis) - 1];
+		if (Channel.GetNumKeys() < 2)
+		{
+			return;
+		}
+
+		if (Range.bIsAdditiveCurve)
+		{
+			float Sum = 0.f;
+			int32 NumInRange = 0;
+			for (const FRichCurveKey& Key : Channel.Keys)
+			{
+				if (Key.Time >= Range.StartTime && Key.Time <= Range.EndTime)
+				{
+					Sum += Key.Value;
+					++NumInRange;
+				}
+			}
+
+			const float MeanDelta = NumInRange > 0 ? Sum / NumInRange : 0.f;
+			for (FRichCurveKey& Key : Channel.Keys)
+			{
+				if (Key.Time >= Range.StartTime && Key.Time <= Range.EndTime)
+				{
+					Key.Value -= MeanDelta;
+				}
+			}
+		}
+		else
+		{
+			const float RangeStart = FMath::Max(Range.StartTime, Channel.GetFirstKey().Time);
+			const float RangeEnd = FMath::Min(Range.EndTime, Channel.GetLastKey().Time);
+			if (RangeEnd - RangeStart <= UE_KINDA_SMALL_NUMBER)
+			{
+				return;
+			}
+
+			const float Drift = Channel.Eval(RangeEnd) - Channel.Eval(RangeStart);
+			const float Slope = Drift / (RangeEnd - RangeStart);
+			for (FRichCurveKey& Key : Channel.Keys)
+			{
+				if (Key.Time < RangeStart || (Key.Time > RangeEnd && !Range.bCarryFollowingKeys))
+				{
+					continue;
+				}
+
+				if (Key.Time > RangeEnd)
+				{
+					Key.Value -= Drift;
+					continue;
+				}
+
+				Key.Value -= Slope * (Key.Time - RangeStart);
+				Key.ArriveTangent -= Slope;
+				Key.LeaveTangent -= Slope;
+			}
+		}
+
+		AutoSetAllTangents(InOutCurve);
+	}
+
+	void ZeroStartYaw(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range)
+	{
+		const FRichCurve& Yaw = InOutCurve.RotationCurve.FloatCurves[2];
+		if (Range.bIsAdditiveCurve || Yaw.GetNumKeys() == 0)
+		{
+			return;
+		}
+
+		const float StartYaw = Yaw.Eval(FMath::Max(Range.StartTime, Yaw.GetFirstKey().Time));
+		if (!FMath::IsNearlyZero(StartYaw))
+		{
+			RotateAboutZ(InOutCurve, Range, -StartYaw);
+		}
+	}
+
+	FRMECurveOperationRange GetKeyRange(const FTransformCurve& InCurve)
+	{
+		FRMECurveOperationRange Range;
+		Range.StartTime = MAX_flt;
+		Range.EndTime = -MAX_flt;
+		for (const FVectorCurve* Curve : { &InCurve.TranslationCurve, &InCurve.RotationCurve, &InCurve.ScaleCurve })
+		{
+			for (const FRichCurve& Channel : Curve->FloatCurves)
+			{
+				if (Channel.GetNumKeys() > 0)
+				{
+					Range.StartTime = FMath::Min(Range.StartTime, Channel.GetFirstKey().Time);
+					Range.EndTime = FMath::Max(Range.EndTime, Channel.GetLastKey().Time);
+				}
+			}
+		}
+		return Range;
+	}
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTransformCurve;
+
+/** Keys in [StartTime, EndTime] are reshaped, the keys after the range follow along if bCarryFollowingKeys. */
+struct FRMECurveOperationRange
+{
+	float StartTime = -MAX_flt;
+	float EndTime = MAX_flt;
+	bool bCarryFollowingKeys = true;
+	/** Keys are per frame deltas: no pivot, and nothing to carry. */
+	bool bIsAdditiveCurve = false;
+};
+
+/**
+ * Batch reshaping of the edited root motion curve.
+ * Each operation walks the keys of every channel once, transforming values and user tangents together, and the
+ * auto tangents of all channels are recomputed once at the end.
+ */
+namespace RMECurveOperations
+{
+	/** Scale the translation around the position at the start of the range. */
+	void ScaleDistance(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Scale);
+
+	/**
+	 * Stretch the key times of the range around its start. The following keys are shifted by the change of length if
+	 * carried, else they stay and the stretched keys that would pass them are removed.
+	 */
+	void TimeStretch(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Scale);
+
+	void Offset(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, const FVector& InOffset);
+
+	/** Mirror the translation across the plane through the start position, rotations are mirrored around the start rotation. */
+	void Mirror(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, EAxis::Type Axis);
+
+	/** Rotate the trajectory about the vertical axis through the start position, and add the yaw to the rotation. */
+	void RotateAboutZ(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, float Degrees);
+
+	/** Remove the linear drift of one translation axis over the range so it ends where it starts, additive keys lose their mean delta. */
+	void RemoveDrift(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range, EAxis::Type Axis);
+
+	/** Rotate about the vertical axis so the yaw at the start of the range is zero, additive keys have no heading to zero. */
+	void ZeroStartYaw(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range);
+
+	/** Time range of the keys of all the channels, empty range if there are no keys. */
+	FRMECurveOperationRange GetKeyRange(const FTransformCurve& InCurve);
+}
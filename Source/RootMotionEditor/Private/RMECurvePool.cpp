@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMECurvePool.h"
+#include "RMETypes.h"
+#include "Animation/AnimCurveTypes.h"
+
+
+namespace RMECurvePool
+{
+	/** Remove the keys and their handles, the handles would otherwise point at the next keys put in the same slots. */
+	static void ResetKeepingAllocation(FRichCurve& InOutCurve)
+	{
+		TArray<FRichCurveKey> Keys = MoveTemp(InOutCurve.Keys);
+		InOutCurve.Reset();
+		Keys.Reset();
+		InOutCurve.Keys = MoveTemp(Keys);
+	}
+}
+
+
+FRMECurvePool& FRMECurvePool::Get()
+{
+	static FRMECurvePool Pool;
+	return Pool;
+}
+
+FRMECurveHandle FRMECurvePool::Allocate()
+{
+	check(IsInGameThread());
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	int32 Index = INDEX_NONE;
+	if (FreeSlots.Num() > 0)
+	{
+		Index = FreeSlots.Pop();
+	}
+	else
+	{
+		Index = Slots.AddDefaulted();
+		Slots[Index].Curve = MakeUnique<FTransformCurve>();
+	}
+
+	FSlot& Slot = Slots[Index];
+	Slot.bInUse = true;
+
+	FRMECurveHandle Handle;
+	Handle.Index = Index;
+	Handle.Serial = Slot.Serial;
+	return Handle;
+}
+
+void FRMECurvePool::Release(FRMECurveHandle& InOutHandle)
+{
+	check(IsInGameThread());
+
+	if (Resolve(InOutHandle) != nullptr)
+	{
+		FSlot& Slot = Slots[InOutHandle.Index];
+		ResetKeys(*Slot.Curve);
+		Slot.bInUse = false;
+		++Slot.Serial;
+		FreeSlots.Add(InOutHandle.Index);
+	}
+
+	InOutHandle.Reset();
+}
+
+FTransformCurve* FRMECurvePool::Resolve(const FRMECurveHandle& InHandle) const
+{
+	// Allocate can grow the slots under a reader on another thread.
+	check(IsInGameThread());
+
+	if (!Slots.IsValidIndex(InHandle.Index))
+	{
+		return nullptr;
+	}
+
+	const FSlot& Slot = Slots[InHandle.Index];
+	return Slot.bInUse && Slot.Serial == InHandle.Serial ? Slot.Curve.Get() : nullptr;
+}
+
+void FRMECurvePool::ResetKeys(FTransformCurve& InOutCurve)
+{
+	FVectorCurve* Channels[3] = { &InOutCurve.TranslationCurve, &InOutCurve.RotationCurve, &InOutCurve.ScaleCurve };
+	for (FVectorCurve* Channel : Channels)
+	{
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			RMECurvePool::ResetKeepingAllocation(Channel->FloatCurves[Index]);
+		}
+	}
+}
+
+void FRMECurvePool::CopyKeys(const FTransformCurve& InSource, FTransformCurve& OutDest)
+{
+	CopyKeys(InSource.TranslationCurve, OutDest.TranslationCurve);
+	CopyKeys(InSource.RotationCurve, OutDest.RotationCurve);
+	CopyKeys(InSource.ScaleCurve, OutDest.ScaleCurve);
+}
+
+void FRMECurvePool::CopyKeys(const FVectorCurve& InSource, FVectorCurve& OutDest)
+{
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		CopyKeys(InSource.FloatCurves[Index], OutDest.FloatCurves[Index]);
+	}
+}
+
+void FRMECurvePool::CopyKeys(const FRichCurve& InSource, FRichCurve& OutDest)
+{
+	if (&InSource == &OutDest)
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	RMECurvePool::ResetKeepingAllocation(OutDest);
+	OutDest.Keys.Append(InSource.Keys);
+	OutDest.DefaultValue = InSource.DefaultValue;
+	OutDest.PreInfinityExtrap = InSource.PreInfinityExtrap;
+	OutDest.PostInfinityExtrap = InSource.PostInfinityExtrap;
+}
+
+SIZE_T FRMECurvePool::GetAllocatedSize() const
+{
+	SIZE_T Size = Slots.GetAllocatedSize() + FreeSlots.GetAllocatedSize();
+	for (const FSlot& Slot : Slots)
+	{
+		Size += GetAllocatedSize(*Slot.Curve);
+	}
+	return Size;
+}
+
+SIZE_T FRMECurvePool::GetAllocatedSize(const FTransformCurve& InCurve)
+{
+	SIZE_T Size = sizeof(FTransformCurve);
+	const FVectorCurve* Channels[3] = { &InCurve.TranslationCurve, &InCurve.RotationCurve, &InCurve.ScaleCurve };
+	for (const FVectorCurve* Channel : Channels)
+	{
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			Size += Channel->FloatCurves[Index].Keys.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
+
+int32 FRMECurvePool::GetNumKeys(const FTransformCurve& InCurve)
+{
+	int32 NumKeys = 0;
+	const FVectorCurve* Channels[3] = { &InCurve.TranslationCurve, &InCurve.RotationCurve, &InCurve.ScaleCurve };
+	for (const FVectorCurve* Channel : Channels)
+	{
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			NumKeys += Channel->FloatCurves[Index].GetNumKeys();
+		}
+	}
+	return NumKeys;
+}
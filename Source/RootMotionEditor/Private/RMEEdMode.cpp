@@ -121,7 +121,7 @@ namespace RootMotionEditor
 	{
 		if (CanEditWithManipulator() && Event == IE_Pressed && Key == EKeys::S)
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (FRMEContext* Context = ViewModel ? ViewModel->GetContext() : nullptr)
 			{
 				const bool bHasAddedKey = Context->AddPreviewKeyAtCurrentTime();
 				if (bHasAddedKey)
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEFrameSampler.h"
+#include "Animation/AnimSequence.h"
+
+
+FRMEFrameSampler::FRMEFrameSampler(const FFrameRate& InFrameRate, double InLength)
+	: FrameRate(InFrameRate)
+	, Length(FMath::Max(InLength, 0.0))
+{
+	// A length a rounding error away from a frame ends on that frame, it doesn't get a sample of its own.
+	const double EndFrame = FrameRate.AsDecimal() * Length;
+	const int32 NearestFrame = FMath::RoundToInt32(EndFrame);
+	const int32 LastFrame = FMath::IsNearlyEqual(EndFrame, static_cast<double>(NearestFrame), 1.e-3) ? NearestFrame : FMath::CeilToInt32(EndFrame);
+	NumFrames = LastFrame + 1;
+}
+
+FRMEFrameSampler FRMEFrameSampler::ForAnimation(const UAnimSequence* InAnimation)
+{
+	return InAnimation != nullptr ? FRMEFrameSampler(InAnimation->GetSamplingFrameRate(), InAnimation->GetPlayLength()) : FRMEFrameSampler();
+}
+
+FRMEFrameSampler FRMEFrameSampler::ForDataModel(const UAnimSequence* InAnimation)
+{
+	const IAnimationDataModel* Model = InAnimation != nullptr ? InAnimation->GetDataModel() : nullptr;
+	if (Model == nullptr || Model->GetNumberOfKeys() == 0)
+	{
+		return FRMEFrameSampler();
+	}
+
+	// One sample per key, the last key is the end of the model.
+	const FFrameRate ModelFrameRate = Model->GetFrameRate();
+	return FRMEFrameSampler(ModelFrameRate, ModelFrameRate.AsSeconds(FFrameNumber(Model->GetNumberOfKeys() - 1)));
+}
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEGroundProjection.h"
+#include "RMECurveFilters.h"
+#include "RMEFrameSampler.h"
+#include "RMEStatics.h"
+#include "RMETypes.h"
+#include "AnimationRuntime.h"
+#include "Animation/AnimSequence.h"
+#include "Async/ParallelFor.h"
+
+
+namespace RMEGroundProjection
+{
+	using FBoneChain = TArray<int32, TInlineAllocator<16>>;
+
+	/** The pelvis and its parents, root first. */
+	static bool GetPelvisChain(const UAnimSequence* AnimSequence, FName PelvisBoneName, FBoneChain& OutChain)
+	{
+		const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		if (Skeleton == nullptr || Model == nullptr || Model->GetNumberOfKeys() <= 1)
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("Ground projection of %s failed. Reason: no skeleton, no data model or less than 2 keys."), *GetNameSafe(AnimSequence));
+			return false;
+		}
+
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		const int32 PelvisIndex = RefSkeleton.FindBoneIndex(PelvisBoneName);
+		if (PelvisIndex == INDEX_NONE)
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("Ground projection of %s failed. Reason: no bone %s in the skeleton."), *GetNameSafe(AnimSequence), *PelvisBoneName.ToString());
+			return false;
+		}
+
+		OutChain.Reset();
+		for (int32 BoneIndex = PelvisIndex; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			OutChain.Insert(BoneIndex, 0);
+		}
+		return true;
+	}
+
+	static void GetChainKeys(const UAnimSequence* AnimSequence, const FBoneChain& Chain, TArray<TArray<FTransform>>& OutChainKeys)
+	{
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		const FReferenceSkeleton& RefSkeleton = AnimSequence->GetSkeleton()->GetReferenceSkeleton();
+		OutChainKeys.SetNum(Chain.Num());
+		for (int32 ChainIndex = 0; ChainIndex < Chain.Num(); ++ChainIndex)
+		{
+			RootMotionEditorStatics::GetBoneTrackKeys(Model, RefSkeleton, Chain[ChainIndex], OutChainKeys[ChainIndex]);
+		}
+	}
+
+	/** Component space transform of the last bone of the chain at the key, from the first bone to the last one. */
+	static FTransform AccumulateChain(const TArray<TArray<FTransform>>& ChainKeys, int32 Key, int32 FirstBone, int32 LastBone)
+	{
+		FTransform Result = ChainKeys[FirstBone][Key];
+		for (int32 ChainIndex = FirstBone + 1; ChainIndex <= LastBone; ++ChainIndex)
+		{
+			Result = ChainKeys[ChainIndex][Key] * Result;
+		}
+		return Result;
+	}
+
+	bool BakePelvisToCurve(const UAnimSequence* AnimSequence, const FRMEGroundProjectionSettings& Settings, int32 ExtractChannel, bool bIsAdditiveCurve, FTransformCurve& OutCurve)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RMEGroundProjection::BakePelvisToCurve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
+		FBoneChain Chain;
+		if (AnimSequence == nullptr || !GetPelvisChain(AnimSequence, Settings.PelvisBoneName, Chain))
+		{
+			return false;
+		}
+
+		const FVector ForwardAxis = Settings.ForwardAxis.GetSafeNormal();
+		if (ForwardAxis.IsNearlyZero())
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("Ground projection of %s failed. Reason: the forward axis of the pelvis is zero."), *GetNameSafe(AnimSequence));
+			return false;
+		}
+
+		TArray<TArray<FTransform>> ChainKeys;
+		GetChainKeys(AnimSequence, Chain, ChainKeys);
+
+		const FRMEFrameSampler Sampler = FRMEFrameSampler::ForDataModel(AnimSequence);
+		const int32 NumKeys = Sampler.Num();
+		check(NumKeys == ChainKeys[0].Num());
+
+		// The reference pose faces yaw 0, whatever way the skeleton is built.
+		const FReferenceSkeleton& RefSkeleton = AnimSequence->GetSkeleton()->GetReferenceSkeleton();
+		const FVector ReferenceForward = FAnimationRuntime::GetComponentSpaceTransformRefPose(RefSkeleton, Chain.Last()).TransformVectorNoScale(ForwardAxis);
+		const float ReferenceYaw = FMath::RadiansToDegrees(FMath::Atan2(ReferenceForward.Y, ReferenceForward.X));
+
+		TArray<float> Times;
+		TArray<float> GroundX;
+		TArray<float> GroundY;
+		TArray<float> Yaws;
+		TArray<bool> HasFacing;
+		Times.SetNumUninitialized(NumKeys);
+		GroundX.SetNumUninitialized(NumKeys);
+		GroundY.SetNumUninitialized(NumKeys);
+		Yaws.SetNumUninitialized(NumKeys);
+		HasFacing.SetNumUninitialized(NumKeys);
+
+		ParallelFor(NumKeys, [&](int32 Key)
+		{
+			LLM_SCOPE_BYTAG(RootMotionEditor);
+			const FTransform Pelvis = AccumulateChain(ChainKeys, Key, 0, Chain.Num() - 1);
+			const FVector Forward = Pelvis.TransformVectorNoScale(ForwardAxis);
+
+			Times[Key] = static_cast<float>(Sampler.GetTime(Key));
+			GroundX[Key] = static_cast<float>(Pelvis.GetLocation().X);
+			GroundY[Key] = static_cast<float>(Pelvis.GetLocation().Y);
+
+			// Less than about 6 degrees from vertical, the ground heading isn't reliable.
+			HasFacing[Key] = FVector2D(Forward.X, Forward.Y).SizeSquared() > 0.01;
+			Yaws[Key] = HasFacing[Key] ? FMath::RadiansToDegrees(FMath::Atan2(Forward.Y, Forward.X)) - ReferenceYaw : 0.f;
+		});
+
+		// A frame without heading keeps the one of the frame before, or of the first frame with one. The yaw is unwound
+		// so the filter sees a continuous angle.
+		const int32 FirstFacing = HasFacing.Find(true);
+		float LastYaw = FirstFacing != INDEX_NONE ? FMath::UnwindDegrees(Yaws[FirstFacing]) : 0.f;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			Yaws[Key] = HasFacing[Key] ? LastYaw + FMath::UnwindDegrees(Yaws[Key] - LastYaw) : LastYaw;
+			LastYaw = Yaws[Key];
+		}
+
+		if (Settings.bSmooth)
+		{
+			TArray<TArrayView<float>, TInlineAllocator<3>> Channels;
+			if (EnumHasAnyFlags(Settings.Smoothing.Channels, ERMEBoneExtractChannelType::Translation))
+			{
+				Channels.Add(GroundX);
+				Channels.Add(GroundY);
+			}
+			if (EnumHasAnyFlags(Settings.Smoothing.Channels, ERMEBoneExtractChannelType::Rotation))
+			{
+				Channels.Add(Yaws);
+			}
+			ParallelFor(Channels.Num(), [&Times, &Channels, &Settings](int32 Index)
+			{
+				LLM_SCOPE_BYTAG(RootMotionEditor);
+				RMECurveFilters::ApplyToValues(Times, Channels[Index], Settings.Smoothing);
+			});
+		}
+
+		FTransform LastTransform = FTransform::Identity;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const FTransform GroundTransform(FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaws[Key])), FVector(GroundX[Key], GroundY[Key], 0.f));
+			FTransform TargetTransform = bIsAdditiveCurve ? GroundTransform.GetRelativeTransform(LastTransform) : GroundTransform;
+			RootMotionEditorStatics::ExtractDataFilter(TargetTransform, ExtractChannel);
+			OutCurve.UpdateOrAddKey(TargetTransform, Times[Key]);
+			LastTransform = GroundTransform;
+		}
+		INC_DWORD_STAT_BY(STAT_RME_BakedSamples, NumKeys);
+		return true;
+	}
+
+	bool OverrideRootMotion(UAnimSequence* AnimSequence, const FTransformCurve& NewRootMotion, FName PelvisBoneName)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RMEGroundProjection::OverrideRootMotion);
+
+		FBoneChain Chain;
+		if (AnimSequence == nullptr || !GetPelvisChain(AnimSequence, PelvisBoneName, Chain))
+		{
+			return false;
+		}
+		if (Chain.Num() < 2)
+		{
+			UE_LOG(LogRootMotionEditor, Error, TEXT("Ground projection write back of %s failed. Reason: the pelvis %s is the root bone."), *GetNameSafe(AnimSequence), *PelvisBoneName.ToString());
+			return false;
+		}
+
+		// The pelvis in component space before the root changes.
+		TArray<TArray<FTransform>> ChainKeys;
+		GetChainKeys(AnimSequence, Chain, ChainKeys);
+		const int32 NumKeys = ChainKeys[0].Num();
+		TArray<FTransform> PelvisKeys;
+		PelvisKeys.SetNumUninitialized(NumKeys);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			PelvisKeys[Key] = AccumulateChain(ChainKeys, Key, 0, Chain.Num() - 1);
+		}
+
+		IAnimationDataController& Controller = AnimSequence->GetController();
+		const bool bShouldTransact = false;
+		Controller.OpenBracket(NSLOCTEXT("RootMotionEditor", "OverrideGroundProjection_Bracket", "Override Ground Projected Root Motion"), bShouldTransact);
+
+		if (!RootMotionEditorStatics::OverrideAnimBoneMotion(AnimSequence, NewRootMotion))
+		{
+			Controller.CloseBracket(bShouldTransact);
+			return false;
+		}
+
+		// The bones between the root and the pelvis keep their keys, only the pelvis makes up for the new root.
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		RootMotionEditorStatics::GetBoneTrackKeys(Model, AnimSequence->GetSkeleton()->GetReferenceSkeleton(), Chain[0], ChainKeys[0]);
+
+		TArray<FVector> PelvisTranslations;
+		TArray<FQuat> PelvisQuats;
+		TArray<FVector> PelvisScales;
+		PelvisTranslations.SetNumUninitialized(NumKeys);
+		PelvisQuats.SetNumUninitialized(NumKeys);
+		PelvisScales.SetNumUninitialized(NumKeys);
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const FTransform Parent = AccumulateChain(ChainKeys, Key, 0, Chain.Num() - 2);
+			const FTransform PelvisLocal = PelvisKeys[Key].GetRelativeTransform(Parent);
+			PelvisTranslations[Key] = PelvisLocal.GetTranslation();
+			PelvisQuats[Key] = PelvisLocal.GetRotation();
+			PelvisScales[Key] = PelvisLocal.GetScale3D();
+		}
+
+		if (!Model->IsValidBoneTrackName(PelvisBoneName))
+		{
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 2
+			Controller.AddBoneCurve(PelvisBoneName, bShouldTransact);
+#else
+			Controller.AddBoneTrack(PelvisBoneName, bShouldTransact);
+#endif
+		}
+		Controller.UpdateBoneTrackKeys(PelvisBoneName, FInt32Range(0, NumKeys), PelvisTranslations, PelvisQuats, PelvisScales, bShouldTransact);
+		INC_DWORD_STAT_BY(STAT_RME_WrittenBoneKeys, NumKeys);
+
+		Controller.CloseBracket(bShouldTransact);
+		return true;
+	}
+}
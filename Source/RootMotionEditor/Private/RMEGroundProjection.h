@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+struct FTransformCurve;
+struct FRMEGroundProjectionSettings;
+
+/**
+ * Root motion of clips without authored root motion, derived from the pelvis.
+ * The pelvis is read from the raw bone tracks, so the keys land on the frames the write back overrides.
+ */
+namespace RMEGroundProjection
+{
+	/**
+	 * Key the pelvis projected on the ground on every raw frame, the yaw is 0 where the pelvis faces like in the
+	 * reference pose. Every frame is computed in one parallel pass, the filter runs after on the whole range.
+	 */
+	bool BakePelvisToCurve(const UAnimSequence* AnimSequence, const FRMEGroundProjectionSettings& Settings, int32 ExtractChannel, bool bIsAdditiveCurve, FTransformCurve& OutCurve);
+
+	/**
+	 * Write the root motion to the root bone, and take it out of the pelvis so the pelvis stays where it was in
+	 * component space. Without it the motion would be applied twice, once by the root and once by the pelvis.
+	 */
+	bool OverrideRootMotion(UAnimSequence* AnimSequence, const FTransformCurve& NewRootMotion, FName PelvisBoneName);
+}
@@ -0,0 +1,422 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMELoopSeam.h"
+#include "RMECurveHistory.h"
+#include "RMETypes.h"
+#include "Algo/BinarySearch.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Async/ParallelFor.h"
+
+
+namespace RMELoopSeam
+{
+	static constexpr int32 MaxConstraints = 3;
+
+	/** Translation X and Y and the yaw travel over a cycle, the other channels come back where they started. */
+	static bool IsTravelingChannel(int32 Channel)
+	{
+		return Channel == 0 || Channel == 1 || Channel == 5;
+	}
+
+	/** Gauss-Jordan inverse of a small matrix, false if it's singular. */
+	static bool InvertSmallMatrix(int32 Size, double (&InOutMatrix)[MaxConstraints][MaxConstraints])
+	{
+		double Inverse[MaxConstraints][MaxConstraints] = {};
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Inverse[Index][Index] = 1.0;
+		}
+
+		for (int32 Pivot = 0; Pivot < Size; ++Pivot)
+		{
+			int32 BestRow = Pivot;
+			for (int32 Row = Pivot + 1; Row < Size; ++Row)
+			{
+				if (FMath::Abs(InOutMatrix[Row][Pivot]) > FMath::Abs(InOutMatrix[BestRow][Pivot]))
+				{
+					BestRow = Row;
+				}
+			}
+			if (FMath::Abs(InOutMatrix[BestRow][Pivot]) < UE_DOUBLE_SMALL_NUMBER)
+			{
+				return false;
+			}
+			for (int32 Column = 0; Column < Size; ++Column)
+			{
+				Swap(InOutMatrix[Pivot][Column], InOutMatrix[BestRow][Column]);
+				Swap(Inverse[Pivot][Column], Inverse[BestRow][Column]);
+			}
+
+			const double InvPivot = 1.0 / InOutMatrix[Pivot][Pivot];
+			for (int32 Column = 0; Column < Size; ++Column)
+			{
+				InOutMatrix[Pivot][Column] *= InvPivot;
+				Inverse[Pivot][Column] *= InvPivot;
+			}
+			for (int32 Row = 0; Row < Size; ++Row)
+			{
+				const double Factor = InOutMatrix[Row][Pivot];
+				if (Row != Pivot && Factor != 0.0)
+				{
+					for (int32 Column = 0; Column < Size; ++Column)
+					{
+						InOutMatrix[Row][Column] -= Factor * InOutMatrix[Pivot][Column];
+						Inverse[Row][Column] -= Factor * Inverse[Pivot][Column];
+					}
+				}
+			}
+		}
+
+		FMemory::Memcpy(InOutMatrix, Inverse, sizeof(Inverse));
+		return true;
+	}
+
+	/**
+	 * Minimize |D2 x|^2 + Epsilon |x|^2 subject to C x = e, D2 being the second derivatives at the keys, divided
+	 * differences over the key intervals, and C the seam constraints. With H = D2^T D2 + Epsilon I the solution is
+	 * x = H^-1 C^T (C H^-1 C^T)^-1 e: H is pentadiagonal, its band Cholesky factor and H^-1 C^T only depend on the key
+	 * times and are shared by the channels.
+	 */
+	class FSeamSystem
+	{
+	public:
+		FSeamSystem(TConstArrayView<float> InTimes, bool bInIsAdditive)
+			: Times(InTimes)
+			, bIsAdditive(bInIsAdditive)
+		{
+			const int32 NumKeys = Times.Num();
+			if (NumKeys < 4)
+			{
+				return;
+			}
+
+			for (int32 Key = 1; Key < NumKeys; ++Key)
+			{
+				if (Times[Key] - Times[Key - 1] <= UE_KINDA_SMALL_NUMBER)
+				{
+					return;
+				}
+			}
+			const double StartInterval = Times[1] - Times[0];
+			const double EndInterval = Times[NumKeys - 1] - Times[NumKeys - 2];
+
+			NumConstraints = bIsAdditive ? 2 : 3;
+			Constraints.SetNumZeroed(NumConstraints * NumKeys);
+			if (bIsAdditive)
+			{
+				// The last delta leads into the first one, the sum of the deltas is the motion of the cycle.
+				GetConstraint(0)[NumKeys - 1] = 1.0;
+				GetConstraint(0)[0] = -1.0;
+				for (double& Coefficient : GetConstraint(1))
+				{
+					Coefficient = 1.0;
+				}
+			}
+			else
+			{
+				// The start stays, the end is placed, and the end velocity matches the start velocity.
+				GetConstraint(0)[0] = 1.0;
+				GetConstraint(1)[NumKeys - 1] = 1.0;
+				GetConstraint(2)[NumKeys - 1] = 1.0 / EndInterval;
+				GetConstraint(2)[NumKeys - 2] = -1.0 / EndInterval;
+				GetConstraint(2)[1] = -1.0 / StartInterval;
+				GetConstraint(2)[0] = 1.0 / StartInterval;
+			}
+
+			if (!Factor())
+			{
+				NumConstraints = 0;
+				return;
+			}
+
+			InvHCt = Constraints;
+			for (int32 Constraint = 0; Constraint < NumConstraints; ++Constraint)
+			{
+				SolveFactored(GetInvHCt(Constraint));
+			}
+
+			for (int32 Row = 0; Row < NumConstraints; ++Row)
+			{
+				for (int32 Column = 0; Column < NumConstraints; ++Column)
+				{
+					double Dot = 0.0;
+					for (int32 Key = 0; Key < NumKeys; ++Key)
+					{
+						Dot += Constraints[Row * NumKeys + Key] * InvHCt[Column * NumKeys + Key];
+					}
+					InvSchur[Row][Column] = Dot;
+				}
+			}
+			if (!InvertSmallMatrix(NumConstraints, InvSchur))
+			{
+				NumConstraints = 0;
+			}
+		}
+
+		bool IsValid() const { return NumConstraints > 0; }
+		const TArray<float>& GetTimes() const { return Times; }
+
+		/**
+		 * Correction to add to the values of one channel, the rotations have to be unwound.
+		 * @param TargetEndVelocity	Velocity the end is brought to, the start velocity if unset. Ignored for additive keys.
+		 */
+		void Solve(TConstArrayView<double> Values, bool bTravels, TOptional<double> TargetEndVelocity, TArray<double>& OutCorrection) const
+		{
+			const int32 NumKeys = Times.Num();
+			double Errors[MaxConstraints] = {};
+			if (bIsAdditive)
+			{
+				double Sum = 0.0;
+				for (const double Value : Values)
+				{
+					Sum += Value;
+				}
+				Errors[0] = Values[0] - Values[NumKeys - 1];
+				Errors[1] = bTravels ? 0.0 : -Sum;
+			}
+			else
+			{
+				const double StartVelocity = (Values[1] - Values[0]) / (Times[1] - Times[0]);
+				const double EndVelocity = (Values[NumKeys - 1] - Values[NumKeys - 2]) / (Times[NumKeys - 1] - Times[NumKeys - 2]);
+				Errors[0] = 0.0;
+				Errors[1] = bTravels ? 0.0 : Values[0] - Values[NumKeys - 1];
+				Errors[2] = TargetEndVelocity.Get(StartVelocity) - EndVelocity;
+			}
+
+			OutCorrection.SetNumZeroed(NumKeys);
+			for (int32 Constraint = 0; Constraint < NumConstraints; ++Constraint)
+			{
+				double Multiplier = 0.0;
+				for (int32 Column = 0; Column < NumConstraints; ++Column)
+				{
+					Multiplier += InvSchur[Constraint][Column] * Errors[Column];
+				}
+				if (Multiplier != 0.0)
+				{
+					const double* Column = &InvHCt[Constraint * NumKeys];
+					for (int32 Key = 0; Key < NumKeys; ++Key)
+					{
+						OutCorrection[Key] += Multiplier * Column[Key];
+					}
+				}
+			}
+		}
+
+	private:
+		TArrayView<double> GetConstraint(int32 Index) { return TArrayView<double>(Constraints).Slice(Index * Times.Num(), Times.Num()); }
+		TArrayView<double> GetInvHCt(int32 Index) { return TArrayView<double>(InvHCt).Slice(Index * Times.Num(), Times.Num()); }
+
+		/** Band Cholesky of H, L has the diagonal and the two subdiagonals. */
+		bool Factor()
+		{
+			// Only there to make H invertible, the constraints already pin the straight lines D2 doesn't see.
+			constexpr double Epsilon = 1.e-6;
+
+			const int32 NumKeys = Times.Num();
+			// Scaled by the squared mean interval, evenly spaced keys give the rows (1, -2, 1) and H stays well
+			// conditioned whatever the frame rate.
+			const double MeanInterval = (Times[NumKeys - 1] - Times[0]) / (NumKeys - 1);
+			const double Scale = 2.0 * MeanInterval * MeanInterval;
+
+			TArray<double> H0;
+			TArray<double> H1;
+			TArray<double> H2;
+			H0.Init(Epsilon, NumKeys);
+			H1.SetNumZeroed(NumKeys);
+			H2.SetNumZeroed(NumKeys);
+			for (int32 Row = 0; Row + 2 < NumKeys; ++Row)
+			{
+				// The row (A, B, C) at Row is the second derivative at Row + 1, H(i, j) is stored at the larger index.
+				const double Before = Times[Row + 1] - Times[Row];
+				const double After = Times[Row + 2] - Times[Row + 1];
+				const double A = Scale / (Before * (Before + After));
+				const double B = -Scale / (Before * After);
+				const double C = Scale / (After * (Before + After));
+				H0[Row] += A * A;
+				H0[Row + 1] += B * B;
+				H0[Row + 2] += C * C;
+				H1[Row + 1] += A * B;
+				H1[Row + 2] += B * C;
+				H2[Row + 2] += A * C;
+			}
+
+			L0.SetNumZeroed(NumKeys);
+			L1.SetNumZeroed(NumKeys);
+			L2.SetNumZeroed(NumKeys);
+			for (int32 Index = 0; Index < NumKeys; ++Index)
+			{
+				if (Index >= 2)
+				{
+					L2[Index] = H2[Index] / L0[Index - 2];
+				}
+				if (Index >= 1)
+				{
+					L1[Index] = (H1[Index] - (Index >= 2 ? L2[Index] * L1[Index - 1] : 0.0)) / L0[Index - 1];
+				}
+				const double Diagonal = H0[Index] - L1[Index] * L1[Index] - L2[Index] * L2[Index];
+				if (Diagonal <= 0.0)
+				{
+					return false;
+				}
+				L0[Index] = FMath::Sqrt(Diagonal);
+			}
+			return true;
+		}
+
+		void SolveFactored(TArrayView<double> InOutValues) const
+		{
+			const int32 NumKeys = InOutValues.Num();
+			for (int32 Index = 0; Index < NumKeys; ++Index)
+			{
+				double Value = InOutValues[Index];
+				Value -= Index >= 1 ? L1[Index] * InOutValues[Index - 1] : 0.0;
+				Value -= Index >= 2 ? L2[Index] * InOutValues[Index - 2] : 0.0;
+				InOutValues[Index] = Value / L0[Index];
+			}
+			for (int32 Index = NumKeys - 1; Index >= 0; --Index)
+			{
+				double Value = InOutValues[Index];
+				Value -= Index + 1 < NumKeys ? L1[Index + 1] * InOutValues[Index + 1] : 0.0;
+				Value -= Index + 2 < NumKeys ? L2[Index + 2] * InOutValues[Index + 2] : 0.0;
+				InOutValues[Index] = Value / L0[Index];
+			}
+		}
+
+		TArray<float> Times;
+		bool bIsAdditive = false;
+		int32 NumConstraints = 0;
+		/** One row of NumKeys per constraint. */
+		TArray<double> Constraints;
+		/** H^-1 C^T, one column of C^T per row. */
+		TArray<double> InvHCt;
+		double InvSchur[MaxConstraints][MaxConstraints] = {};
+		TArray<double> L0;
+		TArray<double> L1;
+		TArray<double> L2;
+	};
+
+	struct FChannelKeys
+	{
+		int32 Channel = INDEX_NONE;
+		int32 FirstKey = 0;
+		int32 NumKeys = 0;
+		int32 System = INDEX_NONE;
+	};
+
+	/** Velocity over the first two keys of the range. */
+	static FVector2D GetStartVelocity(const FTransformCurve& InCurve, const FChannelKeys& XKeys, const FChannelKeys& YKeys)
+	{
+		const TArray<FRichCurveKey>& X = FRMECurveHistory::GetChannel(InCurve, XKeys.Channel).Keys;
+		const TArray<FRichCurveKey>& Y = FRMECurveHistory::GetChannel(InCurve, YKeys.Channel).Keys;
+		const int32 FirstX = XKeys.FirstKey;
+		const int32 FirstY = YKeys.FirstKey;
+		return FVector2D(
+			(X[FirstX + 1].Value - X[FirstX].Value) / (X[FirstX + 1].Time - X[FirstX].Time),
+			(Y[FirstY + 1].Value - Y[FirstY].Value) / (Y[FirstY + 1].Time - Y[FirstY].Time));
+	}
+
+	/** Yaw turned from the start to the end of the range, in degrees, counting the full turns. */
+	static double GetNetYaw(const FTransformCurve& InCurve, const FRMECurveOperationRange& Range)
+	{
+		const TArray<FRichCurveKey>& Keys = FRMECurveHistory::GetChannel(InCurve, 5).Keys;
+		const int32 FirstKey = Algo::LowerBoundBy(Keys, Range.StartTime, &FRichCurveKey::Time);
+		const int32 EndKey = Algo::UpperBoundBy(Keys, Range.EndTime, &FRichCurveKey::Time);
+		double NetYaw = 0.0;
+		for (int32 Key = FirstKey + 1; Key < EndKey; ++Key)
+		{
+			NetYaw += FMath::UnwindDegrees(static_cast<double>(Keys[Key].Value) - Keys[Key - 1].Value);
+		}
+		return NetYaw;
+	}
+
+	void Solve(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RMELoopSeam::Solve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
+		// The channels keyed at the same times share one system, the bakes key all of them together.
+		TArray<FSeamSystem> Systems;
+		TArray<FChannelKeys, TInlineAllocator<FRMECurveHistory::NumChannels>> Channels;
+		TArray<float> Times;
+		for (int32 Channel = 0; Channel < FRMECurveHistory::NumChannels; ++Channel)
+		{
+			const TArray<FRichCurveKey>& Keys = FRMECurveHistory::GetChannel(InOutCurve, Channel).Keys;
+			FChannelKeys ChannelKeys;
+			ChannelKeys.Channel = Channel;
+			ChannelKeys.FirstKey = Algo::LowerBoundBy(Keys, Range.StartTime, &FRichCurveKey::Time);
+			ChannelKeys.NumKeys = Algo::UpperBoundBy(Keys, Range.EndTime, &FRichCurveKey::Time) - ChannelKeys.FirstKey;
+			if (ChannelKeys.NumKeys < 4)
+			{
+				continue;
+			}
+
+			Times.SetNumUninitialized(ChannelKeys.NumKeys);
+			for (int32 Index = 0; Index < ChannelKeys.NumKeys; ++Index)
+			{
+				Times[Index] = Keys[ChannelKeys.FirstKey + Index].Time;
+			}
+
+			ChannelKeys.System = Systems.IndexOfByPredicate([&Times](const FSeamSystem& System)
+			{
+				return System.GetTimes() == Times;
+			});
+			if (ChannelKeys.System == INDEX_NONE)
+			{
+				ChannelKeys.System = Systems.Emplace(Times, Range.bIsAdditiveCurve);
+			}
+			if (Systems[ChannelKeys.System].IsValid())
+			{
+				Channels.Add(ChannelKeys);
+			}
+		}
+
+		// The translation is in world space: a cycle that turns ends with the start velocity turned by the yaw of the
+		// cycle, not the start velocity itself. Additive keys are deltas in the frame of the previous key already.
+		TOptional<double> TargetEndVelocities[FRMECurveHistory::NumChannels];
+		const FChannelKeys* XKeys = Channels.FindByPredicate([](const FChannelKeys& Keys) { return Keys.Channel == 0; });
+		const FChannelKeys* YKeys = Channels.FindByPredicate([](const FChannelKeys& Keys) { return Keys.Channel == 1; });
+		if (!Range.bIsAdditiveCurve && XKeys != nullptr && YKeys != nullptr)
+		{
+			const FVector2D StartVelocity = GetStartVelocity(InOutCurve, *XKeys, *YKeys);
+			const FVector2D EndVelocity = StartVelocity.GetRotated(static_cast<FVector2D::FReal>(GetNetYaw(InOutCurve, Range)));
+			TargetEndVelocities[0] = EndVelocity.X;
+			TargetEndVelocities[1] = EndVelocity.Y;
+		}
+
+		const bool bCarry = Range.bCarryFollowingKeys && !Range.bIsAdditiveCurve;
+		ParallelFor(Channels.Num(), [&InOutCurve, &Systems, &Channels, &Range, &TargetEndVelocities, bCarry](int32 Index)
+		{
+			LLM_SCOPE_BYTAG(RootMotionEditor);
+			const FChannelKeys& ChannelKeys = Channels[Index];
+			FRichCurve& Channel = FRMECurveHistory::GetChannel(InOutCurve, ChannelKeys.Channel);
+			TArray<FRichCurveKey>& Keys = Channel.Keys;
+
+			// Euler angles jump by 360 degrees where they wrap, the seam is measured on the continuous angle.
+			const bool bIsRotation = ChannelKeys.Channel / 3 == 1 && !Range.bIsAdditiveCurve;
+			TArray<double> Values;
+			Values.SetNumUninitialized(ChannelKeys.NumKeys);
+			for (int32 Key = 0; Key < ChannelKeys.NumKeys; ++Key)
+			{
+				const double Value = Keys[ChannelKeys.FirstKey + Key].Value;
+				Values[Key] = Key > 0 && bIsRotation ? Values[Key - 1] + FMath::UnwindDegrees(Value - Values[Key - 1]) : Value;
+			}
+
+			TArray<double> Correction;
+			Systems[ChannelKeys.System].Solve(Values, IsTravelingChannel(ChannelKeys.Channel), TargetEndVelocities[ChannelKeys.Channel], Correction);
+			for (int32 Key = 0; Key < ChannelKeys.NumKeys; ++Key)
+			{
+				Keys[ChannelKeys.FirstKey + Key].Value += static_cast<float>(Correction[Key]);
+			}
+			if (bCarry)
+			{
+				const float EndCorrection = static_cast<float>(Correction.Last());
+				for (int32 Key = ChannelKeys.FirstKey + ChannelKeys.NumKeys; Key < Keys.Num(); ++Key)
+				{
+					Keys[Key].Value += EndCorrection;
+				}
+			}
+			Channel.AutoSetTangents();
+		});
+	}
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMECurveOperations.h"
+
+struct FTransformCurve;
+
+/**
+ * Loop seam of the edited root motion curve, the keys of the range are one cycle of a looping clip.
+ * The error between the end and the start of the cycle is spread over the whole cycle by the smallest correction
+ * in the least squares sense: the sum of its squared second derivatives at the keys, under the seam constraints.
+ * The derivatives are taken over the key intervals, so a resampled or hand keyed range is smoothed like a baked one.
+ * Every channel solves the same banded system, it's factored once per set of key times and solved for all the
+ * constraints together, then each channel only solves a system as small as its constraints.
+ */
+namespace RMELoopSeam
+{
+	/**
+	 * Match the velocity at the end of the range to the one at the start, turned by the yaw of the cycle for the
+	 * horizontal translation. The channels that don't travel (height, roll, pitch and scale) also end where they
+	 * start, the others keep the distance and turn of the cycle.
+	 * Additive keys are velocities already: the last delta is matched to the first one, and the sum of the deltas
+	 * is kept, or brought to zero for the channels that don't travel.
+	 */
+	void Solve(FTransformCurve& InOutCurve, const FRMECurveOperationRange& Range);
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEPerfCounters.h"
+
+#define LOCTEXT_NAMESPACE "RMEPerfCounters"
+
+
+namespace RMEPerfCounters
+{
+	static constexpr double RefreshPeriod = 0.5;
+
+	static FText AsDecimal(double Value)
+	{
+		static const FNumberFormattingOptions Options = FNumberFormattingOptions().SetMinimumFractionalDigits(2).SetMaximumFractionalDigits(2);
+		return FText::AsNumber(Value, &Options);
+	}
+
+	static FText AsHitRate(const FRMECacheCounter& InPrevious, const FRMECacheCounter& InCurrent)
+	{
+		const uint64 NumLookups = InCurrent.Num() - InPrevious.Num();
+		if (NumLookups == 0)
+		{
+			return LOCTEXT("NoLookup", "-");
+		}
+
+		const double HitRate = static_cast<double>(InCurrent.Hits - InPrevious.Hits) / NumLookups;
+		return FText::Format(LOCTEXT("HitRateFormat", "{0}% of {1}"), FText::AsNumber(FMath::RoundToInt(HitRate * 100.0)), FText::AsNumber(NumLookups));
+	}
+}
+
+void FRMEPerfHUD::Update(const FRMEPerfCounters& InCounters)
+{
+	const double Now = FPlatformTime::Seconds();
+	if (bHasCounters && Now - LastUpdateTime < RMEPerfCounters::RefreshPeriod)
+	{
+		return;
+	}
+
+	Text = bHasCounters
+		? BuildText(LastCounters, InCounters, Now - LastUpdateTime)
+		: LOCTEXT("Measuring", "Measuring...");
+
+	LastCounters = InCounters;
+	LastUpdateTime = Now;
+	bHasCounters = true;
+}
+
+FText FRMEPerfHUD::BuildText(const FRMEPerfCounters& InPrevious, const FRMEPerfCounters& InCurrent, double InElapsedSeconds)
+{
+	const uint64 NumFrames = InCurrent.Frames - InPrevious.Frames;
+	if (NumFrames == 0 || InElapsedSeconds <= 0.0)
+	{
+		return LOCTEXT("NoFrame", "No viewport frame drawn.");
+	}
+
+	const uint64 NumPreviewTicks = InCurrent.PreviewTicks - InPrevious.PreviewTicks;
+	const double PreviewTickMs = NumPreviewTicks > 0 ? (InCurrent.PreviewTickSeconds - InPrevious.PreviewTickSeconds) * 1000.0 / NumPreviewTicks : 0.0;
+
+	FFormatNamedArguments Args;
+	Args.Add(TEXT("Fps"), RMEPerfCounters::AsDecimal(NumFrames / InElapsedSeconds));
+	Args.Add(TEXT("FrameMs"), RMEPerfCounters::AsDecimal(InElapsedSeconds * 1000.0 / NumFrames));
+	Args.Add(TEXT("Evaluations"), RMEPerfCounters::AsDecimal(static_cast<double>(InCurrent.RootMotionEvaluations - InPrevious.RootMotionEvaluations) / NumFrames));
+	Args.Add(TEXT("DrawMs"), RMEPerfCounters::AsDecimal((InCurrent.DrawRootMotionDataSeconds - InPrevious.DrawRootMotionDataSeconds) * 1000.0 / NumFrames));
+	Args.Add(TEXT("Primitives"), FText::AsNumber((InCurrent.DrawnPrimitives - InPrevious.DrawnPrimitives) / NumFrames));
+	Args.Add(TEXT("PreviewTickMs"), RMEPerfCounters::AsDecimal(PreviewTickMs));
+	Args.Add(TEXT("TrajectoryHits"), RMEPerfCounters::AsHitRate(InPrevious.TrajectoryCache, InCurrent.TrajectoryCache));
+	Args.Add(TEXT("GhostPoseHits"), RMEPerfCounters::AsHitRate(InPrevious.GhostPoseCache, InCurrent.GhostPoseCache));
+	Args.Add(TEXT("ScrubPoseHits"), RMEPerfCounters::AsHitRate(InPrevious.ScrubPoseCache, InCurrent.ScrubPoseCache));
+
+	return FText::Format(LOCTEXT("PerfHUDFormat",
+		"Viewport: {Fps} fps, {FrameMs} ms / frame\n"
+		"Root motion evaluations: {Evaluations} / frame\n"
+		"DrawRootMotionData: {DrawMs} ms, {Primitives} primitives / frame\n"
+		"Preview world tick: {PreviewTickMs} ms\n"
+		"Cache hits: trajectory {TrajectoryHits}, ghost poses {GhostPoseHits}, scrub poses {ScrubPoseHits}"), Args);
+}
+
+#undef LOCTEXT_NAMESPACE
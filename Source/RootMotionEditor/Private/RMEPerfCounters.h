@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Lookups of one cache since the session started. */
+struct FRMECacheCounter
+{
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+
+	void Record(bool bHit) { bHit ? ++Hits : ++Misses; }
+	uint64 Num() const { return Hits + Misses; }
+};
+
+/**
+ * Cumulative counters of one editor session. They only grow, the performance HUD turns the difference
+ * between two reads into per frame values.
+ */
+struct FRMEPerfCounters
+{
+	/** Viewport draws. */
+	uint64 Frames = 0;
+
+	/** Counted on the game thread only, the evaluations of the ghost poses show up as ghost pose cache misses. */
+	uint64 RootMotionEvaluations = 0;
+
+	double DrawRootMotionDataSeconds = 0.0;
+	/** Points, lines and arrows of the trajectories, the current root motion and the ghost poses. */
+	uint64 DrawnPrimitives = 0;
+
+	FRMECacheCounter TrajectoryCache;
+	FRMECacheCounter GhostPoseCache;
+	/** A miss means the preview mesh evaluated the animation itself. */
+	FRMECacheCounter ScrubPoseCache;
+
+	/** Ticks of the preview world, filled by FRMEViewModel::GetPerfCountersSnapshot. */
+	uint64 PreviewTicks = 0;
+	double PreviewTickSeconds = 0.0;
+};
+
+/**
+ * Text of the viewport performance HUD, per frame averages refreshed a few times per second
+ * so the numbers are readable, and can be read from a screenshot.
+ */
+class FRMEPerfHUD
+{
+public:
+	void Update(const FRMEPerfCounters& InCounters);
+	const FText& GetText() const { return Text; }
+
+private:
+	static FText BuildText(const FRMEPerfCounters& InPrevious, const FRMEPerfCounters& InCurrent, double InElapsedSeconds);
+
+private:
+	FRMEPerfCounters LastCounters;
+	double LastUpdateTime = 0.0;
+	bool bHasCounters = false;
+	FText Text;
+};
@@ -0,0 +1,244 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMEPoseCache.h"
+#include "BonePose.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/AttributesRuntime.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "RMETypes.h"
+
+
+void FRMEPoseCache::Reset()
+{
+	AnimationPtr = nullptr;
+	CacheKey = 0;
+	Poses.Reset();
+	ParentIndices.Reset();
+	MeshBoneIndices.Reset();
+}
+
+SIZE_T FRMEPoseCache::GetAllocatedSize() const
+{
+	SIZE_T Size = Poses.GetAllocatedSize() + ParentIndices.GetAllocatedSize() + MeshBoneIndices.GetAllocatedSize();
+	for (const FRMECachedPose& Pose : Poses)
+	{
+		Size += Pose.ComponentSpaceTransforms.GetAllocatedSize();
+	}
+	return Size;
+}
+
+bool FRMEPoseCache::IsValidFor(const UAnimSequence* InAnimation, uint32 InCacheKey) const
+{
+	return InAnimation != nullptr && AnimationPtr.Get() == InAnimation && CacheKey == InCacheKey;
+}
+
+void FRMEPoseCache::Evaluate(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer, TConstArrayView<double> InTimes, uint32 InCacheKey,
+	TFunctionRef<FTransform(double)> GetRootMotionTransform)
+{
+	Reset();
+
+	if (InAnimation == nullptr || !InBoneContainer.IsValid())
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	AnimationPtr = InAnimation;
+	CacheKey = InCacheKey;
+
+	const int32 NumBones = InBoneContainer.GetCompactPoseNumBones();
+	ParentIndices.SetNumUninitialized(NumBones);
+	MeshBoneIndices.SetNumUninitialized(NumBones);
+	for (int32 Index = 0; Index < NumBones; ++Index)
+	{
+		const FCompactPoseBoneIndex BoneIndex(Index);
+		ParentIndices[Index] = Index > 0 ? InBoneContainer.GetParentBoneIndex(BoneIndex).GetInt() : INDEX_NONE;
+		MeshBoneIndices[Index] = InBoneContainer.MakeMeshPoseIndex(BoneIndex).GetInt();
+	}
+
+	Poses.SetNum(InTimes.Num());
+	ParallelFor(InTimes.Num(), [this, InAnimation, &InBoneContainer, InTimes, &GetRootMotionTransform](int32 PoseIndex)
+	{
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
+		FRMECachedPose& Pose = Poses[PoseIndex];
+		Pose.Time = InTimes[PoseIndex];
+		Pose.RootMotionTransform = GetRootMotionTransform(Pose.Time);
+		EvaluateComponentSpacePose(InAnimation, InBoneContainer, Pose.Time, true, Pose.ComponentSpaceTransforms);
+	});
+}
+
+void FRMEPoseCache::EvaluateComponentSpacePose(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer, double InTime, bool bExtractRootMotion, TArray<FTransform>& OutTransforms)
+{
+	// Compact poses are allocated on the mem stack of the calling thread.
+	FMemMark Mark(FMemStack::Get());
+
+	FCompactPose Pose;
+	Pose.SetBoneContainer(&InBoneContainer);
+	Pose.ResetToRefPose();
+
+	FBlendedCurve Curve;
+	Curve.InitFrom(InBoneContainer);
+	UE::Anim::FStackAttributeContainer Attributes;
+	FAnimationPoseData PoseData(Pose, Curve, Attributes);
+
+	const FAnimExtractContext ExtractContext(InTime, bExtractRootMotion);
+	InAnimation->GetAnimationPose(PoseData, ExtractContext);
+
+	const int32 NumBones = Pose.GetNumBones();
+	OutTransforms.SetNumUninitialized(NumBones);
+	for (const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+	{
+		const int32 Index = BoneIndex.GetInt();
+		const FCompactPoseBoneIndex ParentIndex = Pose.GetParentBoneIndex(BoneIndex);
+
+		// Parents always come before their children in the compact pose.
+		OutTransforms[Index] = ParentIndex.IsValid() ? Pose[BoneIndex] * OutTransforms[ParentIndex.GetInt()] : Pose[BoneIndex];
+	}
+}
+
+
+FRMEScrubPoseCache::~FRMEScrubPoseCache()
+{
+	Reset();
+}
+
+void FRMEScrubPoseCache::Reset()
+{
+	if (Data.IsValid())
+	{
+		Data->bCancelled = true;
+	}
+
+	if (BuildTask.IsValid())
+	{
+		BuildTask.Wait();
+		BuildTask.Reset();
+	}
+
+	Data.Reset();
+}
+
+void FRMEScrubPoseCache::Build(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer)
+{
+	if (InAnimation == nullptr || !InBoneContainer.IsValid() || IsBuiltFor(InAnimation))
+	{
+		return;
+	}
+
+	Reset();
+
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	Data = MakeShared<FBuildData, ESPMode::ThreadSafe>();
+	Data->AnimationPtr = InAnimation;
+	Data->BoneContainer = InBoneContainer;
+	Data->Sampler = FRMEFrameSampler::ForAnimation(InAnimation);
+
+	const int32 NumBones = InBoneContainer.GetCompactPoseNumBones();
+	Data->MeshBoneIndices.SetNumUninitialized(NumBones);
+	for (int32 Index = 0; Index < NumBones; ++Index)
+	{
+		Data->MeshBoneIndices[Index] = InBoneContainer.MakeMeshPoseIndex(FCompactPoseBoneIndex(Index)).GetInt();
+	}
+
+	const int32 NumFrames = Data->Sampler.Num();
+	Data->Poses.SetNum(NumFrames);
+
+	// Reset() waits for the task before the preview changes its animation, but the asset can still be deleted
+	// under it, so the task only holds it weakly and drops the poses if it's gone.
+	BuildTask = Async(EAsyncExecution::ThreadPool, [BuildData = Data, NumFrames]()
+	{
+		const UAnimSequence* Animation = BuildData->AnimationPtr.Get();
+		if (Animation == nullptr)
+		{
+			return;
+		}
+
+		ParallelFor(NumFrames, [&BuildData, Animation](int32 Frame)
+		{
+			if (BuildData->bCancelled)
+			{
+				return;
+			}
+
+			LLM_SCOPE_BYTAG(RootMotionEditor);
+
+			// The scrub poses stand in for the pose of the preview instance, which keeps the root bone track.
+			const double Time = BuildData->Sampler.GetTime(Frame);
+			FRMEPoseCache::EvaluateComponentSpacePose(Animation, BuildData->BoneContainer, Time, false, BuildData->Poses[Frame]);
+		});
+
+		if (!BuildData->bCancelled && BuildData->AnimationPtr.IsValid())
+		{
+			BuildData->bReady = true;
+		}
+	});
+}
+
+bool FRMEScrubPoseCache::IsBuiltFor(const UAnimSequence* InAnimation) const
+{
+	return Data.IsValid() && InAnimation != nullptr && Data->AnimationPtr.Get() == InAnimation;
+}
+
+bool FRMEScrubPoseCache::IsReady() const
+{
+	return Data.IsValid() && Data->bReady;
+}
+
+bool FRMEScrubPoseCache::GetPose(double InTime, TArray<FTransform>& OutTransforms) const
+{
+	if (!IsReady() || Data->Poses.Num() == 0)
+	{
+		return false;
+	}
+
+	const int32 LastFrame = Data->Poses.Num() - 1;
+	const double FrameTime = FMath::Clamp(Data->Sampler.GetFrameRate().AsFrameTime(InTime).AsDecimal(), 0.0, static_cast<double>(LastFrame));
+	const int32 Frame = FMath::FloorToInt32(FrameTime);
+	const int32 NextFrame = FMath::Min(Frame + 1, LastFrame);
+	const float Alpha = static_cast<float>(FrameTime - Frame);
+
+	const TArray<FTransform>& Pose = Data->Poses[Frame];
+	if (Alpha <= UE_KINDA_SMALL_NUMBER || Frame == NextFrame)
+	{
+		OutTransforms = Pose;
+		return true;
+	}
+
+	const TArray<FTransform>& NextPose = Data->Poses[NextFrame];
+	OutTransforms.SetNumUninitialized(Pose.Num());
+	for (int32 Index = 0; Index < Pose.Num(); ++Index)
+	{
+		OutTransforms[Index].Blend(Pose[Index], NextPose[Index], Alpha);
+	}
+	return true;
+}
+
+const TArray<int32>& FRMEScrubPoseCache::GetMeshBoneIndices() const
+{
+	static const TArray<int32> Empty;
+	return Data.IsValid() ? Data->MeshBoneIndices : Empty;
+}
+
+SIZE_T FRMEScrubPoseCache::GetAllocatedSize() const
+{
+	if (!Data.IsValid())
+	{
+		return 0;
+	}
+
+	SIZE_T Size = sizeof(FBuildData) + Data->Poses.GetAllocatedSize() + Data->MeshBoneIndices.GetAllocatedSize();
+	if (Data->bReady)
+	{
+		for (const TArray<FTransform>& Pose : Data->Poses)
+		{
+			Size += Pose.GetAllocatedSize();
+		}
+	}
+	return Size;
+}
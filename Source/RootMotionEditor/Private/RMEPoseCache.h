@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoneContainer.h"
+#include "Async/Future.h"
+#include "RMEFrameSampler.h"
+#include <atomic>
+
+class UAnimSequence;
+
+/** One evaluated pose, bone transforms are in component space and in compact pose order. */
+struct FRMECachedPose
+{
+	double Time = 0.0;
+	FTransform RootMotionTransform = FTransform::Identity;
+	TArray<FTransform> ComponentSpaceTransforms;
+};
+
+/**
+ * Buffer of poses evaluated straight from the anim sequence, without going through the preview anim instance.
+ * The poses are evaluated in parallel and kept until the animation or the cache key changes.
+ */
+class FRMEPoseCache
+{
+public:
+	void Reset();
+
+	bool IsValidFor(const UAnimSequence* InAnimation, uint32 InCacheKey) const;
+
+	/**
+	 * Evaluate one pose per time in parallel.
+	 * @param GetRootMotionTransform	Returns the root motion at a given time, it's called from worker threads.
+	 */
+	void Evaluate(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer, TConstArrayView<double> InTimes, uint32 InCacheKey,
+		TFunctionRef<FTransform(double)> GetRootMotionTransform);
+
+	const TArray<FRMECachedPose>& GetPoses() const { return Poses; }
+	const TArray<int32>& GetParentIndices() const { return ParentIndices; }
+	const TArray<int32>& GetMeshBoneIndices() const { return MeshBoneIndices; }
+
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Thread safe, evaluate the animation at the time and accumulate the local pose to component space.
+	 * @param bExtractRootMotion	Lock the root bone, for callers that apply the root motion themselves.
+	 */
+	static void EvaluateComponentSpacePose(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer, double InTime, bool bExtractRootMotion, TArray<FTransform>& OutTransforms);
+
+private:
+	TWeakObjectPtr<const UAnimSequence> AnimationPtr;
+	uint32 CacheKey = 0;
+
+	TArray<FRMECachedPose> Poses;
+	/** Parent of each compact bone, INDEX_NONE for the root. */
+	TArray<int32> ParentIndices;
+	/** Skeletal mesh bone index of each compact bone. */
+	TArray<int32> MeshBoneIndices;
+};
+
+/**
+ * Component space pose of every frame of an animation, filled once by a background task.
+ * While scrubbing, the preview mesh only copies a cached pose instead of evaluating the animation.
+ */
+class FRMEScrubPoseCache
+{
+public:
+	~FRMEScrubPoseCache();
+
+	/** Cancel the background task if any, and wait for it before dropping the poses. */
+	void Reset();
+
+	/** Start filling the cache in the background, does nothing if it's already built or building for this animation. */
+	void Build(const UAnimSequence* InAnimation, const FBoneContainer& InBoneContainer);
+
+	bool IsBuiltFor(const UAnimSequence* InAnimation) const;
+	bool IsReady() const;
+
+	/** Pose at the time, blended between the two nearest cached frames. False if the cache isn't ready yet. */
+	bool GetPose(double InTime, TArray<FTransform>& OutTransforms) const;
+
+	/** Skeletal mesh bone index of each compact bone of the cached poses. */
+	const TArray<int32>& GetMeshBoneIndices() const;
+
+	/** The poses are only counted once the build is done, the workers are still filling them before that. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FBuildData
+	{
+		TWeakObjectPtr<const UAnimSequence> AnimationPtr;
+		FBoneContainer BoneContainer;
+		FRMEFrameSampler Sampler;
+
+		TArray<TArray<FTransform>> Poses;
+		TArray<int32> MeshBoneIndices;
+
+		std::atomic<bool> bCancelled = false;
+		std::atomic<bool> bReady = false;
+	};
+
+	TSharedPtr<FBuildData, ESPMode::ThreadSafe> Data;
+	TFuture<void> BuildTask;
+};
@@ -27,6 +27,8 @@ FRMEPreviewScene::FRMEPreviewScene(ConstructionValues CVs) : FAdvancedPreviewSce
 
 void FRMEPreviewScene::Tick(float InDeltaTime)
 {
+	const double StartTime = FPlatformTime::Seconds();
+
 	FAdvancedPreviewScene::Tick(InDeltaTime);
 
 	// Trigger Begin Play in this preview world.
@@ -43,4 +45,7 @@ void FRMEPreviewScene::Tick(float InDeltaTime)
 	}
 
 	GetWorld()->Tick(LEVELTICK_All, InDeltaTime);
+
+	++NumTicks;
+	TotalTickSeconds += FPlatformTime::Seconds() - StartTime;
 }
@@ -16,4 +16,11 @@ public:
 
 	virtual void Tick(float InDeltaTime) override;
 
+	/** Ticks of the preview world since the scene was created, for the performance HUD. */
+	uint64 GetNumTicks() const { return NumTicks; }
+	double GetTotalTickSeconds() const { return TotalTickSeconds; }
+
+private:
+	uint64 NumTicks = 0;
+	double TotalTickSeconds = 0.0;
 };
@@ -0,0 +1,339 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMERootMotionLibrary.h"
+#include "RMECurveOperations.h"
+#include "RMETypes.h"
+#include "ScopedTransaction.h"
+#include "Async/AsyncFileHandle.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#define LOCTEXT_NAMESPACE "RMERootMotionLibrary"
+
+namespace RMERootMotionLibrary
+{
+	/** Bumped when the layout of an encoded entry changes, entries of another version don't decode. */
+	static constexpr uint8 EntryVersion = 1;
+	static constexpr int32 NumChannels = 9;
+
+	static const FRichCurve& GetChannel(const FTransformCurve& InCurve, int32 Channel)
+	{
+		const FVectorCurve& Curve = Channel < 3 ? InCurve.TranslationCurve : Channel < 6 ? InCurve.RotationCurve : InCurve.ScaleCurve;
+		return Curve.FloatCurves[Channel % 3];
+	}
+
+	static FRichCurve& GetChannel(FTransformCurve& InCurve, int32 Channel)
+	{
+		return const_cast<FRichCurve&>(GetChannel(const_cast<const FTransformCurve&>(InCurve), Channel));
+	}
+
+	/** One field of every key of a channel, written or read as a contiguous run. */
+	template<typename T, typename FieldType>
+	static void SerializeField(FArchive& Ar, TArray<FRichCurveKey>& Keys, FieldType FRichCurveKey::* Field)
+	{
+		TArray<T, TInlineAllocator<256>> Values;
+		Values.SetNumUninitialized(Keys.Num());
+		if (Ar.IsSaving())
+		{
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				Values[Index] = static_cast<T>(Keys[Index].*Field);
+			}
+		}
+
+		Ar.Serialize(Values.GetData(), Values.Num() * sizeof(T));
+
+		if (Ar.IsLoading())
+		{
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				Keys[Index].*Field = static_cast<FieldType>(Values[Index]);
+			}
+		}
+	}
+
+	/** False for a value that isn't one of the enum, the curve evaluation switches on the key modes. */
+	template<typename EnumType>
+	static bool IsValidEnumValue(int64 InValue)
+	{
+		const UEnum* Enum = StaticEnum<EnumType>();
+		return InValue < Enum->GetMaxEnumValue() && Enum->IsValidEnumValue(InValue);
+	}
+
+	/**
+	 * Channel header (default value, extrapolations, key count) then the keys field by field,
+	 * so every field of a channel is contiguous and compresses well.
+	 */
+	static void SerializeChannel(FArchive& Ar, FRichCurve& Channel)
+	{
+		uint8 PreInfinityExtrap = Channel.PreInfinityExtrap;
+		uint8 PostInfinityExtrap = Channel.PostInfinityExtrap;
+		int32 NumKeys = Channel.Keys.Num();
+		Ar << Channel.DefaultValue << PreInfinityExtrap << PostInfinityExtrap << NumKeys;
+
+		if (Ar.IsLoading())
+		{
+			// Each key takes at least 6 floats and 3 bytes, a larger count means the data is corrupted.
+			if (NumKeys < 0 || static_cast<int64>(NumKeys) * 27 > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				return;
+			}
+
+			if (PreInfinityExtrap > RCCE_None || PostInfinityExtrap > RCCE_None)
+			{
+				Ar.SetError();
+				return;
+			}
+
+			Channel.PreInfinityExtrap = static_cast<ERichCurveExtrapolation>(PreInfinityExtrap);
+			Channel.PostInfinityExtrap = static_cast<ERichCurveExtrapolation>(PostInfinityExtrap);
+			Channel.Keys.SetNum(NumKeys);
+		}
+
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::Time);
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::Value);
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::ArriveTangent);
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::LeaveTangent);
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::ArriveTangentWeight);
+		SerializeField<float>(Ar, Channel.Keys, &FRichCurveKey::LeaveTangentWeight);
+		SerializeField<uint8>(Ar, Channel.Keys, &FRichCurveKey::InterpMode);
+		SerializeField<uint8>(Ar, Channel.Keys, &FRichCurveKey::TangentMode);
+		SerializeField<uint8>(Ar, Channel.Keys, &FRichCurveKey::TangentWeightMode);
+
+		if (Ar.IsLoading())
+		{
+			for (const FRichCurveKey& Key : Channel.Keys)
+			{
+				if (!IsValidEnumValue<ERichCurveInterpMode>(Key.InterpMode.GetIntValue()) || !IsValidEnumValue<ERichCurveTangentMode>(Key.TangentMode.GetIntValue())
+					|| !IsValidEnumValue<ERichCurveTangentWeightMode>(Key.TangentWeightMode.GetIntValue()))
+				{
+					Ar.SetError();
+					return;
+				}
+			}
+		}
+	}
+}
+
+void URMERootMotionLibrary::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	if (Ar.IsSaving() && !Ar.IsTransacting())
+	{
+		// The keys stay in the package file until an entry is read, undo keeps them inline in the transaction.
+		Payload.SetBulkDataFlags(BULKDATA_Force_NOT_InlinePayload);
+	}
+	Payload.Serialize(Ar, this);
+
+	if (Ar.IsLoading())
+	{
+		RebuildIndexMap();
+	}
+}
+
+void URMERootMotionLibrary::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Entries.GetAllocatedSize() + IndexMap.GetAllocatedSize());
+
+	// The payload only takes memory once it's been loaded, reading an entry streams its range instead.
+	if (Payload.IsBulkDataLoaded())
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(Payload.GetBulkDataSize());
+	}
+}
+
+const FRMERootMotionLibraryEntry* URMERootMotionLibrary::FindEntry(FName InName) const
+{
+	const int32* Index = IndexMap.Find(InName);
+	return Index != nullptr ? &Entries[*Index] : nullptr;
+}
+
+bool URMERootMotionLibrary::ReadEntry(FName InName, FTransformCurve& OutCurve) const
+{
+	const FRMERootMotionLibraryEntry* Entry = FindEntry(InName);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	TArray<uint8> Bytes;
+	if (!ReadPayload(Entry->Offset, Entry->Size, Bytes) || !DecodeCurve(Bytes, OutCurve))
+	{
+		UE_LOG(LogRootMotionEditor, Error, TEXT("Failed to read the entry (%s) of the root motion library %s."), *InName.ToString(), *GetPathName());
+		return false;
+	}
+	return true;
+}
+
+void URMERootMotionLibrary::WriteEntry(FName InName, const FTransformCurve& InCurve)
+{
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+
+	const FScopedTransaction Transaction(FText::Format(LOCTEXT("WriteEntryTransaction", "Write Root Motion Library Entry {0}"), FText::FromName(InName)));
+	Modify();
+
+	TArray<uint8> OldPayload;
+	ReadPayload(0, Payload.GetBulkDataSize(), OldPayload);
+
+	TArray<uint8> EncodedCurve;
+	EncodeCurve(InCurve, EncodedCurve);
+
+	const int32* ExistingIndex = IndexMap.Find(InName);
+	FRMERootMotionLibraryEntry* NewEntry = ExistingIndex != nullptr ? &Entries[*ExistingIndex] : nullptr;
+	if (NewEntry == nullptr)
+	{
+		NewEntry = &Entries.AddDefaulted_GetRef();
+		NewEntry->Name = InName;
+	}
+
+	int32 NumKeys = 0;
+	for (int32 Channel = 0; Channel < RMERootMotionLibrary::NumChannels; ++Channel)
+	{
+		NumKeys = FMath::Max(NumKeys, RMERootMotionLibrary::GetChannel(InCurve, Channel).GetNumKeys());
+	}
+	const FRMECurveOperationRange KeyRange = RMECurveOperations::GetKeyRange(InCurve);
+	NewEntry->NumKeys = NumKeys;
+	NewEntry->StartTime = NumKeys > 0 ? KeyRange.StartTime : 0.f;
+	NewEntry->EndTime = NumKeys > 0 ? KeyRange.EndTime : 0.f;
+
+	// Repack every entry one after the other, the changed one takes its new bytes.
+	TArray<uint8> NewPayload;
+	NewPayload.Reserve(OldPayload.Num() + EncodedCurve.Num());
+	for (FRMERootMotionLibraryEntry& Entry : Entries)
+	{
+		const int64 NewOffset = NewPayload.Num();
+		if (&Entry == NewEntry)
+		{
+			NewPayload.Append(EncodedCurve);
+		}
+		else
+		{
+			NewPayload.Append(OldPayload.GetData() + Entry.Offset, Entry.Size);
+		}
+		Entry.Offset = NewOffset;
+		Entry.Size = NewPayload.Num() - NewOffset;
+	}
+
+	Payload.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(Payload.Realloc(NewPayload.Num()), NewPayload.GetData(), NewPayload.Num());
+	Payload.Unlock();
+
+	RebuildIndexMap();
+	MarkPackageDirty();
+}
+
+bool URMERootMotionLibrary::RemoveEntry(FName InName)
+{
+	const int32* Index = IndexMap.Find(InName);
+	if (Index == nullptr)
+	{
+		return false;
+	}
+
+	const FScopedTransaction Transaction(FText::Format(LOCTEXT("RemoveEntryTransaction", "Remove Root Motion Library Entry {0}"), FText::FromName(InName)));
+	Modify();
+
+	TArray<uint8> OldPayload;
+	ReadPayload(0, Payload.GetBulkDataSize(), OldPayload);
+
+	Entries.RemoveAt(*Index);
+
+	TArray<uint8> NewPayload;
+	NewPayload.Reserve(OldPayload.Num());
+	for (FRMERootMotionLibraryEntry& Entry : Entries)
+	{
+		const int64 NewOffset = NewPayload.Num();
+		NewPayload.Append(OldPayload.GetData() + Entry.Offset, Entry.Size);
+		Entry.Offset = NewOffset;
+	}
+
+	Payload.Lock(LOCK_READ_WRITE);
+	FMemory::Memcpy(Payload.Realloc(NewPayload.Num()), NewPayload.GetData(), NewPayload.Num());
+	Payload.Unlock();
+
+	RebuildIndexMap();
+	MarkPackageDirty();
+	return true;
+}
+
+void URMERootMotionLibrary::EncodeCurve(const FTransformCurve& InCurve, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+
+	uint8 Version = RMERootMotionLibrary::EntryVersion;
+	Writer << Version;
+
+	// The writer doesn't modify the channels, SerializeChannel is shared with the reader.
+	FTransformCurve& Curve = const_cast<FTransformCurve&>(InCurve);
+	for (int32 Channel = 0; Channel < RMERootMotionLibrary::NumChannels; ++Channel)
+	{
+		RMERootMotionLibrary::SerializeChannel(Writer, RMERootMotionLibrary::GetChannel(Curve, Channel));
+	}
+}
+
+bool URMERootMotionLibrary::DecodeCurve(TConstArrayView<uint8> InBytes, FTransformCurve& OutCurve)
+{
+	FMemoryReaderView Reader(InBytes);
+
+	uint8 Version = 0;
+	Reader << Version;
+	if (Version != RMERootMotionLibrary::EntryVersion)
+	{
+		return false;
+	}
+
+	for (int32 Channel = 0; Channel < RMERootMotionLibrary::NumChannels && !Reader.IsError(); ++Channel)
+	{
+		RMERootMotionLibrary::SerializeChannel(Reader, RMERootMotionLibrary::GetChannel(OutCurve, Channel));
+	}
+	return !Reader.IsError();
+}
+
+bool URMERootMotionLibrary::ReadPayload(int64 InOffset, int64 InSize, TArray<uint8>& OutBytes) const
+{
+	OutBytes.Reset();
+	if (InSize <= 0 || InOffset < 0 || InOffset + InSize > Payload.GetBulkDataSize())
+	{
+		return InSize == 0;
+	}
+
+	OutBytes.SetNumUninitialized(InSize);
+
+	// Only the range of the entry is read from the package, the rest of the payload stays on disk.
+	if (!Payload.IsBulkDataLoaded() && Payload.CanLoadFromDisk())
+	{
+		if (IBulkDataIORequest* Request = Payload.CreateStreamingRequest(InOffset, InSize, AIOP_Normal, nullptr, OutBytes.GetData()))
+		{
+			const bool bSucceeded = Request->WaitCompletion() && Request->GetSize() == InSize;
+			delete Request;
+			if (bSucceeded)
+			{
+				return true;
+			}
+		}
+	}
+
+	const uint8* Data = static_cast<const uint8*>(Payload.LockReadOnly());
+	FMemory::Memcpy(OutBytes.GetData(), Data + InOffset, InSize);
+	Payload.Unlock();
+	return true;
+}
+
+void URMERootMotionLibrary::RebuildIndexMap()
+{
+	IndexMap.Reset();
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		IndexMap.Add(Entries[Index].Name, Index);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMERootMotionLibraryFactory.h"
+#include "RMERootMotionLibrary.h"
+#include "AssetTypeCategories.h"
+
+#define LOCTEXT_NAMESPACE "RMERootMotionLibraryFactory"
+
+
+URMERootMotionLibraryFactory::URMERootMotionLibraryFactory()
+{
+	SupportedClass = URMERootMotionLibrary::StaticClass();
+	bCreateNew = true;
+	bEditAfterNew = true;
+}
+
+UObject* URMERootMotionLibraryFactory::FactoryCreateNew(UClass* InClass, UObject* InParent, FName InName, EObjectFlags Flags, UObject* Context, FFeedbackContext* Warn)
+{
+	return NewObject<URMERootMotionLibrary>(InParent, InClass, InName, Flags);
+}
+
+FText URMERootMotionLibraryFactory::GetDisplayName() const
+{
+	return LOCTEXT("RootMotionLibraryDisplayName", "Root Motion Library");
+}
+
+uint32 URMERootMotionLibraryFactory::GetMenuCategories() const
+{
+	return EAssetTypeCategories::Animation;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,344 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RMETrajectoryCache.h"
+#include "RMEAnimationDerivedData.h"
+#include "RMEFrameSampler.h"
+#include "Animation/AnimSequence.h"
+
+
+namespace RMETrajectory
+{
+	/**
+	 * First and second derivatives of a rich curve at ascending times, in a single pass with a moving key cursor.
+	 * Cubic segments are evaluated with the same bezier form as FRichCurve::Eval, weighted tangents are treated as unweighted.
+	 */
+	static void EvaluateDerivatives(const FRichCurve& Curve, TConstArrayView<double> Times, TArrayView<float> OutVelocities, TArrayView<float> OutAccelerations)
+	{
+		const TArray<FRichCurveKey>& Keys = Curve.Keys;
+		const int32 NumKeys = Keys.Num();
+
+		int32 KeyIndex = 0;
+		for (int32 Index = 0; Index < Times.Num(); ++Index)
+		{
+			const double Time = Times[Index];
+			OutVelocities[Index] = 0.f;
+			OutAccelerations[Index] = 0.f;
+
+			// Constant extrapolation outside of the keys.
+			if (NumKeys < 2 || Time <= Keys[0].Time || Time >= Keys[NumKeys - 1].Time)
+			{
+				continue;
+			}
+
+			while (KeyIndex < NumKeys - 2 && Time >= Keys[KeyIndex + 1].Time)
+			{
+				++KeyIndex;
+			}
+
+			const FRichCurveKey& Key1 = Keys[KeyIndex];
+			const FRichCurveKey& Key2 = Keys[KeyIndex + 1];
+			const float Diff = Key2.Time - Key1.Time;
+			if (Diff <= UE_KINDA_SMALL_NUMBER || Key1.InterpMode == RCIM_Constant)
+			{
+				continue;
+			}
+
+			if (Key1.InterpMode == RCIM_Linear)
+			{
+				OutVelocities[Index] = (Key2.Value - Key1.Value) / Diff;
+				continue;
+			}
+
+			const float Alpha = (Time - Key1.Time) / Diff;
+			const float OneMinusAlpha = 1.f - Alpha;
+			const float P0 = Key1.Value;
+			const float P1 = P0 + Key1.LeaveTangent * Diff / 3.f;
+			const float P3 = Key2.Value;
+			const float P2 = P3 - Key2.ArriveTangent * Diff / 3.f;
+
+			const float FirstDerivative = 3.f * (OneMinusAlpha * OneMinusAlpha * (P1 - P0) + 2.f * OneMinusAlpha * Alpha * (P2 - P1) + Alpha * Alpha * (P3 - P2));
+			const float SecondDerivative = 6.f * (OneMinusAlpha * (P2 - 2.f * P1 + P0) + Alpha * (P3 - 2.f * P2 + P1));
+			OutVelocities[Index] = FirstDerivative / Diff;
+			OutAccelerations[Index] = SecondDerivative / (Diff * Diff);
+		}
+	}
+}
+
+
+void FRMETrajectorySamples::Reset()
+{
+	Times.Reset();
+	Transforms.Reset();
+	Speeds.Reset();
+	Accelerations.Reset();
+	MinSpeed = MaxSpeed = MinAcceleration = MaxAcceleration = 0.f;
+}
+
+SIZE_T FRMETrajectorySamples::GetAllocatedSize() const
+{
+	return Times.GetAllocatedSize() + Transforms.GetAllocatedSize() + Speeds.GetAllocatedSize() + Accelerations.GetAllocatedSize();
+}
+
+float FRMETrajectorySamples::GetNormalizedValue(ERMETrajectoryColorMode ColorMode, int32 Index) const
+{
+	switch (ColorMode)
+	{
+	case ERMETrajectoryColorMode::Speed:
+		return MaxSpeed > MinSpeed ? (Speeds[Index] - MinSpeed) / (MaxSpeed - MinSpeed) : 0.f;
+	case ERMETrajectoryColorMode::Acceleration:
+		return MaxAcceleration > MinAcceleration ? (Accelerations[Index] - MinAcceleration) / (MaxAcceleration - MinAcceleration) : 0.f;
+	case ERMETrajectoryColorMode::None:
+	default:
+		return 0.f;
+	}
+}
+
+
+void FRMETrajectoryDeviation::Reset()
+{
+	Deviations.Reset();
+	MaxDeviation = 0.f;
+	MaxDeviationIndex = INDEX_NONE;
+	RmsDeviation = 0.f;
+	EndDrift = 0.f;
+}
+
+
+void FRMETrajectoryCache::Reset()
+{
+	AssetData.Reset();
+
+	EditorSamplesAnimation = nullptr;
+	EditorSamplesCurve = nullptr;
+	EditorSamplesRevision = 0;
+	EditorSamples.Reset();
+
+	++SamplesGeneration;
+	Deviation.Reset();
+}
+
+const FRMETrajectorySamples& FRMETrajectoryCache::GetAssetSamples(const UAnimSequence* InAnimation)
+{
+	if (InAnimation == nullptr)
+	{
+		static const FRMETrajectorySamples Empty;
+		AssetData.Reset();
+		return Empty;
+	}
+
+	if (!AssetData.IsValid() || AssetData->GetAnimation() != InAnimation || AssetData->GetGeneration() != AssetDataGeneration)
+	{
+		AssetData = FRMEAnimationDerivedData::FindOrCreate(InAnimation);
+		AssetDataGeneration = AssetData->GetGeneration();
+		++SamplesGeneration;
+	}
+
+	// Another session may already have sampled the animation.
+	Counter.Record(AssetData->HasAssetSamples());
+
+	return AssetData->GetAssetSamples();
+}
+
+const FRMETrajectorySamples& FRMETrajectoryCache::GetEditorSamples(const UAnimSequence* InAnimation, const FTransformCurve* InCurve, uint32 InCurveRevision)
+{
+	const bool bIsValid = EditorSamplesAnimation.Get() == InAnimation && EditorSamplesCurve == InCurve && EditorSamplesRevision == InCurveRevision && InAnimation != nullptr;
+	Counter.Record(bIsValid);
+
+	if (!bIsValid)
+	{
+		EditorSamplesAnimation = InAnimation;
+		EditorSamplesCurve = InCurve;
+		EditorSamplesRevision = InCurveRevision;
+
+		EditorSamples.Reset();
+		if (InCurve != nullptr)
+		{
+			BuildEditorSamples(InAnimation, *InCurve, EditorSamples);
+		}
+		++SamplesGeneration;
+	}
+
+	return EditorSamples;
+}
+
+const FRMETrajectoryDeviation& FRMETrajectoryCache::GetDeviation(const UAnimSequence* InAnimation, const FTransformCurve* InCurve, uint32 InCurveRevision)
+{
+	const FRMETrajectorySamples& Asset = GetAssetSamples(InAnimation);
+	const FRMETrajectorySamples& Editor = GetEditorSamples(InAnimation, InCurve, InCurveRevision);
+
+	if (DeviationGeneration != SamplesGeneration)
+	{
+		DeviationGeneration = SamplesGeneration;
+		BuildDeviation(Asset, Editor, Deviation);
+	}
+
+	return Deviation;
+}
+
+FColor FRMETrajectoryCache::GetHeatmapColor(float NormalizedValue, uint8 Alpha)
+{
+	// Blue (slow) to red (fast).
+	const float Hue = FMath::Lerp(240.f, 0.f, FMath::Clamp(NormalizedValue, 0.f, 1.f));
+	return FLinearColor(Hue, 1.f, 1.f).HSVToLinearRGB().ToFColor(true).WithAlpha(Alpha);
+}
+
+void FRMETrajectoryCache::GetFrameTimes(const UAnimSequence* InAnimation, TArray<double>& OutTimes)
+{
+	OutTimes.Reset();
+	if (InAnimation == nullptr)
+	{
+		return;
+	}
+
+	const FRMEFrameSampler Sampler = FRMEFrameSampler::ForAnimation(InAnimation);
+	OutTimes.Reserve(Sampler.Num());
+	for (int32 Frame = 0; Frame < Sampler.Num(); ++Frame)
+	{
+		OutTimes.Add(Sampler.GetTime(Frame));
+	}
+}
+
+void FRMETrajectoryCache::BuildAssetSamples(const UAnimSequence* InAnimation, FRMETrajectorySamples& OutSamples)
+{
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+	OutSamples.Reset();
+	GetFrameTimes(InAnimation, OutSamples.Times);
+
+	const int32 NumSamples = OutSamples.Num();
+	if (NumSamples == 0)
+	{
+		return;
+	}
+
+	// Accumulate the per frame deltas instead of extracting the whole range from zero for every frame.
+	OutSamples.Transforms.SetNumUninitialized(NumSamples);
+	OutSamples.Transforms[0] = FTransform::Identity;
+	for (int32 Index = 1; Index < NumSamples; ++Index)
+	{
+		const double StartTime = OutSamples.Times[Index - 1];
+		const double EndTime = OutSamples.Times[Index];
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 6
+		FAnimExtractContext ExtractContext(EndTime, true, {}, false);
+		const FTransform Delta = InAnimation->ExtractRootMotionFromRange(StartTime, EndTime, ExtractContext);
+#else
+		const FTransform Delta = InAnimation->ExtractRootMotionFromRange(StartTime, EndTime);
+#endif
+		OutSamples.Transforms[Index] = Delta * OutSamples.Transforms[Index - 1];
+	}
+
+	// Central differences inside, one sided on both ends.
+	OutSamples.Speeds.SetNumUninitialized(NumSamples);
+	OutSamples.Accelerations.SetNumUninitialized(NumSamples);
+	TArray<FVector> Velocities;
+	Velocities.SetNumUninitialized(NumSamples);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const int32 Prev = FMath::Max(Index - 1, 0);
+		const int32 Next = FMath::Min(Index + 1, NumSamples - 1);
+		const double DeltaTime = OutSamples.Times[Next] - OutSamples.Times[Prev];
+		Velocities[Index] = DeltaTime > UE_KINDA_SMALL_NUMBER
+			? (OutSamples.Transforms[Next].GetLocation() - OutSamples.Transforms[Prev].GetLocation()) / DeltaTime
+			: FVector::ZeroVector;
+		OutSamples.Speeds[Index] = Velocities[Index].Size();
+	}
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const int32 Prev = FMath::Max(Index - 1, 0);
+		const int32 Next = FMath::Min(Index + 1, NumSamples - 1);
+		const double DeltaTime = OutSamples.Times[Next] - OutSamples.Times[Prev];
+		OutSamples.Accelerations[Index] = DeltaTime > UE_KINDA_SMALL_NUMBER ? ((Velocities[Next] - Velocities[Prev]) / DeltaTime).Size() : 0.f;
+	}
+
+	UpdateRanges(OutSamples);
+}
+
+void FRMETrajectoryCache::BuildEditorSamples(const UAnimSequence* InAnimation, const FTransformCurve& InCurve, FRMETrajectorySamples& OutSamples)
+{
+	LLM_SCOPE_BYTAG(RootMotionEditor);
+	OutSamples.Reset();
+	GetFrameTimes(InAnimation, OutSamples.Times);
+
+	const int32 NumSamples = OutSamples.Num();
+	if (NumSamples == 0)
+	{
+		return;
+	}
+
+	OutSamples.Transforms.SetNumUninitialized(NumSamples);
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		OutSamples.Transforms[Index] = InCurve.Evaluate(OutSamples.Times[Index], 1.f);
+	}
+
+	// Derivatives of the three translation channels as contiguous arrays, X, Y then Z.
+	TArray<float> Velocities;
+	TArray<float> Accelerations;
+	Velocities.SetNumUninitialized(NumSamples * 3);
+	Accelerations.SetNumUninitialized(NumSamples * 3);
+	for (int32 Channel = 0; Channel < 3; ++Channel)
+	{
+		RMETrajectory::EvaluateDerivatives(InCurve.TranslationCurve.FloatCurves[Channel], OutSamples.Times,
+			MakeArrayView(Velocities.GetData() + Channel * NumSamples, NumSamples),
+			MakeArrayView(Accelerations.GetData() + Channel * NumSamples, NumSamples));
+	}
+
+	OutSamples.Speeds.SetNumUninitialized(NumSamples);
+	OutSamples.Accelerations.SetNumUninitialized(NumSamples);
+	const float* VX = Velocities.GetData();
+	const float* VY = VX + NumSamples;
+	const float* VZ = VY + NumSamples;
+	const float* AX = Accelerations.GetData();
+	const float* AY = AX + NumSamples;
+	const float* AZ = AY + NumSamples;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		OutSamples.Speeds[Index] = FMath::Sqrt(VX[Index] * VX[Index] + VY[Index] * VY[Index] + VZ[Index] * VZ[Index]);
+		OutSamples.Accelerations[Index] = FMath::Sqrt(AX[Index] * AX[Index] + AY[Index] * AY[Index] + AZ[Index] * AZ[Index]);
+	}
+
+	UpdateRanges(OutSamples);
+}
+
+void FRMETrajectoryCache::UpdateRanges(FRMETrajectorySamples& InOutSamples)
+{
+	if (InOutSamples.Num() == 0)
+	{
+		return;
+	}
+
+	InOutSamples.MinSpeed = FMath::Min(InOutSamples.Speeds);
+	InOutSamples.MaxSpeed = FMath::Max(InOutSamples.Speeds);
+	InOutSamples.MinAcceleration = FMath::Min(InOutSamples.Accelerations);
+	InOutSamples.MaxAcceleration = FMath::Max(InOutSamples.Accelerations);
+}
+
+void FRMETrajectoryCache::BuildDeviation(const FRMETrajectorySamples& InAssetSamples, const FRMETrajectorySamples& InEditorSamples, FRMETrajectoryDeviation& OutDeviation)
+{
+	OutDeviation.Reset();
+
+	const int32 NumSamples = FMath::Min(InAssetSamples.Num(), InEditorSamples.Num());
+	if (NumSamples == 0)
+	{
+		return;
+	}
+
+	// Distances, max, and sum of squares in a single pass.
+	OutDeviation.Deviations.SetNumUninitialized(NumSamples);
+	double SumOfSquares = 0.0;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const float Distance = FVector::Distance(InAssetSamples.Transforms[Index].GetLocation(), InEditorSamples.Transforms[Index].GetLocation());
+		OutDeviation.Deviations[Index] = Distance;
+		SumOfSquares += Distance * Distance;
+
+		if (Distance > OutDeviation.MaxDeviation || OutDeviation.MaxDeviationIndex == INDEX_NONE)
+		{
+			OutDeviation.MaxDeviation = Distance;
+			OutDeviation.MaxDeviationIndex = Index;
+		}
+	}
+
+	OutDeviation.RmsDeviation = FMath::Sqrt(SumOfSquares / NumSamples);
+	OutDeviation.EndDrift = OutDeviation.Deviations.Last();
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMEPerfCounters.h"
+#include "RMETypes.h"
+
+class UAnimSequence;
+
+/** Root motion sampled on the frames of an animation, with the translation speed and acceleration of every sample. */
+struct FRMETrajectorySamples
+{
+	TArray<double> Times;
+	TArray<FTransform> Transforms;
+	/** cm/s */
+	TArray<float> Speeds;
+	/** cm/s^2 */
+	TArray<float> Accelerations;
+
+	float MinSpeed = 0.f;
+	float MaxSpeed = 0.f;
+	float MinAcceleration = 0.f;
+	float MaxAcceleration = 0.f;
+
+	int32 Num() const { return Times.Num(); }
+	void Reset();
+	SIZE_T GetAllocatedSize() const;
+
+	/** Sample value of the channel mapped to [0, 1] between its min and max. */
+	float GetNormalizedValue(ERMETrajectoryColorMode ColorMode, int32 Index) const;
+};
+
+/** Per frame distance between the asset and the edited trajectories, with its statistics. */
+struct FRMETrajectoryDeviation
+{
+	/** cm, one per sample. */
+	TArray<float> Deviations;
+
+	float MaxDeviation = 0.f;
+	int32 MaxDeviationIndex = INDEX_NONE;
+	float RmsDeviation = 0.f;
+	/** Deviation of the last sample, how far the edited root motion ends from the original one. */
+	float EndDrift = 0.f;
+
+	int32 Num() const { return Deviations.Num(); }
+	void Reset();
+	SIZE_T GetAllocatedSize() const { return Deviations.GetAllocatedSize(); }
+};
+
+/**
+ * Keeps the sampled trajectories of the asset root motion and of the edited curve, so drawing doesn't have to
+ * extract root motion for every frame on every viewport draw.
+ */
+class FRMETrajectoryCache
+{
+public:
+	void Reset();
+
+	/** Root motion from the anim asset, accumulated frame by frame, derivatives from finite differences. */
+	const FRMETrajectorySamples& GetAssetSamples(const UAnimSequence* InAnimation);
+
+	/** Root motion from the edited curve, on the frames of the animation, derivatives are analytic. */
+	const FRMETrajectorySamples& GetEditorSamples(const UAnimSequence* InAnimation, const FTransformCurve* InCurve, uint32 InCurveRevision);
+
+	/** Deviation between the asset and the editor samples, they must have been sampled on the same frames. */
+	const FRMETrajectoryDeviation& GetDeviation(const UAnimSequence* InAnimation, const FTransformCurve* InCurve, uint32 InCurveRevision);
+
+	static FColor GetHeatmapColor(float NormalizedValue, uint8 Alpha = 255);
+
+	static void BuildAssetSamples(const UAnimSequence* InAnimation, FRMETrajectorySamples& OutSamples);
+
+	/** Editor samples and deviation, the asset samples are shared and counted by FRMEAnimationDerivedData. */
+	SIZE_T GetAllocatedSize() const { return EditorSamples.GetAllocatedSize() + Deviation.GetAllocatedSize(); }
+
+	/** Sample table lookups since the cache was created, Reset doesn't clear it. */
+	const FRMECacheCounter& GetCounter() const { return Counter; }
+
+private:
+	static void GetFrameTimes(const UAnimSequence* InAnimation, TArray<double>& OutTimes);
+	static void BuildEditorSamples(const UAnimSequence* InAnimation, const FTransformCurve& InCurve, FRMETrajectorySamples& OutSamples);
+	static void UpdateRanges(FRMETrajectorySamples& InOutSamples);
+	static void BuildDeviation(const FRMETrajectorySamples& InAssetSamples, const FRMETrajectorySamples& InEditorSamples, FRMETrajectoryDeviation& OutDeviation);
+
+private:
+	/** The asset samples only depend on the animation, they're shared with the other sessions. */
+	TSharedPtr<class FRMEAnimationDerivedData> AssetData;
+	uint32 AssetDataGeneration = 0;
+
+	TWeakObjectPtr<const UAnimSequence> EditorSamplesAnimation;
+	const FTransformCurve* EditorSamplesCurve = nullptr;
+	uint32 EditorSamplesRevision = 0;
+	FRMETrajectorySamples EditorSamples;
+
+	/** Bumped every time one of the sample tables is rebuilt. */
+	uint32 SamplesGeneration = 0;
+	uint32 DeviationGeneration = 0;
+	FRMETrajectoryDeviation Deviation;
+
+	FRMECacheCounter Counter;
+};
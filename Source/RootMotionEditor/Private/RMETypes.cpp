@@ -3,9 +3,23 @@
 
 #include "RMETypes.h"
 #include "Curves/CurveVector.h"
+#include "Animation/AnimSequence.h"
 
 DEFINE_LOG_CATEGORY(LogRootMotionEditor);
 
+DEFINE_STAT(STAT_RME_BakeRootBoneToCurve);
+DEFINE_STAT(STAT_RME_BakeAnimPoseBoneToCurve);
+DEFINE_STAT(STAT_RME_OverrideAnimBoneMotion);
+DEFINE_STAT(STAT_RME_GetRootMotionTransform);
+DEFINE_STAT(STAT_RME_DrawRootMotionData);
+
+DEFINE_STAT(STAT_RME_BakedSamples);
+DEFINE_STAT(STAT_RME_WrittenBoneKeys);
+DEFINE_STAT(STAT_RME_RootMotionEvaluations);
+DEFINE_STAT(STAT_RME_DrawnTrajectorySamples);
+
+LLM_DEFINE_TAG(RootMotionEditor);
+
 
 FLinearColor URMECurveContainer::GetCurveAxisColor(const int32& Index)
 {
@@ -33,25 +47,30 @@ FVectorCurve URMECurveContainer::ConvertToFCurve(class UCurveVector* InCurveAsse
 
 void URMECurveContainer::BeginDestroy()
 {
-	if (IsNew() && CurveData)
-    {
-    	DeleteCurveData();
-    }
-    MakeDestroy();
+	ReleaseCurveData();
+	MakeDestroy();
 	
 	UObject::BeginDestroy();
 }
 
-URMECurveContainer* URMECurveContainer::Create(FTransformCurve* SourceData, bool bAddToRoot)
+void URMECurveContainer::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
 {
-	URMECurveContainer* NewContainer= NewObject<URMECurveContainer>();
-	if (SourceData != nullptr)
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// The curve lives in the pool, it's counted here since the container is its only owner.
+	if (const FTransformCurve* CurveData = GetCurveData())
 	{
-		NewContainer->CurveData = SourceData;
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(FRMECurvePool::GetAllocatedSize(*CurveData));
 	}
-	else
+}
+
+URMECurveContainer* URMECurveContainer::Create(const FTransformCurve* SourceData, bool bAddToRoot)
+{
+	URMECurveContainer* NewContainer= NewObject<URMECurveContainer>();
+	FTransformCurve* CurveData = NewContainer->GetOrCreateCurveData();
+	if (SourceData != nullptr)
 	{
-		NewContainer->GetOrCreateCurveData();
+		FRMECurvePool::CopyKeys(*SourceData, *CurveData);
 	}
 
 	if (bAddToRoot)
@@ -65,30 +84,19 @@ URMECurveContainer* URMECurveContainer::Create(FTransformCurve* SourceData, bool
 
 void URMECurveContainer::ClearAllKeys()
 {
-	if (CurveData != nullptr)
+	if (FTransformCurve* CurveData = GetCurveData())
 	{
-		auto ResetKeys = [](FVectorCurve& InCurve)
-		{
-			for (int Index = 0; Index < 3; ++Index)
-			{
-				FRichCurve& Curve = InCurve.FloatCurves[Index];
-				Curve.Reset();
-			}
-		};
-
-		ResetKeys(CurveData->TranslationCurve);
-		ResetKeys(CurveData->RotationCurve);
-		ResetKeys(CurveData->ScaleCurve);
+		FRMECurvePool::ResetKeys(*CurveData);
+		MarkCurveModified();
 	}
 }
 
-void URMECurveContainer::DeleteCurveData()
+void URMECurveContainer::ReleaseCurveData()
 {
-	if (CurveData != nullptr)
+	if (CurveHandle.IsSet())
 	{
-		delete CurveData;
-		CurveData = nullptr;
-		bIsNew = false;
+		FRMECurvePool::Get().Release(CurveHandle);
+		MarkCurveModified();
 	}
 }
 
@@ -104,10 +112,11 @@ void URMECurveContainer::MakeDestroy()
 
 FTransformCurve* URMECurveContainer::GetOrCreateCurveData()
 {
+	FTransformCurve* CurveData = GetCurveData();
 	if (CurveData == nullptr)
 	{
-		CurveData = new FTransformCurve;
-		bIsNew = true;
+		CurveHandle = FRMECurvePool::Get().Allocate();
+		CurveData = GetCurveData();
 	}
 	
 	return CurveData;
@@ -115,29 +124,33 @@ FTransformCurve* URMECurveContainer::GetOrCreateCurveData()
 
 void URMECurveContainer::PushCurveData(class UCurveVector* Motion, class UCurveVector* Rotation, class UCurveVector* Scale)
 {
-	if (CurveData == nullptr)
+	FTransformCurve* CurveData = GetOrCreateCurveData();
+	auto PushCurve = [](const UCurveVector* InCurveAsset, FVectorCurve& OutCurve)
 	{
-		CurveData = new FTransformCurve;
-		bIsNew = true;
-	}
-	CurveData->TranslationCurve = ConvertToFCurve(Motion);
-	CurveData->RotationCurve = ConvertToFCurve(Rotation);
-	CurveData->ScaleCurve = ConvertToFCurve(Scale);
-}
+		if (InCurveAsset != nullptr)
+		{
+			for (int32 Index = 0; Index < 3; ++Index)
+			{
+				FRMECurvePool::CopyKeys(InCurveAsset->FloatCurves[Index], OutCurve.FloatCurves[Index]);
+			}
+		}
+		else
+		{
+			static const FVectorCurve EmptyCurve;
+			FRMECurvePool::CopyKeys(EmptyCurve, OutCurve);
+		}
+	};
 
-void URMECurveContainer::OverrideCurveData(FTransformCurve& NewCurveData)
-{
-	if (CurveData != nullptr && IsNew())
-	{
-		DeleteCurveData();
-	}
-	CurveData = &NewCurveData;
+	PushCurve(Motion, CurveData->TranslationCurve);
+	PushCurve(Rotation, CurveData->RotationCurve);
+	PushCurve(Scale, CurveData->ScaleCurve);
+	MarkCurveModified();
 }
 
 void URMECurveContainer::CopyCurveData(const FTransformCurve& NewCurveData)
 {
-	CurveData->CopyCurve(NewCurveData);
-
+	FRMECurvePool::CopyKeys(NewCurveData, *GetOrCreateCurveData());
+	MarkCurveModified();
 }
 
 FName URMECurveContainer::GetFullCurveName(FString InName, int32 Index)
@@ -180,6 +193,15 @@ bool URMEAssetCollection::HasAnyCurveAsset() const
 	return MotionCurve || RotationCurve || ScaleCurve;
 }
 
+FName URMEAssetCollection::GetLibraryEntryName() const
+{
+	if (Library == nullptr)
+	{
+		return NAME_None;
+	}
+	return !LibraryEntryName.IsNone() ? LibraryEntryName : AnimSequence != nullptr ? AnimSequence->GetFName() : NAME_None;
+}
+
 bool URMEAssetCollection::HasRepeatedCurve() const
 {
 	TSet<UCurveVector*> Curves;
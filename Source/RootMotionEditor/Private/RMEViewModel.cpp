@@ -24,6 +24,8 @@ bool FRootMotionEditorPreviewActor::SetupPreviewActor(UWorld* World, UAnimSequen
 	}
 
 	AnimAssetPtr = InAnimation;
+	InvalidatePoseCaches();
+	AnimationData = FRMEAnimationDerivedData::FindOrCreate(InAnimation);
 
 	UAnimPreviewInstance* AnimInstance;
 	if (ActorPtr == nullptr)
@@ -98,6 +100,12 @@ void FRootMotionEditorPreviewActor::UpdatePreviewActor(float PlayTime, FRMEViewM
 
 	AnimInstance->SetPosition(PlayTime);
 	AnimInstance->SetPlayRate(0.f);
+	const bool bHasScrubPose = ApplyScrubPose(PlayTime);
+
+	if (InViewModel != nullptr)
+	{
+		InViewModel->GetPerfCounters().ScrubPoseCache.Record(bHasScrubPose);
+	}
 
 	if (ActorPtr != nullptr && InViewModel != nullptr)
 	{
@@ -105,8 +113,71 @@ void FRootMotionEditorPreviewActor::UpdatePreviewActor(float PlayTime, FRMEViewM
 	}
 }
 
+bool FRootMotionEditorPreviewActor::ApplyScrubPose(float PlayTime)
+{
+	UDebugSkelMeshComponent* Mesh = GetDebugSkelMeshComponent();
+	UAnimSequence* AnimSeq = AnimAssetPtr.Get();
+	UAnimPreviewInstance* AnimInstance = GetAnimPreviewInstanceInternal();
+	if (Mesh == nullptr || Mesh->GetSkeletalMeshAsset() == nullptr || AnimSeq == nullptr || AnimInstance == nullptr || !AnimationData.IsValid())
+	{
+		return false;
+	}
+
+	// The cache was dropped when the change began, a build started now would read the tracks being written.
+	if (AnimationData->IsModelChanging())
+	{
+		Mesh->bNoSkeletonUpdate = false;
+		return false;
+	}
+
+	FRMEScrubPoseCache& ScrubPoseCache = AnimationData->GetScrubPoseCache(Mesh->GetSkeletalMeshAsset());
+	if (!ScrubPoseCache.IsBuiltFor(AnimSeq))
+	{
+		// The required bones are only valid once the mesh has been evaluated at least once.
+		const FBoneContainer& RequiredBones = AnimInstance->GetRequiredBones();
+		if (RequiredBones.IsValid())
+		{
+			ScrubPoseCache.Build(AnimSeq, RequiredBones);
+		}
+	}
+
+	if (!ScrubPoseCache.GetPose(PlayTime, ScrubPoseBuffer))
+	{
+		Mesh->bNoSkeletonUpdate = false;
+		return false;
+	}
+
+	Mesh->bNoSkeletonUpdate = true;
+
+	TArray<FTransform>& ComponentSpaceTransforms = Mesh->GetEditableComponentSpaceTransforms();
+	const TArray<int32>& MeshBoneIndices = ScrubPoseCache.GetMeshBoneIndices();
+	for (int32 Index = 0; Index < ScrubPoseBuffer.Num() && Index < MeshBoneIndices.Num(); ++Index)
+	{
+		if (ComponentSpaceTransforms.IsValidIndex(MeshBoneIndices[Index]))
+		{
+			ComponentSpaceTransforms[MeshBoneIndices[Index]] = ScrubPoseBuffer[Index];
+		}
+	}
+	Mesh->ApplyEditedComponentSpaceTransforms();
+
+	return true;
+}
+
+void FRootMotionEditorPreviewActor::InvalidatePoseCaches()
+{
+	GhostPoseCache.Reset();
+
+	if (UDebugSkelMeshComponent* Mesh = GetDebugSkelMeshComponent())
+	{
+		Mesh->bNoSkeletonUpdate = false;
+	}
+}
+
 void FRootMotionEditorPreviewActor::ClearPreviewActor()
 {
+	InvalidatePoseCaches();
+	AnimationData.Reset();
+
 	if (UDebugSkelMeshComponent* Mesh = GetDebugSkelMeshComponent())
 	{
 		Mesh->UnregisterComponent();
@@ -124,8 +195,46 @@ bool FRootMotionEditorPreviewActor::DrawPreviewActor()
 	return true;
 }
 
+const FRMEPoseCache& FRootMotionEditorPreviewActor::UpdateGhostPoses(int32 NumGhosts, uint32 CacheKey, TFunctionRef<FTransform(double)> GetRootMotionTransform,
+	FRMECacheCounter& OutCounter)
+{
+	const UAnimSequence* AnimSeq = AnimAssetPtr.Get();
+	UAnimPreviewInstance* AnimInstance = GetAnimPreviewInstanceInternal();
+	if (!IsValid(AnimSeq) || AnimInstance == nullptr || NumGhosts <= 0)
+	{
+		GhostPoseCache.Reset();
+		return GhostPoseCache;
+	}
+
+	// The asset can be edited or reimported under the same pointer, the shared data generation changes with it.
+	const uint32 AssetCacheKey = AnimationData.IsValid() ? HashCombine(CacheKey, GetTypeHash(AnimationData->GetGeneration())) : CacheKey;
+	const bool bIsValid = GhostPoseCache.IsValidFor(AnimSeq, AssetCacheKey);
+	OutCounter.Record(bIsValid);
+	if (bIsValid)
+	{
+		return GhostPoseCache;
+	}
+
+	const double PlayLength = AnimSeq->GetPlayLength();
+	TArray<double, TInlineAllocator<16>> Times;
+	Times.Reserve(NumGhosts);
+	for (int32 Index = 0; Index < NumGhosts; ++Index)
+	{
+		Times.Add(NumGhosts > 1 ? PlayLength * Index / (NumGhosts - 1) : 0.0);
+	}
+
+	// Copy the required bones, the evaluation runs on worker threads.
+	const FBoneContainer BoneContainer = AnimInstance->GetRequiredBones();
+	GhostPoseCache.Evaluate(AnimSeq, BoneContainer, Times, AssetCacheKey, GetRootMotionTransform);
+
+	return GhostPoseCache;
+}
+
 void FRootMotionEditorPreviewActor::Destroy()
 {
+	InvalidatePoseCaches();
+	AnimationData.Reset();
+
 	if (ActorPtr != nullptr)
 	{
 		ActorPtr->Destroy();
@@ -169,21 +278,35 @@ void FRMEViewModel::AddReferencedObjects(FReferenceCollector& Collector)
 {
 }
 
-void FRMEViewModel::Initialize(const TSharedRef<FRMEPreviewScene>& InPreviewScene)
+void FRMEViewModel::Initialize(const TSharedRef<FRMEPreviewScene>& InPreviewScene, FRMEContext* InContext)
 {
 	PreviewScenePtr = InPreviewScene;
+	Context = InContext;
 	ManipulatorTransform = FTransform::Identity;
 }
 
+void FRMEViewModel::Shutdown()
+{
+	TrajectoryCache.Reset();
+	PreviewActor.Destroy();
+	Context = nullptr;
+}
+
 void FRMEViewModel::Tick(float DeltaSeconds)
 {
-	const float DeltaPlayTime = DeltaSeconds * DeltaTimeMultiplier;
-	const float NewPlayTime = FMath::Clamp(PlayTime + DeltaPlayTime, 0.f, MaxPreviewPlayLength);
+	// A scrub request replaces the playback for this frame.
+	const bool bIsScrubbing = PendingPlayTime.IsSet();
+	const float NewPlayTime = bIsScrubbing
+		? FMath::Clamp(PendingPlayTime.GetValue(), MinPreviewPlayLength, MaxPreviewPlayLength)
+		: FMath::Clamp(PlayTime + DeltaSeconds * DeltaTimeMultiplier, 0.f, MaxPreviewPlayLength);
+	PendingPlayTime.Reset();
+
 	const bool bHasTimeChanged = !FMath::IsNearlyEqual(NewPlayTime, PlayTime);
 	PlayTime = NewPlayTime;
 	PreviewActor.UpdatePreviewActor(PlayTime, this);
 
-	if (bHasTimeChanged && PreviewEditMode != ERMEPreviewEditMode::View && !bManipulatorHasUserOverride)
+	// An explicit time change means the manipulator should snap to the current frame.
+	if (bHasTimeChanged && PreviewEditMode != ERMEPreviewEditMode::View && (bIsScrubbing || !bManipulatorHasUserOverride))
 	{
 		SyncManipulatorToCurrentRootMotion();
 	}
@@ -193,6 +316,7 @@ void FRMEViewModel::SetSelectedAnimation(UAnimSequence* InAnimation)
 {
 	MaxPreviewPlayLength = InAnimation ? InAnimation->GetPlayLength() : 0.f;
 	PreviewActor.SetupPreviewActor(GetWorld(), InAnimation);
+	TrajectoryCache.Reset();
 
 	// auto change view mode.
 	if (RootMotionViewMode == ERMERootMotionViewMode::None)
@@ -206,6 +330,11 @@ void FRMEViewModel::SetSelectedAnimation(UAnimSequence* InAnimation)
 	}
 }
 
+void FRMEViewModel::OnAnimationModified()
+{
+	TrajectoryCache.Reset();
+	PreviewActor.InvalidatePoseCaches();
+}
 
 UWorld* FRMEViewModel::GetWorld()
 {
@@ -213,8 +342,16 @@ UWorld* FRMEViewModel::GetWorld()
 	return PreviewScenePtr.Pin()->GetWorld();
 } 
 
+void FRMEViewModel::SetNumGhostPoses(int32 InNumGhostPoses)
+{
+	NumGhostPoses = FMath::Clamp(InNumGhostPoses, 1, MaxGhostPoses);
+}
+
 void FRMEViewModel::SetPlayTime(float NewPlayTime, bool bInTickPlayTime)
 {
+	// A scrub request still queued from a drag is older than this time, it mustn't override it on the next tick.
+	PendingPlayTime.Reset();
+
 	NewPlayTime = FMath::Clamp(NewPlayTime, MinPreviewPlayLength, MaxPreviewPlayLength);
 	DeltaTimeMultiplier = bInTickPlayTime ? DeltaTimeMultiplier : 0.f;
 
@@ -231,6 +368,12 @@ void FRMEViewModel::SetPlayTime(float NewPlayTime, bool bInTickPlayTime)
 	}
 }
 
+void FRMEViewModel::RequestPlayTime(float NewPlayTime)
+{
+	DeltaTimeMultiplier = 0.f;
+	PendingPlayTime = NewPlayTime;
+}
+
 TRange<double> FRMEViewModel::GetPlayTimeRange() const
 {
 	constexpr double ViewRangeSlack = 0.2;
@@ -326,6 +469,15 @@ void FRMEViewModel::PreviewForwardEnd()
 
 FTransform FRMEViewModel::GetRootMotionTransform(float Time) const
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMEViewModel::GetRootMotionTransform);
+	SCOPE_CYCLE_COUNTER(STAT_RME_GetRootMotionTransform);
+	INC_DWORD_STAT(STAT_RME_RootMotionEvaluations);
+
+	if (IsInGameThread())
+	{
+		++PerfCounters.RootMotionEvaluations;
+	}
+
 	FTransform RootMotionTransform = FTransform::Identity;
 	
 	switch (GetRootMotionViewMode()) {
@@ -346,7 +498,7 @@ FTransform FRMEViewModel::GetRootMotionTransform(float Time) const
 		}
 		break;
 	case ERMERootMotionViewMode::Editor:
-		if (const FRMEContext* Context = FRMEContext::Get())
+		if (Context != nullptr)
 		{
 			RootMotionTransform = Context->GetCurveTransform(Time, 1.f);
 		}
@@ -355,3 +507,90 @@ FTransform FRMEViewModel::GetRootMotionTransform(float Time) const
 
 	return RootMotionTransform;
 }
+
+FTransform FRMEViewModel::GetRootMotionTransform(float Time, const FTransformCurve* InEditorCurve) const
+{
+	if (GetRootMotionViewMode() == ERMERootMotionViewMode::Editor)
+	{
+		return InEditorCurve != nullptr ? InEditorCurve->Evaluate(Time, 1.f) : FTransform::Identity;
+	}
+	return GetRootMotionTransform(Time);
+}
+
+const FRMEPoseCache* FRMEViewModel::GetGhostPoses()
+{
+	if (!bShowGhostPoses)
+	{
+		return nullptr;
+	}
+
+	const URMECurveContainer* Container = Context ? Context->GetCurveContainer() : nullptr;
+	const uint32 CurveRevision = Container ? Container->GetRevision() : 0;
+	const uint32 CacheKey = HashCombine(HashCombine(GetTypeHash(CurveRevision), GetTypeHash(RootMotionViewMode)), GetTypeHash(NumGhostPoses));
+
+	// The poses are evaluated on worker threads, the curve pool is only read here.
+	const FTransformCurve* EditorCurve = Context ? Context->GetRootMotionTransformCurve() : nullptr;
+	return &PreviewActor.UpdateGhostPoses(NumGhostPoses, CacheKey, [this, EditorCurve](double Time)
+	{
+		return GetRootMotionTransform(Time, EditorCurve);
+	}, PerfCounters.GhostPoseCache);
+}
+
+const FRMETrajectorySamples* FRMEViewModel::GetTrajectorySamples()
+{
+	return GetTrajectorySamples(RootMotionViewMode);
+}
+
+const FRMETrajectorySamples* FRMEViewModel::GetTrajectorySamples(ERMERootMotionViewMode InViewMode)
+{
+	const UAnimSequence* AnimSeq = GetAnimation();
+	if (AnimSeq == nullptr)
+	{
+		return nullptr;
+	}
+
+	switch (InViewMode)
+	{
+	case ERMERootMotionViewMode::Asset:
+		return &TrajectoryCache.GetAssetSamples(AnimSeq);
+
+	case ERMERootMotionViewMode::Editor:
+		if (Context != nullptr)
+		{
+			const URMECurveContainer* Container = Context->GetCurveContainer();
+			return &TrajectoryCache.GetEditorSamples(AnimSeq, Context->GetRootMotionTransformCurve(), Container ? Container->GetRevision() : 0);
+		}
+		break;
+
+	case ERMERootMotionViewMode::None:
+	default:
+		break;
+	}
+
+	return nullptr;
+}
+
+const FRMETrajectoryDeviation* FRMEViewModel::GetTrajectoryDeviation()
+{
+	const UAnimSequence* AnimSeq = GetAnimation();
+	if (AnimSeq == nullptr || Context == nullptr)
+	{
+		return nullptr;
+	}
+
+	const URMECurveContainer* Container = Context->GetCurveContainer();
+	return &TrajectoryCache.GetDeviation(AnimSeq, Context->GetRootMotionTransformCurve(), Container ? Container->GetRevision() : 0);
+}
+
+FRMEPerfCounters FRMEViewModel::GetPerfCountersSnapshot() const
+{
+	FRMEPerfCounters Snapshot = PerfCounters;
+	Snapshot.TrajectoryCache = TrajectoryCache.GetCounter();
+
+	if (const TSharedPtr<FRMEPreviewScene> PreviewScene = PreviewScenePtr.Pin())
+	{
+		Snapshot.PreviewTicks = PreviewScene->GetNumTicks();
+		Snapshot.PreviewTickSeconds = PreviewScene->GetTotalTickSeconds();
+	}
+	return Snapshot;
+}
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "AnimPreviewInstance.h"
+#include "RMEAnimationDerivedData.h"
+#include "RMEPerfCounters.h"
+#include "RMEPoseCache.h"
+#include "RMETrajectoryCache.h"
 #include "RMETypes.h"
 
 class SRootMotionEditor;
@@ -18,6 +22,12 @@ public:
 	void ClearPreviewActor();
 	bool DrawPreviewActor();
 
+	/** Evaluate the onion skin poses at evenly spaced times, only when the animation or the cache key changed. */
+	const FRMEPoseCache& UpdateGhostPoses(int32 NumGhosts, uint32 CacheKey, TFunctionRef<FTransform(double)> GetRootMotionTransform, FRMECacheCounter& OutCounter);
+
+	/** Drop every pose evaluated from the animation, it must be called before the animation data is modified. */
+	void InvalidatePoseCaches();
+
 	void Destroy();
 	
 	UAnimPreviewInstance* GetAnimPreviewInstanceInternal();
@@ -26,9 +36,20 @@ public:
 
 	const UAnimSequence* GetAnimAsset() const { return AnimAssetPtr.Get(); }
 
+	/** Ghost poses and scrub buffer, the shared animation data is counted by FRMEAnimationDerivedData. */
+	SIZE_T GetAllocatedSize() const { return GhostPoseCache.GetAllocatedSize() + ScrubPoseBuffer.GetAllocatedSize(); }
+
 private:
 	TWeakObjectPtr<AActor> ActorPtr;
 	TWeakObjectPtr<UAnimSequence> AnimAssetPtr;
+
+	/** Copy the cached pose into the preview mesh, the mesh skips its own evaluation while the cache is in use. */
+	bool ApplyScrubPose(float PlayTime);
+
+	FRMEPoseCache GhostPoseCache;
+	/** Holds the scrub poses, shared with the other sessions previewing the same animation. */
+	TSharedPtr<FRMEAnimationDerivedData> AnimationData;
+	TArray<FTransform> ScrubPoseBuffer;
 };
 
 
@@ -42,11 +63,18 @@ public:
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
 	virtual FString GetReferencerName() const override { return TEXT("FRootMotionEditedViewModel"); }
 
-	void Initialize(const TSharedRef<FRMEPreviewScene>& InPreviewScene);
+	void Initialize(const TSharedRef<FRMEPreviewScene>& InPreviewScene, class FRMEContext* InContext);
+	/** Destroy the preview actor and release the shared animation data, the session is going away. */
+	void Shutdown();
+
+	/** The session owning this view model. */
+	class FRMEContext* GetContext() const { return Context; }
 	
 	void Tick(float DeltaSeconds);
 
 	void SetSelectedAnimation(UAnimSequence* InAnimation);
+	/** The animation data has been or is about to be modified, drop everything derived from it. */
+	void OnAnimationModified();
 	
 	UWorld* GetWorld();
 
@@ -54,6 +82,11 @@ public:
 	float GetPlayTime() const { return PlayTime; }
 	void SetPlayTime(float NewPlayTime, bool bInTickPlayTime);
 
+	/** Scrub to the time on the next tick, only the latest request of a frame is applied. */
+	void RequestPlayTime(float NewPlayTime);
+	/** The pending scrub time if any, so the slider doesn't lag behind the mouse. */
+	float GetRequestedPlayTime() const { return PendingPlayTime.Get(PlayTime); }
+
 	TRange<double> GetPlayTimeRange() const;
 
 	void SetRootMotionViewMode(ERMERootMotionViewMode InType);
@@ -79,17 +112,50 @@ public:
 	void PreviewForwardEnd();
 
 	FTransform GetRootMotionTransform(float Time) const;
+	/** Thread safe as long as the curve isn't edited, the editor curve is resolved by the caller on the game thread. */
+	FTransform GetRootMotionTransform(float Time, const FTransformCurve* InEditorCurve) const;
+
+	void SetShowGhostPoses(bool bInShow) { bShowGhostPoses = bInShow; }
+	bool IsShowingGhostPoses() const { return bShowGhostPoses; }
+	/** Ghosts evenly spaced over the animation, both ends included. */
+	void SetNumGhostPoses(int32 InNumGhostPoses);
+	int32 GetNumGhostPoses() const { return NumGhostPoses; }
+	static constexpr int32 MaxGhostPoses = 64;
+	/** Onion skin poses along the trajectory of the current root motion view mode. */
+	const FRMEPoseCache* GetGhostPoses();
+
+	void SetTrajectoryColorMode(ERMETrajectoryColorMode InColorMode) { TrajectoryColorMode = InColorMode; }
+	ERMETrajectoryColorMode GetTrajectoryColorMode() const { return TrajectoryColorMode; }
+	/** Sampled trajectory of the current root motion view mode, null if there's nothing to draw. */
+	const FRMETrajectorySamples* GetTrajectorySamples();
+	const FRMETrajectorySamples* GetTrajectorySamples(ERMERootMotionViewMode InViewMode);
+
+	/** Draw the asset and the edited trajectories at once, whatever the root motion view mode is. */
+	void SetCompareTrajectories(bool bInCompare) { bCompareTrajectories = bInCompare; }
+	bool IsComparingTrajectories() const { return bCompareTrajectories; }
+	const FRMETrajectoryDeviation* GetTrajectoryDeviation();
 
 	UDebugSkelMeshComponent* GetDebugSkelMeshComponent() const { return PreviewActor.GetDebugSkelMeshComponent(); }
 	const UAnimSequence* GetAnimation() const { return PreviewActor.GetAnimAsset(); }
+
+	/** Counters written by the view model and the viewport. */
+	FRMEPerfCounters& GetPerfCounters() { return PerfCounters; }
+	/** Every counter of the session, including the trajectory cache and the preview world ones. */
+	FRMEPerfCounters GetPerfCountersSnapshot() const;
+
+	/** Caches owned by this view model, not the ones shared with the other sessions. */
+	SIZE_T GetAllocatedSize() const { return PreviewActor.GetAllocatedSize() + TrajectoryCache.GetAllocatedSize(); }
 	
 private:
 	FRootMotionEditorPreviewActor PreviewActor;
 
+	class FRMEContext* Context = nullptr;
+
 	/** Weak pointer to the PreviewScene */
 	TWeakPtr<FRMEPreviewScene> PreviewScenePtr;
 
 	float PlayTime = 0.f;
+	TOptional<float> PendingPlayTime;
 	float DeltaTimeMultiplier = 1.f;
 	float StepDeltaTime = 1.f / 30.f;
 	
@@ -101,4 +167,14 @@ private:
 	ERMEPreviewEditMode PreviewEditMode = ERMEPreviewEditMode::View;
 	FTransform ManipulatorTransform = FTransform::Identity;
 	bool bManipulatorHasUserOverride = false;
+
+	bool bShowGhostPoses = false;
+	int32 NumGhostPoses = 8;
+
+	FRMETrajectoryCache TrajectoryCache;
+	ERMETrajectoryColorMode TrajectoryColorMode = ERMETrajectoryColorMode::None;
+	bool bCompareTrajectories = false;
+
+	/** Mutable, root motion evaluations are counted from const code. */
+	mutable FRMEPerfCounters PerfCounters;
 };
@@ -11,8 +11,10 @@
 
 FName SRMEAssetsSelector::TabName = FName(TEXT("RootMotionEditorAssetViewTab"));
 
-void SRMEAssetsSelector::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager)
+void SRMEAssetsSelector::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager, const TSharedRef<FRMEContext>& InContext)
 {
+	TWeakPtr<FRMEContext> WeakContext = InContext;
+
 	TabManager->RegisterTabSpawner(
 			TabName,
 			FOnSpawnTab::CreateLambda(
@@ -23,6 +25,7 @@ void SRMEAssetsSelector::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabMa
 						.Label(LOCTEXT("ViewAssetTitle", "Asset Selector"))
 						[
 							SNew(SRMEAssetsSelector)
+							.Context(WeakContext)
 						];
 				}
 			)
@@ -46,6 +49,8 @@ SRMEAssetsSelector::~SRMEAssetsSelector()
 
 void SRMEAssetsSelector::Construct(const FArguments& InArgs)
 {
+	ContextPtr = InArgs._Context;
+
 	ChildSlot
 	[
 		SNew(SScrollBox)
@@ -112,7 +117,7 @@ void SRMEAssetsSelector::OnFinishedChangingProperties(const FPropertyChangedEven
 	{
 		if (AssetCollection)
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (TSharedPtr<FRMEContext> Context = ContextPtr.Pin())
 			{
 				Context->SetAnimationAsset(AssetCollection->AnimSequence);
 			}
@@ -12,11 +12,12 @@ class SRMEAssetsSelector : public SCompoundWidget
 {
 public:
 	SLATE_BEGIN_ARGS(SRMEAssetsSelector) { }
+		SLATE_ARGUMENT(TWeakPtr<class FRMEContext>, Context)
 	SLATE_END_ARGS()
 
 	static FName TabName;
 
-	static void RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager);
+	static void RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager, const TSharedRef<class FRMEContext>& InContext);
 	
 public:
 	SRMEAssetsSelector();
@@ -35,6 +36,7 @@ public:
 protected:
 	TSharedPtr<IDetailsView> Widget;
 	TObjectPtr<class URMEAssetCollection> AssetCollection = nullptr;
+	TWeakPtr<class FRMEContext> ContextPtr;
 
 	bool bHasRepeatedCurve = false;
 };
@@ -0,0 +1,290 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SRMEBatchPanel.h"
+
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "RMEBatchProcessor.h"
+#include "RMETypes.h"
+#include "Animation/AnimSequence.h"
+#include "Widgets/Views/SHeaderRow.h"
+#include "Widgets/Views/STableRow.h"
+
+#define LOCTEXT_NAMESPACE "SRMEBatchPanel"
+
+FName SRMEBatchPanel::TabName = FName(TEXT("RootMotionEditorBatchTab"));
+
+namespace RMEBatchPanelColumns
+{
+	static const FName Asset(TEXT("Asset"));
+	static const FName Result(TEXT("Result"));
+	static const FName Keys(TEXT("Keys"));
+	static const FName Distance(TEXT("Distance"));
+	static const FName Time(TEXT("Time"));
+	static const FName Message(TEXT("Message"));
+}
+
+class SRMEBatchReportRow : public SMultiColumnTableRow<TSharedPtr<FRMEBatchAssetReport>>
+{
+public:
+	SLATE_BEGIN_ARGS(SRMEBatchReportRow) { }
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable, const TSharedPtr<FRMEBatchAssetReport>& InReport)
+	{
+		Report = InReport;
+		SMultiColumnTableRow<TSharedPtr<FRMEBatchAssetReport>>::Construct(FSuperRowType::FArguments(), OwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		FText Text;
+		FSlateColor Color = FSlateColor::UseForeground();
+		if (ColumnName == RMEBatchPanelColumns::Asset)
+		{
+			Text = FText::FromString(Report->AssetName);
+		}
+		else if (ColumnName == RMEBatchPanelColumns::Result)
+		{
+			switch (Report->Result)
+			{
+			case ERMEBatchResult::Succeeded:
+				Text = LOCTEXT("ResultSucceeded", "Succeeded");
+				Color = FLinearColor::Green;
+				break;
+			case ERMEBatchResult::Skipped:
+				Text = LOCTEXT("ResultSkipped", "Skipped");
+				Color = FLinearColor::Yellow;
+				break;
+			case ERMEBatchResult::Failed:
+			default:
+				Text = LOCTEXT("ResultFailed", "Failed");
+				Color = FLinearColor::Red;
+				break;
+			}
+		}
+		else if (ColumnName == RMEBatchPanelColumns::Keys)
+		{
+			Text = FText::AsNumber(Report->NumKeys);
+		}
+		else if (ColumnName == RMEBatchPanelColumns::Distance)
+		{
+			Text = FText::Format(LOCTEXT("DistanceFormat", "{0} -> {1} cm"), FText::AsNumber(Report->DistanceBefore), FText::AsNumber(Report->DistanceAfter));
+		}
+		else if (ColumnName == RMEBatchPanelColumns::Time)
+		{
+			Text = FText::Format(LOCTEXT("TimeFormat", "{0} ms"), FText::AsNumber(Report->ProcessSeconds * 1000.0));
+		}
+		else if (ColumnName == RMEBatchPanelColumns::Message)
+		{
+			Text = Report->Message;
+		}
+
+		return SNew(STextBlock)
+			.Text(Text)
+			.ColorAndOpacity(Color)
+			.ToolTipText(Text);
+	}
+
+private:
+	TSharedPtr<FRMEBatchAssetReport> Report;
+};
+
+void SRMEBatchPanel::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager)
+{
+	TabManager->RegisterTabSpawner(
+			TabName,
+			FOnSpawnTab::CreateLambda(
+				[=](const FSpawnTabArgs&)
+				{
+					return SNew(SDockTab)
+						.TabRole(ETabRole::PanelTab)
+						.Label(LOCTEXT("BatchTitle", "Batch"))
+						[
+							SNew(SRMEBatchPanel)
+						];
+				}
+			)
+		)
+		.SetDisplayName(LOCTEXT("BatchTabTitle", "Batch"))
+		.SetTooltipText(LOCTEXT("BatchTooltipText", "Open the Batch tab, to apply the same root motion operations to many animations."));
+}
+
+SRMEBatchPanel::SRMEBatchPanel()
+{
+	Settings = NewObject<URMEBatchSettings>();
+	Settings->AddToRoot();
+}
+
+SRMEBatchPanel::~SRMEBatchPanel()
+{
+	Settings->RemoveFromRoot();
+}
+
+void SRMEBatchPanel::Construct(const FArguments& InArgs)
+{
+	FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
+	{
+		FDetailsViewArgs ViewArgs;
+		{
+			ViewArgs.bHideSelectionTip = true;
+			ViewArgs.bAllowSearch = false;
+		}
+		Widget = PropertyModule.CreateDetailView(ViewArgs);
+		Widget->SetObject(Settings);
+	}
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+SVerticalBox::Slot()
+		.FillHeight(0.6f)
+		[
+			SNew(SScrollBox)
+			+SScrollBox::Slot()
+			[
+				Widget.ToSharedRef()
+			]
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5.f)
+		[
+			MakeButtons()
+		]
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5.f, 0.f)
+		[
+			SNew(STextBlock)
+			.Text(this, &SRMEBatchPanel::GetSummaryText)
+		]
+		+SVerticalBox::Slot()
+		.FillHeight(0.4f)
+		[
+			SAssignNew(ReportView, SListView<TSharedPtr<FRMEBatchAssetReport>>)
+			.ListItemsSource(&Reports)
+			.SelectionMode(ESelectionMode::None)
+			.OnGenerateRow(this, &SRMEBatchPanel::OnGenerateReportRow)
+			.HeaderRow
+			(
+				SNew(SHeaderRow)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Asset).DefaultLabel(LOCTEXT("AssetColumn", "Asset")).FillWidth(0.25f)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Result).DefaultLabel(LOCTEXT("ResultColumn", "Result")).FillWidth(0.1f)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Keys).DefaultLabel(LOCTEXT("KeysColumn", "Keys")).FillWidth(0.08f)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Distance).DefaultLabel(LOCTEXT("DistanceColumn", "Distance")).FillWidth(0.17f)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Time).DefaultLabel(LOCTEXT("TimeColumn", "Time")).FillWidth(0.1f)
+				+SHeaderRow::Column(RMEBatchPanelColumns::Message).DefaultLabel(LOCTEXT("MessageColumn", "Message")).FillWidth(0.3f)
+			)
+		]
+	];
+}
+
+TSharedRef<SWidget> SRMEBatchPanel::MakeButtons()
+{
+	return SNew(SHorizontalBox)
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(0.f, 0.f, 4.f, 0.f)
+		[
+			SNew(SButton)
+			.Text(LOCTEXT("AddSelectedAssets", "Add Selected Assets"))
+			.ToolTipText(LOCTEXT("AddSelectedAssetsTooltip", "Add the animation sequences selected in the Content Browser."))
+			.OnClicked(this, &SRMEBatchPanel::OnAddSelectedAssets)
+		]
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(0.f, 0.f, 4.f, 0.f)
+		[
+			SNew(SButton)
+			.Text(LOCTEXT("ClearAssets", "Clear Assets"))
+			.OnClicked(this, &SRMEBatchPanel::OnClearAssets)
+		]
+		+SHorizontalBox::Slot()
+		.AutoWidth()
+		[
+			SNew(SButton)
+			.Text(LOCTEXT("RunBatch", "Run"))
+			.ToolTipText(LOCTEXT("RunBatchTooltip", "Bake the root motion of every animation, apply the operations in order and write the result back."))
+			.IsEnabled(this, &SRMEBatchPanel::CanRunBatch)
+			.OnClicked(this, &SRMEBatchPanel::OnRunBatch)
+		];
+}
+
+TSharedRef<ITableRow> SRMEBatchPanel::OnGenerateReportRow(TSharedPtr<FRMEBatchAssetReport> InReport, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SRMEBatchReportRow, OwnerTable, InReport);
+}
+
+FReply SRMEBatchPanel::OnAddSelectedAssets()
+{
+	FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+	TArray<FAssetData> SelectedAssets;
+	ContentBrowserModule.Get().GetSelectedAssets(SelectedAssets);
+
+	for (const FAssetData& AssetData : SelectedAssets)
+	{
+		if (UAnimSequence* Animation = Cast<UAnimSequence>(AssetData.GetAsset()))
+		{
+			Settings->Animations.AddUnique(Animation);
+		}
+	}
+
+	Widget->ForceRefresh();
+	return FReply::Handled();
+}
+
+FReply SRMEBatchPanel::OnClearAssets()
+{
+	Settings->Animations.Reset();
+	Widget->ForceRefresh();
+	return FReply::Handled();
+}
+
+FReply SRMEBatchPanel::OnRunBatch()
+{
+	if (Settings->bWriteBack)
+	{
+		const EAppReturnType::Type Choice = FMessageDialog::Open(EAppMsgType::YesNo, FText::Format(LOCTEXT("OverrideBatchAnimData",
+			"It will override the root skeleton data of {0} animations. Are you sure ?"), FText::AsNumber(Settings->Animations.Num())));
+		if (Choice == EAppReturnType::No)
+		{
+			return FReply::Handled();
+		}
+	}
+
+	Reports.Reset();
+	for (FRMEBatchAssetReport& Report : FRMEBatchProcessor::Run(*Settings))
+	{
+		Reports.Add(MakeShared<FRMEBatchAssetReport>(MoveTemp(Report)));
+	}
+
+	ReportView->RequestListRefresh();
+	return FReply::Handled();
+}
+
+bool SRMEBatchPanel::CanRunBatch() const
+{
+	return Settings && Settings->Animations.Num() > 0;
+}
+
+FText SRMEBatchPanel::GetSummaryText() const
+{
+	if (Reports.Num() == 0)
+	{
+		return LOCTEXT("NoReport", "Run the batch to see the report.");
+	}
+
+	int32 NumSucceeded = 0, NumSkipped = 0, NumFailed = 0;
+	for (const TSharedPtr<FRMEBatchAssetReport>& Report : Reports)
+	{
+		NumSucceeded += Report->Result == ERMEBatchResult::Succeeded;
+		NumSkipped += Report->Result == ERMEBatchResult::Skipped;
+		NumFailed += Report->Result == ERMEBatchResult::Failed;
+	}
+
+	return FText::Format(LOCTEXT("ReportSummary", "{0} succeeded, {1} skipped, {2} failed."), NumSucceeded, NumSkipped, NumFailed);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+
+struct FRMEBatchAssetReport;
+
+/**
+ * Applies a recorded operation list to many animations: bake the root motion, reshape it, write it back.
+ * Shows one report row per animation once the batch is done.
+ */
+class SRMEBatchPanel : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SRMEBatchPanel) { }
+	SLATE_END_ARGS()
+
+	static FName TabName;
+
+	static void RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager);
+
+public:
+	SRMEBatchPanel();
+	virtual ~SRMEBatchPanel();
+
+	void Construct(const FArguments& InArgs);
+
+	class URMEBatchSettings* GetSettings() const { return Settings; }
+
+protected:
+	TSharedRef<SWidget> MakeButtons();
+	TSharedRef<class ITableRow> OnGenerateReportRow(TSharedPtr<FRMEBatchAssetReport> InReport, const TSharedRef<class STableViewBase>& OwnerTable);
+
+	FReply OnAddSelectedAssets();
+	FReply OnClearAssets();
+	FReply OnRunBatch();
+	bool CanRunBatch() const;
+
+	FText GetSummaryText() const;
+
+protected:
+	TSharedPtr<IDetailsView> Widget;
+	TObjectPtr<class URMEBatchSettings> Settings = nullptr;
+
+	TArray<TSharedPtr<FRMEBatchAssetReport>> Reports;
+	TSharedPtr<SListView<TSharedPtr<FRMEBatchAssetReport>>> ReportView;
+};
@@ -3,6 +3,7 @@
 
 #include "SRMEPreview.h"
 #include "RMEContext.h"
+#include "RMEViewModel.h"
 #include "SRMEViewport.h"
 #include "SSimpleTimeSlider.h"
 #include "Widgets/Input/SSegmentedControl.h"
@@ -11,46 +12,70 @@
 
 const FName SRMEPreview::TabName = FName(TEXT("RootMotionEditorPreviewTab"));
 
-void SRMEPreview::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager)
+void SRMEPreview::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager, const TSharedRef<FRMEContext>& InContext)
 {
-	FRMEContext* Context = FRMEContext::Get();
-	checkf(Context, TEXT("This context of Root Motion Editor not found, please check it !!"));
-	
-	FRMEPreviewRequiredArgs RequiredArgs = Context->MakePreviewRequiredArgs();
+	FRMEPreviewRequiredArgs RequiredArgs = InContext->MakePreviewRequiredArgs();
+	TWeakPtr<FRMEContext> WeakContext = InContext;
 	
 	TabManager->RegisterTabSpawner(
 			TabName,
 			FOnSpawnTab::CreateLambda(
 				[=](const FSpawnTabArgs&)
 				{
+					TSharedPtr<FRMEContext> SharedContext = WeakContext.Pin();
+					if (!SharedContext.IsValid())
+					{
+						// The session was closed before the tab was restored.
+						return SNew(SDockTab)
+							.TabRole(ETabRole::PanelTab)
+							.Label(LOCTEXT("PreviewTitle", "Root Motion Editor Preview"));
+					}
+
 					return SNew(SDockTab)
 						.TabRole(ETabRole::PanelTab)
 						.Label(LOCTEXT("PreviewTitle", "Root Motion Editor Preview"))
 						[
 							SNew(SRMEPreview, RequiredArgs)
-							.SliderColor_Lambda([&Context]()
+							.SliderColor_Lambda([WeakContext]()
 							{
-								return Context->IsEditorSelection() ? FLinearColor::Red.CopyWithNewOpacity(0.5f) : FLinearColor::Blue.CopyWithNewOpacity(0.5f);
+								TSharedPtr<FRMEContext> Context = WeakContext.Pin();
+								return Context.IsValid() && Context->IsEditorSelection() ? FLinearColor::Red.CopyWithNewOpacity(0.5f) : FLinearColor::Blue.CopyWithNewOpacity(0.5f);
 							})
-							.SliderScrubTime_Lambda([&Context]()
+							.SliderScrubTime_Lambda([WeakContext]()
 							{
-								return Context->GetViewModelPlayTime();
+								TSharedPtr<FRMEContext> Context = WeakContext.Pin();
+								return Context.IsValid() ? Context->GetViewModelPlayTime() : 0.f;
 							})
-							.SliderViewRange_Lambda([&Context]()
+							.SliderViewRange_Lambda([WeakContext]()
 							{
-								return Context->GetViewModelPlayTimeRange();
+								TSharedPtr<FRMEContext> Context = WeakContext.Pin();
+								return Context.IsValid() ? Context->GetViewModelPlayTimeRange() : TRange<double>(0.0, 1.0);
 							})
-							.OnSliderScrubPositionChanged_Lambda([&Context](float NewScrubPosition, bool bScrubbing)
+							.OnSliderScrubPositionChanged_Lambda([WeakContext](float NewScrubPosition, bool bScrubbing)
 							{
-								Context->SetViewModelPlayTime(NewScrubPosition, !bScrubbing);
+								TSharedPtr<FRMEContext> Context = WeakContext.Pin();
+								if (!Context.IsValid())
+								{
+									return;
+								}
+
+								// Mouse moves can fire many times per frame, the view model applies the latest one on tick.
+								if (bScrubbing)
+								{
+									Context->RequestViewModelPlayTime(NewScrubPosition);
+								}
+								else
+								{
+									Context->SetViewModelPlayTime(NewScrubPosition, true);
+								}
 							})
-							.OnBackwardEnd_Raw(Context, &FRMEContext::PreviewBackwardEnd)
-							.OnBackwardStep_Raw(Context, &FRMEContext::PreviewBackwardStep)
-							.OnBackward_Raw(Context, &FRMEContext::PreviewBackward)
-							.OnPause_Raw(Context, &FRMEContext::PreviewPause)
-							.OnForward_Raw(Context, &FRMEContext::PreviewForward)
-							.OnForwardStep_Raw(Context, &FRMEContext::PreviewForwardStep)
-							.OnForwardEnd_Raw(Context, &FRMEContext::PreviewForwardEnd)
+							.OnBackwardEnd_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewBackwardEnd)
+							.OnBackwardStep_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewBackwardStep)
+							.OnBackward_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewBackward)
+							.OnPause_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewPause)
+							.OnForward_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewForward)
+							.OnForwardStep_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewForwardStep)
+							.OnForwardEnd_SP(SharedContext.ToSharedRef(), &FRMEContext::PreviewForwardEnd)
 						];
 				}
 			)
@@ -61,6 +86,7 @@ void SRMEPreview::RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager)
 
 void SRMEPreview::Construct(const FArguments& InArgs, const FRMEPreviewRequiredArgs& InRequiredArgs)
 {
+	ViewModel = InRequiredArgs.ViewModel;
 	SliderColor = InArgs._SliderColor;
 	SliderScrubTime = InArgs._SliderScrubTime;
 	SliderViewRange = InArgs._SliderViewRange;
@@ -172,19 +198,19 @@ TSharedRef<SWidget> SRMEPreview::GenerateMenu() const
 	FToolBarBuilder ToolBarBuilder(TSharedPtr<FUICommandList>(), FMultiBoxCustomization::None);
 
 	auto RootMotionViewModeControlWidget = SNew(SSegmentedControl<ERMERootMotionViewMode>)
-		.Value_Lambda([]()
+		.Value_Lambda([WeakViewModel = ViewModel]()
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (TSharedPtr<FRMEViewModel> ViewModelPtr = WeakViewModel.Pin())
 			{
-				return Context->GetRootMotionViewMode();
+				return ViewModelPtr->GetRootMotionViewMode();
 			}
 			return ERMERootMotionViewMode::None;
 		})
-		.OnValueChanged_Lambda([](ERMERootMotionViewMode NewMode)
+		.OnValueChanged_Lambda([WeakViewModel = ViewModel](ERMERootMotionViewMode NewMode)
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (TSharedPtr<FRMEViewModel> ViewModelPtr = WeakViewModel.Pin())
 			{
-				Context->SetRootMotionViewMode(NewMode);
+				ViewModelPtr->SetRootMotionViewMode(NewMode);
 			}
 		})
 		+SSegmentedControl<ERMERootMotionViewMode>::Slot(ERMERootMotionViewMode::None)
@@ -202,19 +228,19 @@ TSharedRef<SWidget> SRMEPreview::GenerateMenu() const
 	ToolBarBuilder.AddSeparator();
 
 	auto PreviewEditModeControlWidget = SNew(SSegmentedControl<ERMEPreviewEditMode>)
-		.Value_Lambda([]()
+		.Value_Lambda([WeakViewModel = ViewModel]()
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (TSharedPtr<FRMEViewModel> ViewModelPtr = WeakViewModel.Pin())
 			{
-				return Context->GetPreviewEditMode();
+				return ViewModelPtr->GetPreviewEditMode();
 			}
 			return ERMEPreviewEditMode::View;
 		})
-		.OnValueChanged_Lambda([](ERMEPreviewEditMode NewMode)
+		.OnValueChanged_Lambda([WeakViewModel = ViewModel](ERMEPreviewEditMode NewMode)
 		{
-			if (FRMEContext* Context = FRMEContext::Get())
+			if (TSharedPtr<FRMEViewModel> ViewModelPtr = WeakViewModel.Pin())
 			{
-				Context->SetPreviewEditMode(NewMode);
+				ViewModelPtr->SetPreviewEditMode(NewMode);
 			}
 		})
 		+SSegmentedControl<ERMEPreviewEditMode>::Slot(ERMEPreviewEditMode::View)
@@ -33,7 +33,7 @@ public:
 	const static FName TabName;
 
 public:
-	static void RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager);
+	static void RegisterTabSpawner(const TSharedPtr<FTabManager>& TabManager, const TSharedRef<class FRMEContext>& InContext);
 	
 
 	void Construct(const FArguments& InArgs, const FRMEPreviewRequiredArgs& InRequiredArgs);
@@ -51,4 +51,6 @@ protected:
 	FOnButtonClickedEvent OnForward;
 	FOnButtonClickedEvent OnForwardStep;
 	FOnButtonClickedEvent OnForwardEnd;
+
+	TWeakPtr<FRMEViewModel> ViewModel;
 };
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "UnrealWidget.h"
 #include "RMETypes.h"
 #include "Animation/DebugSkelMeshComponent.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Text/STextBlock.h"
 
 #define LOCTEXT_NAMESPACE "SRMEViewport"
 
@@ -59,8 +61,18 @@ void FRMEViewportClient::Draw(const FSceneView* View, FPrimitiveDrawInterface* P
 	
 	FEditorViewportClient::Draw(View, PDI);
 
+	NumDrawnPrimitives = 0;
 
+	const double DrawStartTime = FPlatformTime::Seconds();
 	DrawRootMotionData(PreviewComponent, PDI);
+	const double DrawSeconds = FPlatformTime::Seconds() - DrawStartTime;
+
+	DrawGhostPoses(PDI);
+
+	FRMEPerfCounters& Counters = ViewModePtr->GetPerfCounters();
+	++Counters.Frames;
+	Counters.DrawRootMotionDataSeconds += DrawSeconds;
+	Counters.DrawnPrimitives += NumDrawnPrimitives;
 }
 
 void FRMEViewportClient::TrackingStarted(const struct FInputEventState& InInputState, bool bIsDragging, bool bNudge)
@@ -87,6 +99,9 @@ bool FRMEViewportClient::CanDrawPreviewComponent(UDebugSkelMeshComponent* MeshCo
 
 void FRMEViewportClient::DrawRootMotionData(UDebugSkelMeshComponent* MeshComponent, FPrimitiveDrawInterface* PDI) const
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRMEViewportClient::DrawRootMotionData);
+	SCOPE_CYCLE_COUNTER(STAT_RME_DrawRootMotionData);
+
 	constexpr float DepthBias = 2.0f;
 	constexpr bool bScreenSpace = true;
 	
@@ -119,21 +134,75 @@ void FRMEViewportClient::DrawRootMotionData(UDebugSkelMeshComponent* MeshCompone
 	check(Skeleton);
 	EAxis::Type SkeletonForwardAxis = Skeleton->GetPreviewForwardAxis();
 	
+	// Draw root motion trajectory
+	if (ViewModelPtr->IsComparingTrajectories())
+	{
+		const FRMETrajectorySamples* AssetSamples = ViewModelPtr->GetTrajectorySamples(ERMERootMotionViewMode::Asset);
+		const FRMETrajectorySamples* EditorSamples = ViewModelPtr->GetTrajectorySamples(ERMERootMotionViewMode::Editor);
+		if (AssetSamples)
+		{
+			DrawTrajectory(PDI, *AssetSamples, FColor(40, 90, 255, 96), ERMETrajectoryColorMode::None, VisMode, SkeletonForwardAxis);
+		}
+		if (EditorSamples)
+		{
+			DrawTrajectory(PDI, *EditorSamples, FColor(255, 140, 20, 160), ViewModelPtr->GetTrajectoryColorMode(), VisMode, SkeletonForwardAxis);
+		}
+		if (AssetSamples && EditorSamples)
+		{
+			if (const FRMETrajectoryDeviation* Deviation = ViewModelPtr->GetTrajectoryDeviation())
+			{
+				DrawTrajectoryDeviation(PDI, *AssetSamples, *EditorSamples, *Deviation);
+			}
+		}
+	}
+	else if (const FRMETrajectorySamples* Samples = ViewModelPtr->GetTrajectorySamples())
+	{
+		DrawTrajectory(PDI, *Samples, TrajectoryColor, ViewModelPtr->GetTrajectoryColorMode(), VisMode, SkeletonForwardAxis);
+	}
+	
+	// Draw current location on the root motion.
+	{
+		const float CurrentTime = MeshComponent->GetPosition();
+		const FTransform& Transform = ViewModelPtr->GetRootMotionTransform(CurrentTime);
+
+		const FVector XAxis = Transform.GetUnitAxis(SkeletonForwardAxis);
+		const FColor AxisColor = RootMotionEditorStatics::GetColorForAxis(SkeletonForwardAxis);
+
+		FVector YAxis, ZAxis;
+		XAxis.FindBestAxisVectors(YAxis,ZAxis);
+
+		if (VisMode == EVisualizeRootMotionMode::TrajectoryAndOrientation)
+		{
+			RootMotionEditorStatics::DrawFlatArrow(PDI, Transform.GetLocation(), XAxis, ZAxis, AxisColor, 30.0f, 15, GEngine->ArrowMaterialYellow->GetRenderProxy(), SDPG_Foreground, 1.0f);
+			++NumDrawnPrimitives;
+		}
+		RootMotionEditorStatics::DrawCoordinateSystem(PDI, Transform, 10.0f, 20.0f, DepthBias, bScreenSpace, 200);
+		NumDrawnPrimitives += 3;
+	}
+}
+
+void FRMEViewportClient::DrawTrajectory(FPrimitiveDrawInterface* PDI, const FRMETrajectorySamples& Samples, const FColor& TrajectoryColor, ERMETrajectoryColorMode ColorMode,
+	EVisualizeRootMotionMode VisMode, EAxis::Type SkeletonForwardAxis) const
+{
+	constexpr float DepthBias = 2.0f;
+	constexpr bool bScreenSpace = true;
+
 	FVector PrevLocation;
 	
-	// Draw root motion trajectory
-	const int32 NumFrames = Animation->GetNumberOfSampledKeys();
-	const float PlayLength = Animation->GetPlayLength();
-	const FFrameRate FrameRate = Animation->GetSamplingFrameRate();
-	for (int32 Frame = 0; Frame <= NumFrames; Frame++)
+	const int32 NumSamples = Samples.Num();
+	INC_DWORD_STAT_BY(STAT_RME_DrawnTrajectorySamples, NumSamples);
+	for (int32 Frame = 0; Frame < NumSamples; Frame++)
 	{
-		const double Time = FMath::Clamp(FrameRate.AsSeconds(Frame), 0., (double)PlayLength);
-		const FTransform& Transform = ViewModelPtr->GetRootMotionTransform(Time);
+		const FTransform& Transform = Samples.Transforms[Frame];
 		const FVector Location = Transform.GetLocation();
 
-		const bool bFirstOrLastPoint = Frame == 0 || Frame == NumFrames;
+		const bool bFirstOrLastPoint = Frame == 0 || Frame == NumSamples - 1;
+		const FColor SampleColor = ColorMode == ERMETrajectoryColorMode::None
+			? TrajectoryColor
+			: FRMETrajectoryCache::GetHeatmapColor(Samples.GetNormalizedValue(ColorMode, Frame), 200);
 
-		PDI->DrawPoint(Location, TrajectoryColor, bFirstOrLastPoint ? 12.f : 6.f, SDPG_World);
+		PDI->DrawPoint(Location, SampleColor, bFirstOrLastPoint ? 12.f : 6.f, SDPG_World);
+		++NumDrawnPrimitives;
 
 		if (VisMode == EVisualizeRootMotionMode::TrajectoryAndOrientation)
 		{
@@ -145,33 +214,85 @@ void FRMEViewportClient::DrawRootMotionData(UDebugSkelMeshComponent* MeshCompone
 				FVector YAxis, ZAxis;
 				XAxis.FindBestAxisVectors(YAxis,ZAxis);
 				RootMotionEditorStatics::DrawFlatArrow(PDI, Transform.GetLocation(), XAxis, ZAxis, AxisColor.WithAlpha(64), 15.0f, 8, nullptr, SDPG_World, 1.0f);
+				++NumDrawnPrimitives;
 			}
 		}
 
 		if (Frame > 0)
 		{
-			PDI->DrawTranslucentLine(PrevLocation, Location, TrajectoryColor, SDPG_World, 1.0f, DepthBias, bScreenSpace);
+			PDI->DrawTranslucentLine(PrevLocation, Location, SampleColor, SDPG_World, ColorMode == ERMETrajectoryColorMode::None ? 1.0f : 2.0f, DepthBias, bScreenSpace);
+			++NumDrawnPrimitives;
 		}
 		PrevLocation = Location;
 	}
+}
 
-	
-	// Draw current location on the root motion.
+void FRMEViewportClient::DrawTrajectoryDeviation(FPrimitiveDrawInterface* PDI, const FRMETrajectorySamples& AssetSamples, const FRMETrajectorySamples& EditorSamples,
+	const FRMETrajectoryDeviation& Deviation) const
+{
+	const int32 NumSamples = FMath::Min3(AssetSamples.Num(), EditorSamples.Num(), Deviation.Num());
+	if (NumSamples == 0 || Deviation.MaxDeviation <= UE_KINDA_SMALL_NUMBER)
 	{
-		const float CurrentTime = MeshComponent->GetPosition();
-		const FTransform& Transform = ViewModelPtr->GetRootMotionTransform(CurrentTime);
+		return;
+	}
 
-		const FVector XAxis = Transform.GetUnitAxis(SkeletonForwardAxis);
-		const FColor AxisColor = RootMotionEditorStatics::GetColorForAxis(SkeletonForwardAxis);
+	// Connect matching frames, colored by how far apart they are.
+	for (int32 Frame = 0; Frame < NumSamples; Frame++)
+	{
+		const float NormalizedDeviation = Deviation.Deviations[Frame] / Deviation.MaxDeviation;
+		if (NormalizedDeviation <= UE_KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
 
-		FVector YAxis, ZAxis;
-		XAxis.FindBestAxisVectors(YAxis,ZAxis);
+		const FColor DeviationColor = FRMETrajectoryCache::GetHeatmapColor(NormalizedDeviation, 96);
+		PDI->DrawTranslucentLine(AssetSamples.Transforms[Frame].GetLocation(), EditorSamples.Transforms[Frame].GetLocation(), DeviationColor, SDPG_World, 1.0f);
+		++NumDrawnPrimitives;
+	}
 
-		if (VisMode == EVisualizeRootMotionMode::TrajectoryAndOrientation)
+	if (Deviation.MaxDeviationIndex != INDEX_NONE && Deviation.MaxDeviationIndex < NumSamples)
+	{
+		PDI->DrawPoint(EditorSamples.Transforms[Deviation.MaxDeviationIndex].GetLocation(), FColor::Red, 14.f, SDPG_Foreground);
+		++NumDrawnPrimitives;
+	}
+}
+
+void FRMEViewportClient::DrawGhostPoses(FPrimitiveDrawInterface* PDI) const
+{
+	FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get();
+	const FRMEPoseCache* GhostPoses = ViewModelPtr ? ViewModelPtr->GetGhostPoses() : nullptr;
+	if (GhostPoses == nullptr)
+	{
+		return;
+	}
+
+	const TArray<int32>& ParentIndices = GhostPoses->GetParentIndices();
+	const TArray<FRMECachedPose>& Poses = GhostPoses->GetPoses();
+	for (int32 PoseIndex = 0; PoseIndex < Poses.Num(); ++PoseIndex)
+	{
+		const FRMECachedPose& Pose = Poses[PoseIndex];
+		if (Pose.ComponentSpaceTransforms.Num() != ParentIndices.Num())
 		{
-			RootMotionEditorStatics::DrawFlatArrow(PDI, Transform.GetLocation(), XAxis, ZAxis, AxisColor, 30.0f, 15, GEngine->ArrowMaterialYellow->GetRenderProxy(), SDPG_Foreground, 1.0f);
+			continue;
+		}
+
+		// Fade from the first ghost to the last one, so the direction of time is readable.
+		const float Alpha = Poses.Num() > 1 ? static_cast<float>(PoseIndex) / (Poses.Num() - 1) : 1.f;
+		const FColor GhostColor = FLinearColor::LerpUsingHSV(FLinearColor(0.2f, 0.4f, 1.f), FLinearColor(1.f, 0.5f, 0.1f), Alpha).ToFColor(true).WithAlpha(128);
+
+		for (int32 BoneIndex = 0; BoneIndex < ParentIndices.Num(); ++BoneIndex)
+		{
+			const int32 ParentIndex = ParentIndices[BoneIndex];
+			if (ParentIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FVector Start = Pose.RootMotionTransform.TransformPosition(Pose.ComponentSpaceTransforms[ParentIndex].GetLocation());
+			const FVector End = Pose.RootMotionTransform.TransformPosition(Pose.ComponentSpaceTransforms[BoneIndex].GetLocation());
+			PDI->DrawTranslucentLine(Start, End, GhostColor, SDPG_World, 1.0f);
+			++NumDrawnPrimitives;
 		}
-		RootMotionEditorStatics::DrawCoordinateSystem(PDI, Transform, 10.0f, 20.0f, DepthBias, bScreenSpace, 200);
 	}
 }
 
@@ -228,19 +349,49 @@ FText SRMEViewport::GetDisplayString() const
 	FText RootMotionModeText = FText::Format(LOCTEXT("RootMotionModeText", "Root Motion Mode: {0}"), StaticEnum<ERMERootMotionViewMode>()->GetDisplayNameTextByValue(GetRootMotionViewMode()));
 	DefaultText = ConcatenateLine(DefaultText, RootMotionModeText);
 
-	if (FRMEContext* Context = FRMEContext::Get())
+	if (const TSharedPtr<FRMEViewModel> ViewModelPtr = ViewModel.Pin())
 	{
 		const FText PreviewEditModeText = FText::Format(
 			LOCTEXT("PreviewEditModeText", "Preview Tool: {0}"),
-			StaticEnum<ERMEPreviewEditMode>()->GetDisplayNameTextByValue((int64)Context->GetPreviewEditMode()));
+			StaticEnum<ERMEPreviewEditMode>()->GetDisplayNameTextByValue((int64)ViewModelPtr->GetPreviewEditMode()));
 		DefaultText = ConcatenateLine(DefaultText, PreviewEditModeText);
 
-		if (Context->GetPreviewEditMode() == ERMEPreviewEditMode::Translation)
+		if (ViewModelPtr->GetPreviewEditMode() == ERMEPreviewEditMode::Translation)
 		{
 			DefaultText = ConcatenateLine(DefaultText, LOCTEXT("PreviewEditModeHelp", "Move the widget and press S to save a translation key."));
 		}
 	}
 
+	if (FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		if (ViewModelPtr->IsComparingTrajectories())
+		{
+			if (const FRMETrajectoryDeviation* Deviation = ViewModelPtr->GetTrajectoryDeviation())
+			{
+				const FText DeviationText = FText::Format(
+					LOCTEXT("TrajectoryDeviationText", "Asset vs Editor: max {0} cm, RMS {1} cm, end drift {2} cm"),
+					FText::AsNumber(Deviation->MaxDeviation),
+					FText::AsNumber(Deviation->RmsDeviation),
+					FText::AsNumber(Deviation->EndDrift));
+				DefaultText = ConcatenateLine(DefaultText, DeviationText);
+			}
+		}
+
+		const ERMETrajectoryColorMode ColorMode = ViewModelPtr->GetTrajectoryColorMode();
+		const FRMETrajectorySamples* Samples = ColorMode != ERMETrajectoryColorMode::None ? ViewModelPtr->GetTrajectorySamples() : nullptr;
+		if (Samples && Samples->Num() > 0)
+		{
+			const bool bIsSpeed = ColorMode == ERMETrajectoryColorMode::Speed;
+			const FText HeatmapText = FText::Format(
+				LOCTEXT("TrajectoryHeatmapText", "{0}: blue {1} - red {2} {3}"),
+				StaticEnum<ERMETrajectoryColorMode>()->GetDisplayNameTextByValue((int64)ColorMode),
+				FText::AsNumber(bIsSpeed ? Samples->MinSpeed : Samples->MinAcceleration),
+				FText::AsNumber(bIsSpeed ? Samples->MaxSpeed : Samples->MaxAcceleration),
+				bIsSpeed ? LOCTEXT("SpeedUnit", "cm/s") : LOCTEXT("AccelerationUnit", "cm/s²"));
+			DefaultText = ConcatenateLine(DefaultText, HeatmapText);
+		}
+	}
+
 	FText VisualizeText = StaticEnum<EVisualizeRootMotionMode>()->GetDisplayNameTextByValue((int64)GetVisualizeRootMotionMode());
 	FText VisualizeModeText = FText::Format(LOCTEXT("VisualizeModeText", "Trajectory Mode: {0}"), VisualizeText);
 	DefaultText = ConcatenateLine(DefaultText, VisualizeModeText);
@@ -289,6 +440,76 @@ bool SRMEViewport::IsVisualizeRootMotionModeSet(EVisualizeRootMotionMode Mode) c
 	return false;
 }
 
+void SRMEViewport::SetTrajectoryColorMode(ERMETrajectoryColorMode ColorMode)
+{
+	if (FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		ViewModelPtr->SetTrajectoryColorMode(ColorMode);
+	}
+}
+
+bool SRMEViewport::IsTrajectoryColorModeSet(ERMETrajectoryColorMode ColorMode) const
+{
+	const FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get();
+	return ViewModelPtr && ViewModelPtr->GetTrajectoryColorMode() == ColorMode;
+}
+
+void SRMEViewport::ToggleCompareTrajectories()
+{
+	if (FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		ViewModelPtr->SetCompareTrajectories(!ViewModelPtr->IsComparingTrajectories());
+	}
+}
+
+bool SRMEViewport::IsComparingTrajectories() const
+{
+	const FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get();
+	return ViewModelPtr && ViewModelPtr->IsComparingTrajectories();
+}
+
+void SRMEViewport::ToggleShowGhostPoses()
+{
+	if (FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		ViewModelPtr->SetShowGhostPoses(!ViewModelPtr->IsShowingGhostPoses());
+	}
+}
+
+bool SRMEViewport::IsShowingGhostPoses() const
+{
+	const FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get();
+	return ViewModelPtr && ViewModelPtr->IsShowingGhostPoses();
+}
+
+int32 SRMEViewport::GetNumGhostPoses() const
+{
+	const FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get();
+	return ViewModelPtr ? ViewModelPtr->GetNumGhostPoses() : 0;
+}
+
+void SRMEViewport::SetNumGhostPoses(int32 InNumGhostPoses)
+{
+	if (FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		ViewModelPtr->SetNumGhostPoses(InNumGhostPoses);
+	}
+}
+
+EVisibility SRMEViewport::GetPerfHUDVisibility() const
+{
+	return bShowPerfHUD ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
+}
+
+FText SRMEViewport::GetPerfHUDText() const
+{
+	if (const FRMEViewModel* ViewModelPtr = ViewModel.Pin().Get())
+	{
+		PerfHUD.Update(ViewModelPtr->GetPerfCountersSnapshot());
+	}
+	return PerfHUD.GetText();
+}
+
 void SRMEViewport::BindCommands()
 {
 	SEditorViewport::BindCommands();
@@ -312,6 +533,42 @@ void SRMEViewport::BindCommands()
 		FExecuteAction::CreateSP(this, &SRMEViewport::SetVisualizeRootMotionMode, EVisualizeRootMotionMode::TrajectoryAndOrientation),
 		FIsActionChecked::CreateSP(this, &SRMEViewport::CanVisualizeRootMotion),
 		FIsActionChecked::CreateSP(this, &SRMEViewport::IsVisualizeRootMotionModeSet, EVisualizeRootMotionMode::TrajectoryAndOrientation));
+
+	CommandList->MapAction(
+		Commands.CompareTrajectories,
+		FExecuteAction::CreateSP(this, &SRMEViewport::ToggleCompareTrajectories),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsComparingTrajectories));
+
+	CommandList->MapAction(
+		Commands.ColorTrajectoryNone,
+		FExecuteAction::CreateSP(this, &SRMEViewport::SetTrajectoryColorMode, ERMETrajectoryColorMode::None),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsTrajectoryColorModeSet, ERMETrajectoryColorMode::None));
+
+	CommandList->MapAction(
+		Commands.ColorTrajectoryBySpeed,
+		FExecuteAction::CreateSP(this, &SRMEViewport::SetTrajectoryColorMode, ERMETrajectoryColorMode::Speed),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsTrajectoryColorModeSet, ERMETrajectoryColorMode::Speed));
+
+	CommandList->MapAction(
+		Commands.ColorTrajectoryByAcceleration,
+		FExecuteAction::CreateSP(this, &SRMEViewport::SetTrajectoryColorMode, ERMETrajectoryColorMode::Acceleration),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsTrajectoryColorModeSet, ERMETrajectoryColorMode::Acceleration));
+
+	CommandList->MapAction(
+		Commands.ShowGhostPoses,
+		FExecuteAction::CreateSP(this, &SRMEViewport::ToggleShowGhostPoses),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsShowingGhostPoses));
+
+	CommandList->MapAction(
+		Commands.ShowPerformanceHUD,
+		FExecuteAction::CreateSP(this, &SRMEViewport::ToggleShowPerfHUD),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateSP(this, &SRMEViewport::IsShowingPerfHUD));
 }
 
 TSharedRef<FEditorViewportClient> SRMEViewport::MakeEditorViewportClient()
@@ -334,11 +591,33 @@ TSharedPtr<SWidget> SRMEViewport::BuildViewportToolbar()
 	return SAssignNew(ViewportToolbar, SRMEViewportToolBar, SharedThis(this));
 }
 
+void SRMEViewport::PopulateViewportOverlays(TSharedRef<SOverlay> Overlay)
+{
+	SEditorViewport::PopulateViewportOverlays(Overlay);
+
+	Overlay->AddSlot()
+	.VAlign(VAlign_Bottom)
+	.HAlign(HAlign_Left)
+	.Padding(FMargin(6.f))
+	[
+		SNew(SBorder)
+		.Visibility(this, &SRMEViewport::GetPerfHUDVisibility)
+		.BorderImage(FAppStyle::GetBrush("FloatingBorder"))
+		.Padding(FMargin(6.f, 4.f))
+		[
+			SNew(STextBlock)
+			.Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))
+			.ColorAndOpacity(FLinearColor::White)
+			.Text(this, &SRMEViewport::GetPerfHUDText)
+		]
+	];
+}
+
 int64 SRMEViewport::GetRootMotionViewMode() const
 {
-	if (FRMEContext* Context = FRMEContext::Get())
+	if (const TSharedPtr<FRMEViewModel> ViewModelPtr = ViewModel.Pin())
 	{
-		return (int64)Context->GetRootMotionViewMode();
+		return (int64)ViewModelPtr->GetRootMotionViewMode();
 	}
 
 	return 0;
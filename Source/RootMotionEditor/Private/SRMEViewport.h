@@ -7,6 +7,8 @@
 #include "EditorViewportClient.h"
 #include "SCommonEditorViewportToolbarBase.h"
 #include "Animation/DebugSkelMeshComponent.h"
+#include "RMEPerfCounters.h"
+#include "RMETypes.h"
 
 
 class SRMEViewportToolBar;
@@ -47,7 +49,14 @@ public:
 	// ~End of FEditorViewportClient interface
 
 	virtual void DrawRootMotionData(UDebugSkelMeshComponent* MeshComponent, FPrimitiveDrawInterface* PDI) const;
-
+	void DrawGhostPoses(FPrimitiveDrawInterface* PDI) const;
+	void DrawTrajectory(FPrimitiveDrawInterface* PDI, const struct FRMETrajectorySamples& Samples, const FColor& TrajectoryColor, ERMETrajectoryColorMode ColorMode,
+		EVisualizeRootMotionMode VisMode, EAxis::Type SkeletonForwardAxis) const;
+	void DrawTrajectoryDeviation(FPrimitiveDrawInterface* PDI, const struct FRMETrajectorySamples& AssetSamples, const struct FRMETrajectorySamples& EditorSamples,
+		const struct FRMETrajectoryDeviation& Deviation) const;
+
+	/** Primitives issued by the draw functions during the current Draw, for the performance HUD. */
+	mutable uint32 NumDrawnPrimitives = 0;
 	
 	/** Asset editor we are embedded in */
 	TWeakPtr<FRMEViewModel> ViewModel;
@@ -72,15 +81,29 @@ public:
 	UDebugSkelMeshComponent* GetPreviewMeshComponent() const;
 	// ~End of ICommonEditorViewportToolbarInfoProvider interface
 
+	int32 GetNumGhostPoses() const;
+	void SetNumGhostPoses(int32 InNumGhostPoses);
+
 protected:
 	void SetVisualizeRootMotionMode(EVisualizeRootMotionMode Mode);
 	EVisualizeRootMotionMode GetVisualizeRootMotionMode() const;
 	bool CanVisualizeRootMotion() const;
 	bool IsVisualizeRootMotionModeSet(EVisualizeRootMotionMode Mode) const;
+	void SetTrajectoryColorMode(ERMETrajectoryColorMode ColorMode);
+	bool IsTrajectoryColorModeSet(ERMETrajectoryColorMode ColorMode) const;
+	void ToggleCompareTrajectories();
+	bool IsComparingTrajectories() const;
+	void ToggleShowGhostPoses();
+	bool IsShowingGhostPoses() const;
+	void ToggleShowPerfHUD() { bShowPerfHUD = !bShowPerfHUD; }
+	bool IsShowingPerfHUD() const { return bShowPerfHUD; }
+	EVisibility GetPerfHUDVisibility() const;
+	FText GetPerfHUDText() const;
 	// ~SEditorViewport interface
 	virtual void BindCommands() override;
 	virtual TSharedRef<FEditorViewportClient> MakeEditorViewportClient() override;
 	virtual TSharedPtr<SWidget> BuildViewportToolbar() override;
+	virtual void PopulateViewportOverlays(TSharedRef<SOverlay> Overlay) override;
 	int64 GetRootMotionViewMode() const;
 	// ~End of SEditorViewport interface
 
@@ -96,4 +119,7 @@ protected:
 
 	TWeakPtr<FRMEViewModel> ViewModel;
 
+	bool bShowPerfHUD = false;
+	/** Refreshed when the text is polled. */
+	mutable FRMEPerfHUD PerfHUD;
 };
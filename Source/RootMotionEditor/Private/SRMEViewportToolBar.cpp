@@ -5,6 +5,9 @@
 #include "SRMEViewport.h"
 #include "PreviewProfileController.h"
 #include "RMECommands.h"
+#include "RMEViewModel.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Layout/SBox.h"
 #include "Widgets/Text/SRichTextBlock.h"
 
 #define LOCTEXT_NAMESPACE "RootMotionEditedViewportToolBar"
@@ -17,6 +20,8 @@ void SRMEViewportToolBar::Construct(const FArguments& InArgs, TSharedPtr<SRMEVie
 			.PreviewProfileController(MakeShared<FPreviewProfileController>()),
 			InViewport);
 
+	ViewportPtr = InViewport;
+
 	TSharedRef<SWidget> ParentWidget = ChildSlot.GetWidget();
 
 	TSharedRef<SVerticalBox> TotalWidget = SNew(SVerticalBox)
@@ -55,6 +60,45 @@ TSharedRef<SWidget> SRMEViewportToolBar::GenerateShowMenu() const
 			ShowMenuBuilder.AddMenuEntry(Commands.DoNotVisualizeRootMotion);
 			ShowMenuBuilder.AddMenuEntry(Commands.VisualizeRootMotionTrajectory);
 			ShowMenuBuilder.AddMenuEntry(Commands.VisualizeRootMotionTrajectoryAndOrientation);
+			ShowMenuBuilder.AddMenuEntry(Commands.CompareTrajectories);
+			ShowMenuBuilder.EndSection();
+		}
+		{
+			ShowMenuBuilder.BeginSection("AnimViewportTrajectoryColor", LOCTEXT("CharacterMenu_TrajectoryColorLabel", "Trajectory Color"));
+			ShowMenuBuilder.AddMenuEntry(Commands.ColorTrajectoryNone);
+			ShowMenuBuilder.AddMenuEntry(Commands.ColorTrajectoryBySpeed);
+			ShowMenuBuilder.AddMenuEntry(Commands.ColorTrajectoryByAcceleration);
+			ShowMenuBuilder.EndSection();
+		}
+		{
+			ShowMenuBuilder.BeginSection("AnimViewportOnionSkin", LOCTEXT("CharacterMenu_OnionSkinLabel", "Onion Skin"));
+			ShowMenuBuilder.AddMenuEntry(Commands.ShowGhostPoses);
+			ShowMenuBuilder.AddWidget(
+				SNew(SBox)
+				.WidthOverride(100.f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(1)
+					.MaxValue(FRMEViewModel::MaxGhostPoses)
+					.Value_Lambda([WeakViewport = ViewportPtr]()
+					{
+						const TSharedPtr<SRMEViewport> Viewport = WeakViewport.Pin();
+						return Viewport.IsValid() ? Viewport->GetNumGhostPoses() : 0;
+					})
+					.OnValueChanged_Lambda([WeakViewport = ViewportPtr](int32 NewValue)
+					{
+						if (const TSharedPtr<SRMEViewport> Viewport = WeakViewport.Pin())
+						{
+							Viewport->SetNumGhostPoses(NewValue);
+						}
+					})
+				],
+				LOCTEXT("CharacterMenu_NumGhostPoses", "Ghost Count"));
+			ShowMenuBuilder.EndSection();
+		}
+		{
+			ShowMenuBuilder.BeginSection("AnimViewportPerformance", LOCTEXT("CharacterMenu_PerformanceLabel", "Performance"));
+			ShowMenuBuilder.AddMenuEntry(Commands.ShowPerformanceHUD);
 			ShowMenuBuilder.EndSection();
 		}
 	}
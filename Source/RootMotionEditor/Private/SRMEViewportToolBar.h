@@ -23,4 +23,7 @@ public:
 	// ~SCommonEditorViewportToolbarBase interface
 	virtual TSharedRef<SWidget> GenerateShowMenu() const override;
 	// ~End of SCommonEditorViewportToolbarBase interface
+
+private:
+	TWeakPtr<SRMEViewport> ViewportPtr;
 };
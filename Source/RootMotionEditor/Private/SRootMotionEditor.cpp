@@ -7,6 +7,7 @@
 #include "RootMotionEditorModule.h"
 #include "SRMEPreview.h"
 #include "SRMEAssetsSelector.h"
+#include "SRMEBatchPanel.h"
 #include "SRMEViewport.h"
 #include "WorkspaceMenuStructure.h"
 #include "WorkspaceMenuStructureModule.h"
@@ -15,6 +16,7 @@
 #define LOCTEXT_NAMESPACE "SRootMotionEditor"
 
 const FName SRootMotionEditor::WindowName(TEXT("RootMotionEditorMainTab"));
+int32 SRootMotionEditor::NextTabInstanceId = 1;
 
 void SRootMotionEditor::RegisterTabSpawner()
 {
@@ -77,17 +79,30 @@ TSharedRef<class SDockTab> SRootMotionEditor::SpawnRootMotionEditor(const class
 	auto MainWidget = SNew(SRootMotionEditor)
 		.TabManager(TabManager);
 
+	if (FRMEContext* Session = MainWidget->GetContext())
+	{
+		if (Session->GetSessionIndex() > 0)
+		{
+			NomadTab->SetLabel(FText::Format(LOCTEXT("FRootMotionEditorSessionTabTitle", "RootMotionEditor ({0})"), FText::AsNumber(Session->GetSessionIndex() + 1)));
+		}
+	}
+
 	NomadTab->SetContent(MainWidget);
 	return NomadTab;
 }
 
+void SRootMotionEditor::OpenNewSession()
+{
+	FGlobalTabmanager::Get()->TryInvokeTab(FTabId(SRootMotionEditor::WindowName, NextTabInstanceId++));
+}
+
 SRootMotionEditor::SRootMotionEditor()
 {
 }
 
 SRootMotionEditor::~SRootMotionEditor()
 {
-	if (FRMEContext* Context = FRMEContext::Get())
+	if (Context.IsValid())
 	{
 		Context->ClearCurveEditor();
 	}
@@ -97,25 +112,31 @@ SRootMotionEditor::~SRootMotionEditor()
 		CurveEditor->OnDestroy();
 	}
 	CurveEditor = nullptr;
+
+	if (Context.IsValid())
+	{
+		FRMEContext::DestroySession(Context.Get());
+		Context.Reset();
+	}
 }
 
 void SRootMotionEditor::Construct(const FArguments& InArgs)
 {
 	TabManager = InArgs._TabManager;
 
-	FRMEContext* Context = FRMEContext::Get();
+	Context = FRMEContext::CreateSession();
 	Context->InitTab(TabManager);
-	
-	FRMEPreviewRequiredArgs RequiredArgs = Context->MakePreviewRequiredArgs();
 
 	// Register DockTab.
-	SRMEAssetsSelector::RegisterTabSpawner(TabManager);
-	SRMEPreview::RegisterTabSpawner(TabManager);
+	SRMEAssetsSelector::RegisterTabSpawner(TabManager, Context.ToSharedRef());
+	SRMEPreview::RegisterTabSpawner(TabManager, Context.ToSharedRef());
+	SRMEBatchPanel::RegisterTabSpawner(TabManager);
 
 
 	if (!CurveEditor.IsValid())
 	{
 		CurveEditor = MakeShared<FRMECurveEditor>();
+		CurveEditor->SetContext(Context);
 		CurveEditor->Initialize();
 	}
 	Context->SetCurveEditor(CurveEditor);
@@ -125,7 +146,7 @@ void SRootMotionEditor::Construct(const FArguments& InArgs)
 
 	// Default Layout.
 	TSharedRef<FTabManager::FLayout> StandaloneDefaultLayout =
-		FTabManager::NewLayout("RootMotionEditor_StandaloneLayout_v0.7")
+		FTabManager::NewLayout("RootMotionEditor_StandaloneLayout_v0.8")
 			->AddArea
 			(
 				// Main application area
@@ -141,6 +162,7 @@ void SRootMotionEditor::Construct(const FArguments& InArgs)
 						FTabManager::NewStack()
 						->SetSizeCoefficient(0.6f)
 						->AddTab(SRMEAssetsSelector::TabName, ETabState::OpenedTab)
+						->AddTab(SRMEBatchPanel::TabName, ETabState::ClosedTab)
 						->SetHideTabWell(false)
 					)
 					->Split
@@ -233,7 +255,13 @@ TSharedRef<SWidget> SRootMotionEditor::MakeToolbar()
 	ToolbarBuilder.BeginStyleOverride("CalloutToolbar");
 	ToolbarBuilder.BeginSection("Main");
 
-	// TODO: Add button.
+	ToolbarBuilder.AddToolBarButton(
+		FUIAction(FExecuteAction::CreateStatic(&SRootMotionEditor::OpenNewSession)),
+		NAME_None,
+		LOCTEXT("NewSessionLabel", "New Session"),
+		LOCTEXT("NewSessionTooltip", "Open another Root Motion Editor tab, to edit another animation side by side."),
+		FSlateIcon(FAppStyle::GetAppStyleSetName(), "Icons.Plus")
+	);
 	
 	{
 		// ToolbarBuilder.AddToolBarButton(
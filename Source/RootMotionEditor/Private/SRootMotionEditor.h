@@ -24,6 +24,8 @@ public:
 	static void RegisterTabSpawner();
 	static void UnregisterTabSpawner();
 	static TSharedRef<class SDockTab> SpawnRootMotionEditor(const class FSpawnTabArgs& Args);
+	/** Open another editor tab with its own session. */
+	static void OpenNewSession();
 	/**
 	* Default constructor.
 	*/
@@ -34,6 +36,8 @@ public:
 	void Construct(const FArguments& InArgs);
 	
 	void FillWindowMenu(FMenuBuilder& MenuBuilder);
+
+	class FRMEContext* GetContext() const { return Context.Get(); }
 	
 protected:
 	TSharedRef<SWidget> MakeToolbar();
@@ -51,4 +55,9 @@ private:
 	TSharedPtr<class FRMECurveEditor> CurveEditor;
 
 	TSharedPtr<FTabManager> TabManager;
+
+	TSharedPtr<class FRMEContext> Context;
+
+	/** Instance id of the next session tab, the first tab uses the default one. */
+	static int32 NextTabInstanceId;
 };
@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "RMEBatchProcessor.h"
+#include "RMEBenchmark.h"
+#include "RMEStatics.h"
+#include "RMETypes.h"
+#include "Animation/AnimSequence.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RMEBakeTests
+{
+	/** 2 seconds at 30 fps, the synthetic root walks at 150 cm/s and turns 20 degrees per second. */
+	static constexpr int32 NumFrames = 60;
+	static constexpr int32 NumBones = 8;
+	static constexpr int32 FrameRate = 30;
+	static constexpr float Tolerance = 1.e-2f;
+	/** Evaluated poses blend the keys linearly, the sway is off the analytic one by a few hundredths between frames. */
+	static constexpr float PoseTolerance = 1.e-1f;
+
+	/** The first child of the root, named like the benchmark names its bones. */
+	static const FName ChildBoneName(TEXT("bone"), 1);
+
+	static FVector GetRootLocation(double Time)
+	{
+		return FVector(150.0 * Time, 10.0 * FMath::Sin(Time * UE_TWO_PI), 0.0);
+	}
+
+	static double GetRootYaw(double Time)
+	{
+		return 20.0 * Time;
+	}
+
+	/** The synthetic animation, kept alive until the test ends. */
+	struct FScopedSequence
+	{
+		UAnimSequence* Sequence = nullptr;
+
+		FScopedSequence()
+		{
+			Sequence = FRMEBenchmark::CreateSyntheticSequence(NumFrames, NumBones, FrameRate);
+			Sequence->AddToRoot();
+		}
+
+		~FScopedSequence()
+		{
+			Sequence->RemoveFromRoot();
+			Sequence->MarkAsGarbage();
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMEBakeRootBoneTest, "RootMotionEditor.Bake.RootBone",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMEBakeRootBoneTest::RunTest(const FString& Parameters)
+{
+	using namespace RMEBakeTests;
+	const FScopedSequence Scoped;
+
+	// Sampled at the frame rate of the animation, the bake reads the raw root keys. The key at a frame holds the root
+	// at that frame, from the first frame to the end.
+	const FTransformCurve Curve = RootMotionEditorStatics::BakeRootBoneToCurve(Scoped.Sequence, FrameRate, int32(ERMEBoneExtractChannelType::All));
+	if (!TestEqual(TEXT("Keys of the root motion bake"), Curve.TranslationCurve.FloatCurves[0].GetNumKeys(), NumFrames + 1))
+	{
+		return false;
+	}
+
+	for (int32 Frame = 0; Frame <= NumFrames; ++Frame)
+	{
+		const float Time = static_cast<float>(Frame) / FrameRate;
+		const FTransform Baked = Curve.Evaluate(Time, 1.f);
+		TestTrue(FString::Printf(TEXT("Root motion location at frame %d"), Frame), Baked.GetLocation().Equals(GetRootLocation(Time), Tolerance));
+		TestEqual(FString::Printf(TEXT("Root motion yaw at frame %d"), Frame), Baked.Rotator().Yaw, GetRootYaw(Time), static_cast<double>(Tolerance));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMEBakeRootBoneAdaptiveTest, "RootMotionEditor.Bake.RootBoneAdaptive",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMEBakeRootBoneAdaptiveTest::RunTest(const FString& Parameters)
+{
+	using namespace RMEBakeTests;
+	const FScopedSequence Scoped;
+
+	// With no tolerance and no room to split, the adaptive bake keeps every sample of the grid. It must give the keys of
+	// the fixed rate bake, from the raw keys at the rate of the animation and from the extracted root motion at another.
+	const int32 SampleRates[] = { FrameRate, 24 };
+	for (const int32 SampleRate : SampleRates)
+	{
+		FRMEAdaptiveSampling Settings;
+		Settings.bEnabled = true;
+		Settings.MinSampleRate = SampleRate;
+		Settings.MaxSampleRate = SampleRate;
+		Settings.TranslationTolerance = 0.f;
+		Settings.RotationTolerance = 0.f;
+		Settings.ScaleTolerance = 0.f;
+
+		const FTransformCurve Fixed = RootMotionEditorStatics::BakeRootBoneToCurve(Scoped.Sequence, SampleRate, int32(ERMEBoneExtractChannelType::All));
+		const FTransformCurve Adaptive = RootMotionEditorStatics::BakeRootBoneToCurveAdaptive(Scoped.Sequence, Settings, int32(ERMEBoneExtractChannelType::All));
+		const TArray<FRichCurveKey>& FixedKeys = Fixed.TranslationCurve.FloatCurves[0].GetConstRefOfKeys();
+		const TArray<FRichCurveKey>& AdaptiveKeys = Adaptive.TranslationCurve.FloatCurves[0].GetConstRefOfKeys();
+		if (!TestEqual(FString::Printf(TEXT("Keys of the adaptive bake at %d fps"), SampleRate), AdaptiveKeys.Num(), FixedKeys.Num()))
+		{
+			continue;
+		}
+
+		for (int32 Key = 0; Key < FixedKeys.Num(); ++Key)
+		{
+			const float Time = FixedKeys[Key].Time;
+			TestEqual(FString::Printf(TEXT("Time of key %d at %d fps"), Key, SampleRate), AdaptiveKeys[Key].Time, Time, UE_KINDA_SMALL_NUMBER);
+			TestTrue(FString::Printf(TEXT("Transform of key %d at %d fps"), Key, SampleRate), Adaptive.Evaluate(Time, 1.f).Equals(Fixed.Evaluate(Time, 1.f), Tolerance));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMEBakeAnimPoseBoneTest, "RootMotionEditor.Bake.AnimPoseBone",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMEBakeAnimPoseBoneTest::RunTest(const FString& Parameters)
+{
+	using namespace RMEBakeTests;
+	const FScopedSequence Scoped;
+	const float PlayLength = Scoped.Sequence->GetPlayLength();
+
+	// At another rate than the animation, the poses are evaluated. The samples cover the animation and the last one
+	// lands on its end, a bake that never reaches the end doesn't return.
+	constexpr int32 SampleRate = 24;
+	const FTransformCurve Curve = RootMotionEditorStatics::BakeAnimPoseBoneToCurve(Scoped.Sequence, ChildBoneName, SampleRate, int32(ERMEBoneExtractChannelType::All));
+	const FRichCurve& Channel = Curve.TranslationCurve.FloatCurves[0];
+	if (!TestEqual(TEXT("Keys of the pose bake"), Channel.GetNumKeys(), FRMEFrameSampler(FFrameRate(SampleRate, 1), PlayLength).Num()))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Time of the last key"), Channel.GetLastKey().Time, PlayLength, Tolerance);
+
+	// The bone sits 10 cm above the root and only rolls, so it follows the root location.
+	for (const FRichCurveKey& Key : Channel.GetConstRefOfKeys())
+	{
+		const FTransform Baked = Curve.Evaluate(Key.Time, 1.f);
+		const FVector Expected = GetRootLocation(Key.Time) + FVector(0.0, 0.0, 10.0);
+		TestTrue(FString::Printf(TEXT("Bone location at %.3f s"), Key.Time), Baked.GetLocation().Equals(Expected, PoseTolerance));
+	}
+
+	// The same bone at the rate of the animation reads the bone tracks and must give the same locations.
+	const FTransformCurve TrackCurve = RootMotionEditorStatics::BakeAnimPoseBoneToCurve(Scoped.Sequence, ChildBoneName, FrameRate, int32(ERMEBoneExtractChannelType::All));
+	TestEqual(TEXT("Keys of the bone track bake"), TrackCurve.TranslationCurve.FloatCurves[0].GetNumKeys(), NumFrames + 1);
+	for (int32 Frame = 0; Frame <= NumFrames; ++Frame)
+	{
+		const float Time = static_cast<float>(Frame) / FrameRate;
+		const FVector Expected = GetRootLocation(Time) + FVector(0.0, 0.0, 10.0);
+		TestTrue(FString::Printf(TEXT("Bone track location at frame %d"), Frame), TrackCurve.Evaluate(Time, 1.f).GetLocation().Equals(Expected, Tolerance));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMEWriteBackTest, "RootMotionEditor.WriteBack.RootBone",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMEWriteBackTest::RunTest(const FString& Parameters)
+{
+	using namespace RMEBakeTests;
+	const FScopedSequence Scoped;
+
+	// Twice the distance and a constant heading, keyed on every other frame so the write back has to evaluate between keys.
+	FTransformCurve NewRootMotion;
+	for (int32 Frame = 0; Frame <= NumFrames; Frame += 2)
+	{
+		const float Time = static_cast<float>(Frame) / FrameRate;
+		NewRootMotion.UpdateOrAddKey(FTransform(FRotator(0.f, 45.f, 0.f), GetRootLocation(Time) * 2.0), Time);
+	}
+
+	if (!TestTrue(TEXT("Write back"), RootMotionEditorStatics::OverrideAnimBoneMotion(Scoped.Sequence, NewRootMotion)))
+	{
+		return false;
+	}
+
+	const IAnimationDataModel* Model = Scoped.Sequence->GetDataModel();
+	TArray<FTransform> RootKeys;
+	Model->GetBoneTrackTransforms(TEXT("root"), RootKeys);
+	if (!TestEqual(TEXT("Keys of the root track"), RootKeys.Num(), NumFrames + 1))
+	{
+		return false;
+	}
+
+	for (int32 Frame = 0; Frame <= NumFrames; ++Frame)
+	{
+		const float Time = static_cast<float>(Frame) / FrameRate;
+		const FTransform Expected = NewRootMotion.Evaluate(Time, 1.f);
+		TestTrue(FString::Printf(TEXT("Root location at frame %d"), Frame), RootKeys[Frame].GetLocation().Equals(Expected.GetLocation(), Tolerance));
+		TestTrue(FString::Printf(TEXT("Root rotation at frame %d"), Frame), RootKeys[Frame].GetRotation().Equals(Expected.GetRotation(), Tolerance));
+	}
+
+	// The other bones keep their keys.
+	TArray<FTransform> BoneKeys;
+	Model->GetBoneTrackTransforms(ChildBoneName, BoneKeys);
+	TestEqual(TEXT("Keys of the child track"), BoneKeys.Num(), NumFrames + 1);
+	for (int32 Frame = 0; Frame < BoneKeys.Num(); ++Frame)
+	{
+		TestTrue(FString::Printf(TEXT("Child location at frame %d"), Frame), BoneKeys[Frame].GetLocation().Equals(FVector(0.0, 0.0, 10.0), Tolerance));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMEBatchRoundTripTest, "RootMotionEditor.Batch.RoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMEBatchRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace RMEBakeTests;
+	const FScopedSequence Scoped;
+
+	const IAnimationDataModel* Model = Scoped.Sequence->GetDataModel();
+	TArray<FTransform> RootKeysBefore;
+	Model->GetBoneTrackTransforms(TEXT("root"), RootKeysBefore);
+
+	// Baked at the rate of the animation and written back without any operation, the root track must not change.
+	URMEBatchSettings* Settings = NewObject<URMEBatchSettings>();
+	Settings->Animations.Add(Scoped.Sequence);
+	Settings->SampleRate = FrameRate;
+	Settings->bWriteBack = true;
+	const TArray<FRMEBatchAssetReport> Reports = FRMEBatchProcessor::Run(*Settings);
+	if (!TestEqual(TEXT("Reports"), Reports.Num(), 1) || !TestTrue(TEXT("Batch succeeded"), Reports[0].Result == ERMEBatchResult::Succeeded))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Baked keys"), Reports[0].NumKeys, NumFrames + 1);
+
+	TArray<FTransform> RootKeysAfter;
+	Model->GetBoneTrackTransforms(TEXT("root"), RootKeysAfter);
+	if (!TestEqual(TEXT("Keys of the root track"), RootKeysAfter.Num(), RootKeysBefore.Num()))
+	{
+		return false;
+	}
+
+	for (int32 Frame = 0; Frame < RootKeysBefore.Num(); ++Frame)
+	{
+		TestTrue(FString::Printf(TEXT("Root location at frame %d"), Frame), RootKeysAfter[Frame].GetLocation().Equals(RootKeysBefore[Frame].GetLocation(), Tolerance));
+		TestTrue(FString::Printf(TEXT("Root rotation at frame %d"), Frame), RootKeysAfter[Frame].GetRotation().Equals(RootKeysBefore[Frame].GetRotation(), Tolerance));
+	}
+	return true;
+}
+
+#endif
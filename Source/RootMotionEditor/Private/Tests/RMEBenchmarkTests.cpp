@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "RMEBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** One test per benchmark stage, each appends its rows to the benchmark CSV with the default settings. */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FRMEBenchmarkTest, "RootMotionEditor.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FRMEBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const FString& Stage : FRMEBenchmark::GetStageNames())
+	{
+		OutBeautifiedNames.Add(Stage);
+		OutTestCommands.Add(FString::Printf(TEXT("Stages=%s"), *Stage));
+	}
+}
+
+bool FRMEBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FRMEBenchmarkSettings Settings = FRMEBenchmarkSettings::Parse(*Parameters);
+	return TestTrue(FString::Printf(TEXT("Results written to %s"), *Settings.OutputFile), FRMEBenchmark::Run(Settings));
+}
+
+#endif
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "RMECurvePool.h"
+#include "RMETypes.h"
+#include "Animation/AnimCurveTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMECurvePoolKeyHandlesTest, "RootMotionEditor.CurvePool.KeyHandles",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRMECurvePoolKeyHandlesTest::RunTest(const FString& Parameters)
+{
+	FRichCurve Source;
+	Source.AddKey(0.f, 1.f);
+	Source.AddKey(1.f, 2.f);
+
+	FRichCurve Dest;
+	for (int32 Key = 0; Key < 4; ++Key)
+	{
+		Dest.AddKey(static_cast<float>(Key), 0.f);
+	}
+	const int32 Capacity = Dest.Keys.Max();
+
+	// A handle taken before the copy must not resolve to the copied key that landed in its slot.
+	const FKeyHandle CopiedOver = Dest.GetKeyHandle(0);
+	FRMECurvePool::CopyKeys(Source, Dest);
+	TestFalse(TEXT("Handle of a key copied over"), Dest.IsKeyHandleValid(CopiedOver));
+	TestEqual(TEXT("Keys after the copy"), Dest.GetNumKeys(), 2);
+	TestEqual(TEXT("Value of the copied key"), Dest.Eval(1.f), 2.f);
+	TestEqual(TEXT("Allocation kept by the copy"), Dest.Keys.Max(), Capacity);
+
+	// The handles of the copied keys are new ones.
+	const FKeyHandle CopiedKey = Dest.GetKeyHandle(1);
+	TestTrue(TEXT("Handle of a copied key"), Dest.IsKeyHandleValid(CopiedKey));
+	TestEqual(TEXT("Key of the new handle"), Dest.GetKey(CopiedKey).Value, 2.f);
+
+	// Same for the keys of a released curve.
+	FTransformCurve Curve;
+	Curve.TranslationCurve.FloatCurves[0] = Source;
+	const FKeyHandle Released = Curve.TranslationCurve.FloatCurves[0].GetKeyHandle(0);
+	FRMECurvePool::ResetKeys(Curve);
+	Curve.TranslationCurve.FloatCurves[0].AddKey(0.f, 3.f);
+	TestFalse(TEXT("Handle of a reset key"), Curve.TranslationCurve.FloatCurves[0].IsKeyHandleValid(Released));
+	return true;
+}
+
+#endif
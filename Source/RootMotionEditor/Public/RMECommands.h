@@ -24,4 +24,17 @@ public:
 	TSharedPtr< FUICommandInfo > DoNotVisualizeRootMotion;
 	TSharedPtr< FUICommandInfo > VisualizeRootMotionTrajectory;
 	TSharedPtr< FUICommandInfo > VisualizeRootMotionTrajectoryAndOrientation;
+
+	TSharedPtr< FUICommandInfo > CompareTrajectories;
+
+	/** Trajectory heatmap */
+	TSharedPtr< FUICommandInfo > ColorTrajectoryNone;
+	TSharedPtr< FUICommandInfo > ColorTrajectoryBySpeed;
+	TSharedPtr< FUICommandInfo > ColorTrajectoryByAcceleration;
+
+	/** Onion skin */
+	TSharedPtr< FUICommandInfo > ShowGhostPoses;
+
+	/** Performance */
+	TSharedPtr< FUICommandInfo > ShowPerformanceHUD;
 };
\ No newline at end of file
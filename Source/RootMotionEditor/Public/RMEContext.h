@@ -4,13 +4,35 @@
 
 class URMECurveContainer;
 
+/** Memory held by one editor session, the data shared with the other sessions isn't included. */
+struct FRMESessionMemory
+{
+	int32 NumCurveKeys = 0;
+	SIZE_T CurveBytes = 0;
+	SIZE_T HistoryBytes = 0;
+	/** Ghost poses, editor trajectory and deviation. */
+	SIZE_T ViewModelBytes = 0;
+
+	SIZE_T GetTotal() const { return CurveBytes + HistoryBytes + ViewModelBytes; }
+};
+
 class FRMEContext : public TSharedFromThis<FRMEContext>, public FGCObject
 {
 	
 public:
-	static FRMEContext* Get() { return Instance; }
 	static void Initialize();
 	static void Shutdown();
+
+	/** Every editor tab is its own session, with its own preview scene, view model and curve data. */
+	static TSharedRef<FRMEContext> CreateSession();
+	static void DestroySession(FRMEContext* Session);
+	static const TArray<TSharedRef<FRMEContext>>& GetSessions() { return Sessions; }
+
+	int32 GetSessionIndex() const { return SessionIndex; }
+
+	FRMESessionMemory GetMemoryUsage() const;
+	/** Every session, the curve pool, the shared derived data and the loaded libraries. RootMotionEditor.DumpMemory console command. */
+	static void DumpMemory(FOutputDevice& Ar);
 	
 	void Setup();
 
@@ -30,9 +52,12 @@ public:
 	float GetViewModelPlayTime() const;
 	TRange<double> GetViewModelPlayTimeRange() const;
 	void SetViewModelPlayTime(float InPlayTime, bool bInTickPlayTime);
+	void RequestViewModelPlayTime(float InPlayTime);
 
 	void SetAnimationAsset(UAnimSequence* InAnimationSequence);
 	UAnimSequence* GetAnimationAsset() const;
+	/** Must be called before writing into the animation, background caches of every session may still be reading it. */
+	static void NotifyAnimationModified(UAnimSequence* InAnimationSequence);
 
 	void SetRootMotionViewMode(ERMERootMotionViewMode InViewMode);
 	ERMERootMotionViewMode GetRootMotionViewMode() const;
@@ -71,6 +96,9 @@ protected:
 	
 	TObjectPtr<UAnimSequence> CurrentAnimation;
 
+	int32 SessionIndex = 0;
+
 private:
-	static FRMEContext* Instance;
+	static TArray<TSharedRef<FRMEContext>> Sessions;
+	static int32 NextSessionIndex;
 };
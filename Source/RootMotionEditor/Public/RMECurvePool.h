@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/RichCurve.h"
+
+struct FTransformCurve;
+struct FVectorCurve;
+
+/** Ownership handle of a pooled transform curve, it resolves to nothing once the curve has been released. */
+struct FRMECurveHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+	void Reset() { Index = INDEX_NONE; Serial = 0; }
+};
+
+/**
+ * Owns the edited transform curves of every session.
+ * A released curve goes back to the pool with its keys removed but its key arrays still allocated, so the next
+ * load or bake fills the same memory instead of allocating new arrays. Curves never move while they're in use,
+ * the curve editor models keep pointers to their channels.
+ * Game thread only.
+ */
+class FRMECurvePool
+{
+public:
+	static FRMECurvePool& Get();
+
+	FRMECurveHandle Allocate();
+
+	/** Give the curve back to the pool and reset the handle, every copy of the handle is stale after this. */
+	void Release(FRMECurveHandle& InOutHandle);
+
+	/** Null if the handle isn't set or its curve has been released. */
+	FTransformCurve* Resolve(const FRMECurveHandle& InHandle) const;
+
+	/** Remove every key of the channels but keep their allocation, the key handles given out before aren't valid anymore. */
+	static void ResetKeys(FTransformCurve& InOutCurve);
+
+	/**
+	 * Copy the keys of the channels into the existing key arrays, they only grow if the source has more keys.
+	 * The key handles of the destination aren't valid anymore, the source keys get new ones when they're asked for.
+	 */
+	static void CopyKeys(const FTransformCurve& InSource, FTransformCurve& OutDest);
+	static void CopyKeys(const FVectorCurve& InSource, FVectorCurve& OutDest);
+	static void CopyKeys(const FRichCurve& InSource, FRichCurve& OutDest);
+
+	int32 GetNumAllocated() const { return Slots.Num() - FreeSlots.Num(); }
+	int32 GetNumFree() const { return FreeSlots.Num(); }
+
+	/** Size of the curves in use and of the key arrays kept by the free ones. */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Size of the curve and of the key arrays of its channels. */
+	static SIZE_T GetAllocatedSize(const FTransformCurve& InCurve);
+	/** Keys of the nine channels. */
+	static int32 GetNumKeys(const FTransformCurve& InCurve);
+
+private:
+	struct FSlot
+	{
+		TUniquePtr<FTransformCurve> Curve;
+		/** Bumped on release, the handles given out before don't match anymore. */
+		uint32 Serial = 1;
+		bool bInUse = false;
+	};
+
+	TArray<FSlot> Slots;
+	TArray<int32> FreeSlots;
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/FrameRate.h"
+
+class UAnimSequence;
+
+/**
+ * Sample times at a fixed frame rate, computed from the frame number instead of accumulated, so every run samples
+ * exactly the same times and the last sample is always the end of the range. Two equal samplers give the same
+ * samples, derived data can be keyed by the sampler and a frame.
+ */
+struct FRMEFrameSampler
+{
+	FRMEFrameSampler() = default;
+
+	/** The frames of the range, plus the end of the range if it isn't on a frame. */
+	FRMEFrameSampler(const FFrameRate& InFrameRate, double InLength);
+
+	/** The sampled keys of the animation, the frames the preview and the trajectories are drawn on. */
+	static FRMEFrameSampler ForAnimation(const UAnimSequence* InAnimation);
+
+	/** The raw keys of the animation data model, the frames root motion is written back on. */
+	static FRMEFrameSampler ForDataModel(const UAnimSequence* InAnimation);
+
+	int32 Num() const { return NumFrames; }
+	const FFrameRate& GetFrameRate() const { return FrameRate; }
+	double GetLength() const { return Length; }
+
+	double GetTime(int32 Frame) const
+	{
+		return Frame >= NumFrames - 1 ? Length : FMath::Min(FrameRate.AsSeconds(FFrameNumber(Frame)), Length);
+	}
+
+	/** Time from the sample to the next one, shorter for the last interval if the range doesn't end on a frame. */
+	double GetInterval(int32 Frame) const { return GetTime(Frame + 1) - GetTime(Frame); }
+
+	bool operator==(const FRMEFrameSampler& Other) const
+	{
+		return FrameRate == Other.FrameRate && NumFrames == Other.NumFrames && Length == Other.Length;
+	}
+	bool operator!=(const FRMEFrameSampler& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FRMEFrameSampler& Sampler)
+	{
+		uint32 Hash = HashCombine(::GetTypeHash(Sampler.FrameRate.Numerator), ::GetTypeHash(Sampler.FrameRate.Denominator));
+		Hash = HashCombine(Hash, ::GetTypeHash(Sampler.NumFrames));
+		return HashCombine(Hash, ::GetTypeHash(Sampler.Length));
+	}
+
+private:
+	FFrameRate FrameRate;
+	int32 NumFrames = 0;
+	double Length = 0.0;
+};
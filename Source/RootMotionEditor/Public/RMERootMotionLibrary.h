@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimCurveTypes.h"
+#include "Serialization/BulkData.h"
+#include "RMERootMotionLibrary.generated.h"
+
+/** Index entry of one curve of the library, its keys are a contiguous range of the packed payload. */
+USTRUCT()
+struct FRMERootMotionLibraryEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Entry")
+	FName Name = NAME_None;
+
+	UPROPERTY(VisibleAnywhere, Category = "Entry")
+	int32 NumKeys = 0;
+	UPROPERTY(VisibleAnywhere, Category = "Entry")
+	float StartTime = 0.f;
+	UPROPERTY(VisibleAnywhere, Category = "Entry")
+	float EndTime = 0.f;
+
+	/** Byte range of the entry in the payload. */
+	UPROPERTY()
+	int64 Offset = 0;
+	UPROPERTY()
+	int64 Size = 0;
+};
+
+/**
+ * Many named transform curves in one asset, instead of three curve vector assets per clip.
+ * The index is loaded with the asset, the keys of every entry are packed one after the other in a bulk data payload
+ * that stays on disk until an entry is read. Reading an entry only fetches and decodes its own byte range.
+ */
+UCLASS(BlueprintType)
+class URMERootMotionLibrary : public UObject
+{
+	GENERATED_BODY()
+public:
+	virtual void Serialize(FArchive& Ar) override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	int32 Num() const { return Entries.Num(); }
+	const TArray<FRMERootMotionLibraryEntry>& GetEntries() const { return Entries; }
+	const FRMERootMotionLibraryEntry* FindEntry(FName InName) const;
+	bool Contains(FName InName) const { return FindEntry(InName) != nullptr; }
+
+	/** Decode the keys of the entry, false if there is no such entry or its data can't be read. */
+	bool ReadEntry(FName InName, FTransformCurve& OutCurve) const;
+
+	/** Add the entry or replace its keys, the payload is repacked. */
+	void WriteEntry(FName InName, const FTransformCurve& InCurve);
+	bool RemoveEntry(FName InName);
+
+	static void EncodeCurve(const FTransformCurve& InCurve, TArray<uint8>& OutBytes);
+	static bool DecodeCurve(TConstArrayView<uint8> InBytes, FTransformCurve& OutCurve);
+
+private:
+	/** Read a byte range of the payload, from memory if it's loaded, else straight from the package file. */
+	bool ReadPayload(int64 InOffset, int64 InSize, TArray<uint8>& OutBytes) const;
+	void RebuildIndexMap();
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Library")
+	TArray<FRMERootMotionLibraryEntry> Entries;
+
+	FByteBulkData Payload;
+
+	/** Entry index by name, rebuilt when the asset is loaded and on every change. */
+	TMap<FName, int32> IndexMap;
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "AnimPose.h"
 #include "DynamicMeshBuilder.h"
+#include "RMEFrameSampler.h"
 #include "RMETypes.h"
 
 
@@ -69,11 +70,135 @@ namespace RootMotionEditorStatics
 			InOutTransform.SetScale3D(FVector::OneVector);
 		}
 	}
-	
+
+	/**
+	 * True if the raw bone tracks are keyed at SampleRate, so a bake can read them directly instead of evaluating poses.
+	 * Additive sequences and locked roots are left to the pose evaluation.
+	 */
+	static bool CanBakeFromBoneTracks(const UAnimSequence* AnimSequence, int32 SampleRate)
+	{
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		return Model != nullptr && AnimSequence->GetSkeleton() != nullptr && Model->GetNumberOfKeys() > 1
+			&& FMath::IsNearlyEqual(Model->GetFrameRate().AsDecimal(), static_cast<double>(SampleRate))
+			&& !AnimSequence->IsValidAdditive() && !AnimSequence->bForceRootLock;
+	}
+
+	/** Raw keys of one bone, its reference pose for every key if the bone has no track. */
+	static void GetBoneTrackKeys(const IAnimationDataModel* Model, const FReferenceSkeleton& RefSkeleton, int32 BoneIndex, TArray<FTransform>& OutKeys)
+	{
+		const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+		const int32 NumKeys = Model->GetNumberOfKeys();
+		if (Model->IsValidBoneTrackName(BoneName))
+		{
+			Model->GetBoneTrackTransforms(BoneName, OutKeys);
+		}
+		if (OutKeys.Num() != NumKeys)
+		{
+			OutKeys.Init(RefSkeleton.GetRefBonePose()[BoneIndex], NumKeys);
+		}
+	}
+
+	/** First raw key of the root bone, where the root motion of the bakes starts from. */
+	static FTransform GetFirstRootKey(const UAnimSequence* AnimSequence)
+	{
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+		if (Model == nullptr || Skeleton == nullptr || Model->GetNumberOfKeys() == 0 || Skeleton->GetReferenceSkeleton().GetNum() == 0)
+		{
+			return FTransform::Identity;
+		}
+
+		TArray<FTransform> RootKeys;
+		GetBoneTrackKeys(Model, Skeleton->GetReferenceSkeleton(), 0, RootKeys);
+		return RootKeys[0];
+	}
+
+	/**
+	 * The fast path of BakeAnimPoseBoneToCurve: the keys of the bone and its parents are read from the data model and
+	 * accumulated to component space, no pose is evaluated. False if the evaluation options change the pose, in which
+	 * case the bake has to evaluate it.
+	 */
+	static bool BakeBoneTracksToCurve(const UAnimSequence* AnimSequence, FName BoneName, int32 ExtractChannel, bool bIsAdditiveCurve,
+		const FAnimPoseEvaluationOptions& EvaluationOptions, EAnimPoseSpaces Space, FTransformCurve& OutCurve)
+	{
+		if (EvaluationOptions.EvaluationType != EAnimDataEvalType::Raw || EvaluationOptions.bExtractRootMotion || EvaluationOptions.OptionalSkeletalMesh != nullptr)
+		{
+			return false;
+		}
+
+		const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+		if (BoneIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Parents first, retargeted translations only match the raw keys in animation mode.
+		TArray<int32, TInlineAllocator<32>> Chain;
+		for (int32 ChainBone = BoneIndex; ChainBone != INDEX_NONE; ChainBone = Space == EAnimPoseSpaces::Local ? INDEX_NONE : RefSkeleton.GetParentIndex(ChainBone))
+		{
+			if (EvaluationOptions.bShouldRetarget && Skeleton->GetBoneTranslationRetargetingMode(ChainBone) != EBoneTranslationRetargetingMode::Animation)
+			{
+				return false;
+			}
+			Chain.Insert(ChainBone, 0);
+		}
+
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		TArray<FTransform> BoneTransforms;
+		GetBoneTrackKeys(Model, RefSkeleton, Chain[0], BoneTransforms);
+
+		TArray<FTransform> LocalKeys;
+		for (int32 ChainIndex = 1; ChainIndex < Chain.Num(); ++ChainIndex)
+		{
+			GetBoneTrackKeys(Model, RefSkeleton, Chain[ChainIndex], LocalKeys);
+			for (int32 Key = 0; Key < BoneTransforms.Num(); ++Key)
+			{
+				BoneTransforms[Key] = LocalKeys[Key] * BoneTransforms[Key];
+			}
+		}
+
+		const FRMEFrameSampler Sampler = FRMEFrameSampler::ForDataModel(AnimSequence);
+		check(Sampler.Num() == BoneTransforms.Num());
+		FTransform LastBoneTransform = FTransform::Identity;
+		for (int32 Key = 0; Key < BoneTransforms.Num(); ++Key)
+		{
+			FTransform TargetBoneTransform = bIsAdditiveCurve ? BoneTransforms[Key].GetRelativeTransform(LastBoneTransform) : BoneTransforms[Key];
+			ExtractDataFilter(TargetBoneTransform, ExtractChannel);
+			OutCurve.UpdateOrAddKey(TargetBoneTransform, static_cast<float>(Sampler.GetTime(Key)));
+			LastBoneTransform = BoneTransforms[Key];
+		}
+		INC_DWORD_STAT_BY(STAT_RME_BakedSamples, BoneTransforms.Num());
+		return true;
+	}
+
+	/** The fast path of BakeRootBoneToCurve, the raw keys of the root bone instead of extracted root motion. */
+	static void BakeRootTrackToCurve(const UAnimSequence* AnimSequence, int32 ExtractChannel, bool bIsAdditiveCurve, FTransformCurve& OutCurve)
+	{
+		const IAnimationDataModel* Model = AnimSequence->GetDataModel();
+		TArray<FTransform> RootKeys;
+		GetBoneTrackKeys(Model, AnimSequence->GetSkeleton()->GetReferenceSkeleton(), 0, RootKeys);
+
+		// The key at a frame is the root at that frame, the first key plus the root motion up to the frame.
+		const FRMEFrameSampler Sampler = FRMEFrameSampler::ForDataModel(AnimSequence);
+		check(Sampler.Num() == RootKeys.Num());
+		for (int32 Key = 0; Key < RootKeys.Num(); ++Key)
+		{
+			FTransform WriteTransform = bIsAdditiveCurve && Key > 0 ? RootKeys[Key].GetRelativeTransform(RootKeys[Key - 1]) : RootKeys[Key];
+			ExtractDataFilter(WriteTransform, ExtractChannel);
+			OutCurve.UpdateOrAddKey(WriteTransform, static_cast<float>(Sampler.GetTime(Key)));
+		}
+		INC_DWORD_STAT_BY(STAT_RME_BakedSamples, RootKeys.Num());
+	}
 
 	static FTransformCurve BakeAnimPoseBoneToCurve(UAnimSequence* AnimSequence, FName CustomExtractBone, int32 SampleRate = 30, int32 ExtractChannel = 0, bool bIsAdditiveCurve = false, 
 		const FAnimPoseEvaluationOptions& EvaluationOptions = FAnimPoseEvaluationOptions(), EAnimPoseSpaces Space = EAnimPoseSpaces::World)
 	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RootMotionEditorStatics::BakeAnimPoseBoneToCurve);
+		SCOPE_CYCLE_COUNTER(STAT_RME_BakeAnimPoseBoneToCurve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
 		if (!AnimSequence)
 		{
 			UE_LOG(LogAnimation, Warning, TEXT("Invalid AnimSequence"));
@@ -86,16 +211,18 @@ namespace RootMotionEditorStatics
 			return FTransformCurve();
 		}
 
-		const float SampleInterval = 1.f / static_cast<float>(SampleRate);
-		const float AnimLength = AnimSequence->GetPlayLength();
-		
 		FTransformCurve Result;
+		if (CanBakeFromBoneTracks(AnimSequence, SampleRate) && BakeBoneTracksToCurve(AnimSequence, CustomExtractBone, ExtractChannel, bIsAdditiveCurve, EvaluationOptions, Space, Result))
+		{
+			return Result;
+		}
 
 		// use GetPose to get bone transform delta.
-		float Time = 0.0f;
+		const FRMEFrameSampler Sampler(FFrameRate(SampleRate, 1), AnimSequence->GetPlayLength());
 		FTransform LastBoneTransform = FTransform::Identity;
-		while (Time <= AnimLength)
+		for (int32 Frame = 0; Frame < Sampler.Num(); ++Frame)
 		{
+			const float Time = static_cast<float>(Sampler.GetTime(Frame));
 			FAnimPose AnimPose;
 			UAnimPoseExtensions::GetAnimPoseAtTime(AnimSequence, Time, EvaluationOptions, AnimPose);
 			const FTransform& CurrentBoneTransform = UAnimPoseExtensions::GetBonePose(AnimPose, CustomExtractBone, Space);
@@ -103,9 +230,8 @@ namespace RootMotionEditorStatics
 			FTransform TargetBoneTransform = bIsAdditiveCurve ? CurrentBoneTransform.GetRelativeTransform(LastBoneTransform) : CurrentBoneTransform;
 			ExtractDataFilter(TargetBoneTransform, ExtractChannel);
 			Result.UpdateOrAddKey(TargetBoneTransform, Time);
+			INC_DWORD_STAT(STAT_RME_BakedSamples);
 			LastBoneTransform = CurrentBoneTransform;
-
-			Time = FMath::Clamp(Time + SampleInterval, 0.f, AnimLength);
 		}
 		
 		return Result;
@@ -113,6 +239,10 @@ namespace RootMotionEditorStatics
 
 	static FTransformCurve BakeRootBoneToCurve(UAnimSequence* AnimSequence, int32 SampleRate = 30, int32 ExtractChannel = 0, bool bIsAdditiveCurve = false)
 	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RootMotionEditorStatics::BakeRootBoneToCurve);
+		SCOPE_CYCLE_COUNTER(STAT_RME_BakeRootBoneToCurve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
 		if (!AnimSequence)
 		{
 			UE_LOG(LogAnimation, Warning, TEXT("Invalid AnimSequence"));
@@ -125,63 +255,248 @@ namespace RootMotionEditorStatics
 			return FTransformCurve();
 		}
 
-		const float SampleInterval = 1.f / static_cast<float>(SampleRate);
-		const float AnimLength = AnimSequence->GetPlayLength();
-
-
 		FTransformCurve Result;
-		
-		float Time = 0.0f;
+		if (CanBakeFromBoneTracks(AnimSequence, SampleRate))
+		{
+			BakeRootTrackToCurve(AnimSequence, ExtractChannel, bIsAdditiveCurve, Result);
+			return Result;
+		}
+
+		// Every sample holds the root at its time like the raw keys do: the first key plus the root motion up to the sample.
+		const FRMEFrameSampler Sampler(FFrameRate(SampleRate, 1), AnimSequence->GetPlayLength());
+		const FTransform FirstRootKey = GetFirstRootKey(AnimSequence);
 		FTransform LastRootMotion = FTransform::Identity;
-		while (Time < AnimLength)
+		for (int32 Frame = 0; Frame < Sampler.Num(); ++Frame)
 		{
-			// direct to extract root motion.
+			const float Time = static_cast<float>(Sampler.GetTime(Frame));
+			FTransform RootMotionDelta = FTransform::Identity;
+			if (Frame > 0)
+			{
+				const float PreviousTime = static_cast<float>(Sampler.GetTime(Frame - 1));
+				const float SampleInterval = static_cast<float>(Sampler.GetInterval(Frame - 1));
+
+				// direct to extract root motion.
 #if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 6
-			FAnimExtractContext ExtractContext(Time, true, FDeltaTimeRecord(SampleInterval), false);
-			const FTransform& RootMotionDelta = AnimSequence->ExtractRootMotion(ExtractContext);
+				FAnimExtractContext ExtractContext(PreviousTime, true, FDeltaTimeRecord(SampleInterval), false);
+				RootMotionDelta = AnimSequence->ExtractRootMotion(ExtractContext);
 #else
-			const FTransform& RootMotionDelta = AnimSequence->ExtractRootMotion(Time, SampleInterval, false);
+				RootMotionDelta = AnimSequence->ExtractRootMotion(PreviousTime, SampleInterval, false);
 #endif
+			}
 
-			LastRootMotion = bIsAdditiveCurve ? RootMotionDelta : RootMotionDelta * LastRootMotion;
-			FTransform WriteTransform = LastRootMotion;
+			LastRootMotion = RootMotionDelta * LastRootMotion;
+			FTransform WriteTransform = bIsAdditiveCurve ? (Frame > 0 ? RootMotionDelta : FirstRootKey) : LastRootMotion * FirstRootKey;
 			ExtractDataFilter(WriteTransform, ExtractChannel);
 			Result.UpdateOrAddKey(WriteTransform, Time);
-			
-			Time = FMath::Clamp(Time + SampleInterval, 0.f, AnimLength);
+			INC_DWORD_STAT(STAT_RME_BakedSamples);
 		}
-		
+
 
 		return Result;
 	}
 
-	static void OverrideAnimBoneMotion(UAnimSequence* Animation, const FTransformCurve& NewRootMotion, FName BoneName = NAME_None)
+	/** True if Middle is within the tolerances of the halfway point the linear keys Start and End give back. */
+	static bool IsWithinAdaptiveTolerance(const FTransform& Start, const FTransform& End, const FTransform& Middle, const FRMEAdaptiveSampling& Settings, int32 ExtractChannel)
 	{
+		if (EnumHasAnyFlags(ExtractChannel, ERMEBoneExtractChannelType::Translation))
+		{
+			const FVector Predicted = FMath::Lerp(Start.GetTranslation(), End.GetTranslation(), 0.5f);
+			if (FVector::Dist(Predicted, Middle.GetTranslation()) > Settings.TranslationTolerance)
+			{
+				return false;
+			}
+		}
+		if (EnumHasAnyFlags(ExtractChannel, ERMEBoneExtractChannelType::Rotation))
+		{
+			// The rotation curve keys euler angles, the prediction blends them the same way.
+			const FVector PredictedEuler = FMath::Lerp(Start.Rotator().Euler(), End.Rotator().Euler(), 0.5f);
+			const FQuat Predicted = FRotator::MakeFromEuler(PredictedEuler).Quaternion();
+			if (FMath::RadiansToDegrees(Predicted.AngularDistance(Middle.GetRotation())) > Settings.RotationTolerance)
+			{
+				return false;
+			}
+		}
+		if (EnumHasAnyFlags(ExtractChannel, ERMEBoneExtractChannelType::Scale))
+		{
+			const FVector Predicted = FMath::Lerp(Start.GetScale3D(), End.GetScale3D(), 0.5f);
+			if ((Predicted - Middle.GetScale3D()).GetAbsMax() > Settings.ScaleTolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Samples a grid at MinSampleRate, then splits every interval whose middle sample is out of the tolerances of its
+	 * linear keys, until the intervals reach MaxSampleRate. SampleAtTime is called once per tested time, the kept
+	 * samples are returned in time order.
+	 */
+	static void SampleAdaptive(float AnimLength, const FRMEAdaptiveSampling& Settings, int32 ExtractChannel,
+		TFunctionRef<FTransform(float)> SampleAtTime, TArray<TPair<float, FTransform>>& OutSamples, int32& OutNumEvaluations)
+	{
+		struct FInterval
+		{
+			float StartTime;
+			float EndTime;
+			FTransform Start;
+			FTransform End;
+		};
+
+		const int32 MinSampleRate = FMath::Max(1, FMath::Min(Settings.MinSampleRate, Settings.MaxSampleRate));
+		const float MinInterval = 1.f / static_cast<float>(FMath::Max(1, Settings.MaxSampleRate));
+		const FRMEFrameSampler GridSampler(FFrameRate(MinSampleRate, 1), AnimLength);
+
+		OutSamples.Reset();
+		OutSamples.Emplace(0.f, SampleAtTime(0.f));
+		OutNumEvaluations = 1;
+
+		TArray<FInterval, TInlineAllocator<16>> Pending;
+		for (int32 GridIndex = 1; GridIndex < GridSampler.Num(); ++GridIndex)
+		{
+			const float GridTime = static_cast<float>(GridSampler.GetTime(GridIndex));
+			Pending.Push({ OutSamples.Last().Key, GridTime, OutSamples.Last().Value, SampleAtTime(GridTime) });
+			++OutNumEvaluations;
+
+			// Depth first, the left half is popped first so the samples come out in order.
+			while (Pending.Num() > 0)
+			{
+				const FInterval Interval = Pending.Pop();
+				const float MiddleTime = (Interval.StartTime + Interval.EndTime) * 0.5f;
+				if (MiddleTime - Interval.StartTime >= MinInterval * (1.f - KINDA_SMALL_NUMBER))
+				{
+					const FTransform Middle = SampleAtTime(MiddleTime);
+					++OutNumEvaluations;
+					if (!IsWithinAdaptiveTolerance(Interval.Start, Interval.End, Middle, Settings, ExtractChannel))
+					{
+						Pending.Push({ MiddleTime, Interval.EndTime, Middle, Interval.End });
+						Pending.Push({ Interval.StartTime, MiddleTime, Interval.Start, Middle });
+						continue;
+					}
+				}
+				OutSamples.Emplace(Interval.EndTime, Interval.End);
+			}
+		}
+	}
+
+	/** Keys the samples, as deltas from the previous sample if bIsAdditiveCurve. */
+	static FTransformCurve MakeCurveFromSamples(TConstArrayView<TPair<float, FTransform>> Samples, int32 ExtractChannel, bool bIsAdditiveCurve)
+	{
+		FTransformCurve Result;
+		FTransform LastTransform = FTransform::Identity;
+		for (const TPair<float, FTransform>& Sample : Samples)
+		{
+			FTransform WriteTransform = bIsAdditiveCurve ? Sample.Value.GetRelativeTransform(LastTransform) : Sample.Value;
+			ExtractDataFilter(WriteTransform, ExtractChannel);
+			Result.UpdateOrAddKey(WriteTransform, Sample.Key);
+			LastTransform = Sample.Value;
+		}
+		return Result;
+	}
+
+	/** BakeAnimPoseBoneToCurve with the keys placed by SampleAdaptive, fewer poses are evaluated where the bone moves straight. */
+	static FTransformCurve BakeAnimPoseBoneToCurveAdaptive(UAnimSequence* AnimSequence, FName CustomExtractBone, const FRMEAdaptiveSampling& Settings, int32 ExtractChannel = 0, bool bIsAdditiveCurve = false,
+		const FAnimPoseEvaluationOptions& EvaluationOptions = FAnimPoseEvaluationOptions(), EAnimPoseSpaces Space = EAnimPoseSpaces::World)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RootMotionEditorStatics::BakeAnimPoseBoneToCurveAdaptive);
+		SCOPE_CYCLE_COUNTER(STAT_RME_BakeAnimPoseBoneToCurve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
+		if (!AnimSequence)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("Invalid AnimSequence"));
+			return FTransformCurve();
+		}
+
+		if (CustomExtractBone == NAME_None)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("Invalid Bone name (%s)."), *CustomExtractBone.ToString());
+			return FTransformCurve();
+		}
+
+		TArray<TPair<float, FTransform>> Samples;
+		int32 NumEvaluations = 0;
+		SampleAdaptive(AnimSequence->GetPlayLength(), Settings, ExtractChannel, [AnimSequence, CustomExtractBone, &EvaluationOptions, Space](float Time)
+		{
+			FAnimPose AnimPose;
+			UAnimPoseExtensions::GetAnimPoseAtTime(AnimSequence, Time, EvaluationOptions, AnimPose);
+			return UAnimPoseExtensions::GetBonePose(AnimPose, CustomExtractBone, Space);
+		}, Samples, NumEvaluations);
+		INC_DWORD_STAT_BY(STAT_RME_BakedSamples, NumEvaluations);
+
+		UE_LOG(LogRootMotionEditor, Verbose, TEXT("Adaptive bake of %s (%s): %d keys from %d pose evaluations."), *GetNameSafe(AnimSequence), *CustomExtractBone.ToString(), Samples.Num(), NumEvaluations);
+		return MakeCurveFromSamples(Samples, ExtractChannel, bIsAdditiveCurve);
+	}
+
+	/** BakeRootBoneToCurve with the keys placed by SampleAdaptive, a key at a time of the fixed rate bake is the same key. */
+	static FTransformCurve BakeRootBoneToCurveAdaptive(UAnimSequence* AnimSequence, const FRMEAdaptiveSampling& Settings, int32 ExtractChannel = 0, bool bIsAdditiveCurve = false)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RootMotionEditorStatics::BakeRootBoneToCurveAdaptive);
+		SCOPE_CYCLE_COUNTER(STAT_RME_BakeRootBoneToCurve);
+		LLM_SCOPE_BYTAG(RootMotionEditor);
+
+		if (!AnimSequence)
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("Invalid AnimSequence"));
+			return FTransformCurve();
+		}
+
+		if (!AnimSequence->HasRootMotion())
+		{
+			UE_LOG(LogAnimation, Warning, TEXT("AnimSequence haven't root motion."));
+			return FTransformCurve();
+		}
+
+		// Samples are taken out of order, so each one is the whole range from the start instead of an accumulated delta.
+		TArray<TPair<float, FTransform>> Samples;
+		int32 NumEvaluations = 0;
+		const FTransform FirstRootKey = GetFirstRootKey(AnimSequence);
+		SampleAdaptive(AnimSequence->GetPlayLength(), Settings, ExtractChannel, [AnimSequence, &FirstRootKey](float Time)
+		{
+#if ENGINE_MAJOR_VERSION >= 5 && ENGINE_MINOR_VERSION >= 6
+			FAnimExtractContext ExtractContext(Time, true, {}, false);
+			return AnimSequence->ExtractRootMotionFromRange(0, Time, ExtractContext) * FirstRootKey;
+#else
+			return AnimSequence->ExtractRootMotionFromRange(0, Time) * FirstRootKey;
+#endif
+		}, Samples, NumEvaluations);
+		INC_DWORD_STAT_BY(STAT_RME_BakedSamples, NumEvaluations);
+
+		UE_LOG(LogRootMotionEditor, Verbose, TEXT("Adaptive root motion bake of %s: %d keys from %d evaluations."), *GetNameSafe(AnimSequence), Samples.Num(), NumEvaluations);
+		return MakeCurveFromSamples(Samples, ExtractChannel, bIsAdditiveCurve);
+	}
+
+	/** Write the curve to the bone track on every raw key, a bake written back as it is leaves the track unchanged. */
+	static bool OverrideAnimBoneMotion(UAnimSequence* Animation, const FTransformCurve& NewRootMotion, FName BoneName = NAME_None)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(RootMotionEditorStatics::OverrideAnimBoneMotion);
+		SCOPE_CYCLE_COUNTER(STAT_RME_OverrideAnimBoneMotion);
+
 		if (!Animation)
 		{
 			UE_LOG(LogAnimation, Warning, TEXT("Invalid AnimSequence"));
-			return;
+			return false;
 		}
 		
 		const IAnimationDataModel* Model = Animation->GetDataModel();
 		if (Model == nullptr)
 		{
 			UE_LOG(LogAnimation, Error, TEXT("OverrideAnimRootMotion failed. Reason: Invalid Data Model. Animation: %s"), *GetNameSafe(Animation));
-			return;
+			return false;
 		}
 
 		const USkeleton* Skeleton = Animation->GetSkeleton();
 		if (Skeleton == nullptr)
 		{
 			UE_LOG(LogAnimation, Error, TEXT("OverrideAnimRootMotion failed. Reason: Invalid Skeleton. Animation: %s"), *GetNameSafe(Animation));
-			return;
+			return false;
 		}
 
 		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
 		if (RefSkeleton.GetNum() == 0)
 		{
 			UE_LOG(LogAnimation, Error, TEXT("OverrideAnimRootMotion failed. Reason: Ref Skeleton. Animation: %s"), *GetNameSafe(Animation));
-			return;
+			return false;
 		}
 		
 		const FName RootBoneName = BoneName.IsValid() && !BoneName.IsNone() ? BoneName : RefSkeleton.GetBoneName(0);
@@ -190,10 +505,10 @@ namespace RootMotionEditorStatics
 		if (NumKeys <= 1)
 		{
 			UE_LOG(LogAnimation, Error, TEXT("OverrideAnimRootMotion failed. Reason: key number is less 2. Animation: %s"), *GetNameSafe(Animation));
-			return;
+			return false;
 		}
 		
-		const float SampleInterval = Model->GetFrameRate().AsInterval();
+		const FRMEFrameSampler Sampler = FRMEFrameSampler::ForDataModel(Animation);
 		
 		IAnimationDataController& Controller = Animation->GetController();
 
@@ -208,7 +523,7 @@ namespace RootMotionEditorStatics
 		NewRootScales.Reserve(NumKeys);
 		for (int32 AnimKey = 0; AnimKey < NumKeys; AnimKey++)
 		{
-			const FTransform NewTransform = NewRootMotion.Evaluate(AnimKey * SampleInterval, 1.f);
+			const FTransform NewTransform = NewRootMotion.Evaluate(static_cast<float>(Sampler.GetTime(AnimKey)), 1.f);
 			NewRootTranslations.Add(NewTransform.GetTranslation());
 			NewRootQuats.Add(NewTransform.GetRotation());
 			NewRootScales.Add(NewTransform.GetScale3D());
@@ -216,8 +531,10 @@ namespace RootMotionEditorStatics
 
 		const FInt32Range KeyRangeToSet(0, NumKeys);
 		Controller.UpdateBoneTrackKeys(RootBoneName, KeyRangeToSet, NewRootTranslations, NewRootQuats, NewRootScales, bShouldTransact);
+		INC_DWORD_STAT_BY(STAT_RME_WrittenBoneKeys, NumKeys);
 		
 		Controller.CloseBracket(bShouldTransact);
+		return true;
 	}
 
 	
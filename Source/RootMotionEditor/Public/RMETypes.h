@@ -4,11 +4,32 @@
 
 #include "CoreMinimal.h"
 #include "AnimPose.h"
+#include "RMECurvePool.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
 #include "RMETypes.generated.h"
 
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRootMotionEditor, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("RootMotionEditor"), STATGROUP_RootMotionEditor, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bake Root Bone To Curve"), STAT_RME_BakeRootBoneToCurve, STATGROUP_RootMotionEditor, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bake Anim Pose Bone To Curve"), STAT_RME_BakeAnimPoseBoneToCurve, STATGROUP_RootMotionEditor, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Override Anim Bone Motion"), STAT_RME_OverrideAnimBoneMotion, STATGROUP_RootMotionEditor, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Root Motion Transform"), STAT_RME_GetRootMotionTransform, STATGROUP_RootMotionEditor, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Draw Root Motion Data"), STAT_RME_DrawRootMotionData, STATGROUP_RootMotionEditor, );
+
+/** Counters are reset every frame. */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Baked Samples"), STAT_RME_BakedSamples, STATGROUP_RootMotionEditor, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Written Bone Keys"), STAT_RME_WrittenBoneKeys, STATGROUP_RootMotionEditor, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Root Motion Evaluations"), STAT_RME_RootMotionEvaluations, STATGROUP_RootMotionEditor, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Drawn Trajectory Samples"), STAT_RME_DrawnTrajectorySamples, STATGROUP_RootMotionEditor, );
+
+/** Curves, undo history, derived caches and libraries of the plugin, -llm to track it. */
+LLM_DECLARE_TAG(RootMotionEditor);
+
 UENUM(BlueprintType)
 enum class ERMERootMotionViewMode :	uint8
 {
@@ -17,6 +38,14 @@ enum class ERMERootMotionViewMode :	uint8
 	Editor,
 };
 
+UENUM()
+enum class ERMETrajectoryColorMode : uint8
+{
+	None = 0,
+	Speed,
+	Acceleration,
+};
+
 UENUM(BlueprintType)
 enum class ERMEPreviewEditMode : uint8
 {
@@ -42,11 +71,114 @@ enum class ERMEBoneExtractMode : uint8
 {
 	RootMotion = 0,
 	AnimPose,
+	GroundProjectedPelvis,
+};
+
+UENUM()
+enum class ERMEBatchOperationType : uint8
+{
+	ScaleDistance = 0,
+	TimeStretch,
+	Offset,
+	Mirror,
+	RotateYaw,
+	RemoveDrift,
+	ZeroStartYaw,
+};
+
+UENUM()
+enum class ERMECurveFilterType : uint8
+{
+	/** Second order low pass run forward then backward, no lag. */
+	Butterworth = 0,
+	/** Local polynomial fit, keeps the peaks of plants and turns better than a low pass. */
+	SavitzkyGolay,
+	/** Adaptive low pass, smooths slow parts hard and follows fast ones, it lags a little. */
+	OneEuro,
 };
 
 ENUM_CLASS_FLAGS(ERMEBoneExtractChannelType);
 constexpr bool EnumHasAnyFlags(int32 Flags, ERMEBoneExtractChannelType Contains) { return (Flags & static_cast<int32>(Contains)) != 0; }
 
+/**
+ * Bakes keys on a coarse grid and only splits the intervals where the animation moves away from the straight line
+ * between their keys, so straight walks get few keys and plants and turns get many.
+ */
+USTRUCT(BlueprintType)
+struct FRMEAdaptiveSampling
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ToolTip = "If it is false, the animation is baked at the fixed sample rate."))
+	bool bEnabled = false;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ClampMin = "1", EditCondition = "bEnabled"))
+	int32 MinSampleRate = 10;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ClampMin = "1", EditCondition = "bEnabled"))
+	int32 MaxSampleRate = 120;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ClampMin = "0", Units = "cm", EditCondition = "bEnabled"))
+	float TranslationTolerance = 0.5f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ClampMin = "0", Units = "deg", EditCondition = "bEnabled"))
+	float RotationTolerance = 0.5f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Adaptive Sampling", meta = (ClampMin = "0", EditCondition = "bEnabled"))
+	float ScaleTolerance = 0.005f;
+};
+
+/** Smoothing of the edited keys, the filters assume the keys are evenly spaced like the fixed rate bakes make them. */
+USTRUCT(BlueprintType)
+struct FRMECurveFilterSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth")
+	ERMECurveFilterType Type = ERMECurveFilterType::Butterworth;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (Bitmask, BitmaskEnum = "/Script/RootMotionEditor.ERMEBoneExtractChannelType"))
+	int32 Channels = int32(ERMEBoneExtractChannelType::Translation);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "0.01", Units = "Hz", EditCondition = "Type == ERMECurveFilterType::Butterworth", EditConditionHides))
+	float CutoffFrequency = 6.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "3", ClampMax = "51", ToolTip = "Keys in the fitting window, rounded up to an odd number.", EditCondition = "Type == ERMECurveFilterType::SavitzkyGolay", EditConditionHides))
+	int32 WindowSize = 9;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "0", ClampMax = "5", EditCondition = "Type == ERMECurveFilterType::SavitzkyGolay", EditConditionHides))
+	int32 PolynomialOrder = 2;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "0.01", Units = "Hz", ToolTip = "Cutoff when the channel doesn't move, lower is smoother.", EditCondition = "Type == ERMECurveFilterType::OneEuro", EditConditionHides))
+	float MinCutoff = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "0", ToolTip = "Cutoff added per unit of speed, higher lags less on fast motion.", EditCondition = "Type == ERMECurveFilterType::OneEuro", EditConditionHides))
+	float Beta = 0.01f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smooth", meta = (ClampMin = "0.01", Units = "Hz", EditCondition = "Type == ERMECurveFilterType::OneEuro", EditConditionHides))
+	float DerivativeCutoff = 1.f;
+};
+
+/**
+ * Root motion derived from the pelvis, for clips that have none authored: the pelvis projected on the ground plane,
+ * turned to where the forward axis of the pelvis faces, then filtered. The keys are on the raw frames of the animation.
+ */
+USTRUCT(BlueprintType)
+struct FRMEGroundProjectionSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Projection")
+	FName PelvisBoneName = TEXT("pelvis");
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Projection", meta = (ToolTip = "Axis of the pelvis bone pointing where the character faces, in the space of the bone. It depends on the skeleton."))
+	FVector ForwardAxis = FVector::YAxisVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Projection")
+	bool bSmooth = true;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ground Projection", meta = (EditCondition = "bSmooth"))
+	FRMECurveFilterSettings Smoothing = MakeDefaultSmoothing();
+
+private:
+	/** The hips sway with every step, a low cutoff keeps the travel and the turns but not the sway. */
+	static FRMECurveFilterSettings MakeDefaultSmoothing()
+	{
+		FRMECurveFilterSettings Settings;
+		Settings.Channels = int32(ERMEBoneExtractChannelType::Translation) | int32(ERMEBoneExtractChannelType::Rotation);
+		Settings.CutoffFrequency = 2.f;
+		return Settings;
+	}
+};
 
 UCLASS()
 class URMECurveContainer : public UObject
@@ -61,30 +193,31 @@ public:
 public:
 	URMECurveContainer(){};
 
-	URMECurveContainer(FTransformCurve& InCurveData)
-		:CurveData(&InCurveData), bIsNew(true)
-	{}
-
 	virtual void BeginDestroy() override;
+	virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
 
-	static URMECurveContainer* Create(FTransformCurve* SourceData = nullptr, bool bAddToRoot = false);
+	/** The keys of SourceData are copied, the container always owns its curve. */
+	static URMECurveContainer* Create(const FTransformCurve* SourceData = nullptr, bool bAddToRoot = false);
 	void ClearAllKeys();
-	void DeleteCurveData();
 	void MakeDestroy();
 
+	/** The curve owned by the container, null once it has been released. Don't keep the pointer past the container. */
+	FTransformCurve* GetCurveData() const { return FRMECurvePool::Get().Resolve(CurveHandle); }
 	FTransformCurve* GetOrCreateCurveData();
 
 	void PushCurveData(class UCurveVector* Motion, class UCurveVector* Rotation, class UCurveVector* Scale);
-	void OverrideCurveData(FTransformCurve& NewCurveData);
 	void CopyCurveData(const FTransformCurve& NewCurveData);
 
-	bool IsNew() const { return bIsNew; }
+	/** Bumped every time the key data changes, derived data (pose caches, trajectories) is keyed on it. */
+	uint32 GetRevision() const { return Revision; }
+	void MarkCurveModified() { ++Revision; }
 
-	
-	FTransformCurve* CurveData = nullptr;
+private:
+	void ReleaseCurveData();
 
 private:
-	bool bIsNew = false;
+	FRMECurveHandle CurveHandle;
+	uint32 Revision = 0;
 	bool bIsAddToRoot = false;
 };
 
@@ -102,11 +235,15 @@ public:
 	FAnimPoseEvaluationOptions EvaluationOptions = FAnimPoseEvaluationOptions();
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load", meta = (EditCondition = "ExtractMode == ERMEBoneExtractMode::AnimPose", EditConditionHides))
 	EAnimPoseSpaces Space = EAnimPoseSpaces::World;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load", meta = (ToolTip = "The sample rate and the adaptive sampling are ignored, the pelvis is read on every frame.", EditCondition = "ExtractMode == ERMEBoneExtractMode::GroundProjectedPelvis", EditConditionHides))
+	FRMEGroundProjectionSettings GroundProjection;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load", meta = (Bitmask, BitmaskEnum = "/Script/RootMotionEditor.ERMEBoneExtractChannelType"))
 	int32 ExtractChannels = int32(ERMEBoneExtractChannelType::Translation);
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load", meta = (ToolTip = "Ignored when the adaptive sampling is enabled."))
 	int32 SampleRate = 30;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load")
+	FRMEAdaptiveSampling AdaptiveSampling;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Load", meta = (ToolTip = "If it is true, it will make every frame of the curve is motion delta."))
 	bool bIsAdditiveCurve = false;
 	
@@ -114,6 +251,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Save")
 	FName CustomSaveBoneName = NAME_None;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations", meta = (ClampMin = "0.01"))
+	float DistanceScale = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations", meta = (ClampMin = "0.01"))
+	float TimeScale = 1.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations")
+	FVector TranslationOffset = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations")
+	TEnumAsByte<EAxis::Type> MirrorAxis = EAxis::Y;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations", meta = (UIMin = "-180", UIMax = "180"))
+	float RotationYaw = 0.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations", meta = (ToolTip = "If it is true, the keys after the selected keys follow the reshaped range instead of staying in place."))
+	bool bCarryFollowingKeys = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operations")
+	FRMECurveFilterSettings Smoothing;
+
 
 #if WITH_EDITOR
 	virtual bool CanEditChange(const FEditPropertyChain& PropertyChain) const override;
@@ -133,8 +286,59 @@ public:
 	TObjectPtr<class UCurveVector> RotationCurve = nullptr;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Curve", meta = (AllowedClasses = "/Script/Engine.CurveBase", DisallowedClasses = "/Script/Engine.CurveLinearColor, /Script/Engine.CurveFloat"))
 	TObjectPtr<class UCurveVector> ScaleCurve = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Library")
+	TObjectPtr<class URMERootMotionLibrary> Library = nullptr;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Library", meta = (ToolTip = "Entry of the library to load from or save to, the name of the animation if none."))
+	FName LibraryEntryName = NAME_None;
 	
 	bool HasAnyCurveAsset() const;
 
+	/** The library entry the curve editor loads from and saves to, none if there is no library or no name for the entry. */
+	FName GetLibraryEntryName() const;
+
 	bool HasRepeatedCurve() const;
 };
+
+/** One step of the operation list a batch applies to every animation, in order. */
+USTRUCT()
+struct FRMEBatchOperation
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Operation")
+	ERMEBatchOperationType Type = ERMEBatchOperationType::ScaleDistance;
+
+	UPROPERTY(EditAnywhere, Category = "Operation", meta = (ClampMin = "0.01", EditCondition = "Type == ERMEBatchOperationType::ScaleDistance || Type == ERMEBatchOperationType::TimeStretch", EditConditionHides))
+	float Scale = 1.f;
+	UPROPERTY(EditAnywhere, Category = "Operation", meta = (EditCondition = "Type == ERMEBatchOperationType::Offset", EditConditionHides))
+	FVector Offset = FVector::ZeroVector;
+	UPROPERTY(EditAnywhere, Category = "Operation", meta = (EditCondition = "Type == ERMEBatchOperationType::Mirror || Type == ERMEBatchOperationType::RemoveDrift", EditConditionHides))
+	TEnumAsByte<EAxis::Type> Axis = EAxis::Z;
+	UPROPERTY(EditAnywhere, Category = "Operation", meta = (UIMin = "-180", UIMax = "180", EditCondition = "Type == ERMEBatchOperationType::RotateYaw", EditConditionHides))
+	float Yaw = 0.f;
+};
+
+UCLASS()
+class URMEBatchSettings : public UObject
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditAnywhere, Category = "Assets")
+	TArray<TObjectPtr<class UAnimSequence>> Animations;
+
+	UPROPERTY(EditAnywhere, Category = "Bake", meta = (Bitmask, BitmaskEnum = "/Script/RootMotionEditor.ERMEBoneExtractChannelType", ToolTip = "The channels that aren't baked are written back as identity."))
+	int32 ExtractChannels = int32(ERMEBoneExtractChannelType::All);
+	UPROPERTY(EditAnywhere, Category = "Bake", meta = (ClampMin = "1", ToolTip = "Ignored when the adaptive sampling is enabled."))
+	int32 SampleRate = 30;
+	UPROPERTY(EditAnywhere, Category = "Bake")
+	FRMEAdaptiveSampling AdaptiveSampling;
+
+	UPROPERTY(EditAnywhere, Category = "Operations")
+	TArray<FRMEBatchOperation> Operations;
+
+	UPROPERTY(EditAnywhere, Category = "Save", meta = (ToolTip = "Bone the result is written to, the root bone if none."))
+	FName CustomSaveBoneName = NAME_None;
+	UPROPERTY(EditAnywhere, Category = "Save", meta = (ToolTip = "If it is false, the animations are only baked and reshaped, and the report shows what would be written."))
+	bool bWriteBack = true;
+};
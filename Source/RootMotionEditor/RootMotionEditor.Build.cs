@@ -49,6 +49,8 @@ public class RootMotionEditor : ModuleRules
 				"CurveEditor",
 				"PropertyEditor", 
 				"WorkspaceMenuStructure",
+				"ContentBrowser",
+				"DesktopPlatform",
 			}
 			);
 		